@@ -50,8 +50,6 @@ const int DEVICE_COUNT = sizeof(DEVICES) / sizeof(Device);
 // SYSTEM CONFIGURATION
 // =============================================================================
 
-bool DEBUG = false;
-
 // MQTT
 const char* MQTT_SERVER = "192.168.0.127";
 int MQTT_PORT = 1883;
@@ -74,8 +72,22 @@ int MQTT_KEEP_ALIVE = 5;
 // Inactivity timeout
 unsigned long NO_COMMAND_TIMEOUT = 180000;
 
+// Loop stage (devices/<id>/metrics) and effect lateness (devices/<id>/timing) histograms, 0 = off
+unsigned long METRICS_INTERVAL = 60000;
+// Effect / auto-off lateness above this counts as a deadline miss (devices/<id>/timing), us
+unsigned long TIMING_MISS_US = 5000;
+
+// Task / heap diagnostics on devices/<id>/diag, limits for devices/<id>/diag/warn (0 = no check)
+unsigned long DIAG_CHECK_INTERVAL = 10000;
+unsigned long DIAG_REPORT_INTERVAL = 300000;  // 0 = on request only (diag/get)
+uint32_t DIAG_MIN_FREE_HEAP = 20000;          // bytes
+uint8_t DIAG_MAX_FRAGMENTATION = 70;          // %
+uint32_t DIAG_MIN_STACK_FREE = 512;           // bytes per task
+uint8_t DIAG_MAX_TASK_CPU = 80;               // % of a core, IDLE excluded
+
 // Watchdog Timer
 unsigned long WDT_TIMEOUT = 30;
+unsigned long STAGE_WDT_CHECK_MS = 100;       // Kontrola rozpoctov faz loop() (rozpocty v .ino)
 
 // OTA Configuration
 const char* OTA_HOSTNAME = "ESP32-RelayModule-Room1-LAN";
@@ -44,8 +44,17 @@ extern const int DEVICE_COUNT;
 // SYSTEM CONFIGURATION
 // =============================================================================
 
-// Debug
-extern bool DEBUG;
+// Logging (museum_log.h) - compile-time: vypnuta uroven sa neskompiluje, ani jej argumenty
+#define LOG_LEVEL LOG_LEVEL_WARN       // Ladenie: LOG_LEVEL_DEBUG
+#define LOG_MODULE_MAIN    LOG_LEVEL
+#define LOG_MODULE_HW      LOG_LEVEL
+#define LOG_MODULE_MQTT    LOG_LEVEL
+#define LOG_MODULE_WIFI    LOG_LEVEL
+#define LOG_MODULE_OTA     LOG_LEVEL
+#define LOG_MODULE_WDT     LOG_LEVEL
+#define LOG_MODULE_CONN    LOG_LEVEL
+#define LOG_MODULE_LED     LOG_LEVEL
+#define LOG_MODULE_EFFECTS LOG_LEVEL
 
 // MQTT
 extern const char* MQTT_SERVER;
@@ -69,8 +78,19 @@ extern int MQTT_KEEP_ALIVE;
 // Timeout
 extern unsigned long NO_COMMAND_TIMEOUT;
 
+// Metrics
+extern unsigned long METRICS_INTERVAL;
+extern unsigned long TIMING_MISS_US;
+extern unsigned long DIAG_CHECK_INTERVAL;
+extern unsigned long DIAG_REPORT_INTERVAL;
+extern uint32_t DIAG_MIN_FREE_HEAP;
+extern uint8_t DIAG_MAX_FRAGMENTATION;
+extern uint32_t DIAG_MIN_STACK_FREE;
+extern uint8_t DIAG_MAX_TASK_CPU;
+
 // Watchdog
 extern unsigned long WDT_TIMEOUT;
+extern unsigned long STAGE_WDT_CHECK_MS;
 
 // OTA
 extern const char* OTA_HOSTNAME;
@@ -16,7 +16,7 @@ void monitorConnections() {
     String networkStatus = isWiFiConnected() ? getActiveNetworkName() : "FAIL";
     String mqttStatus = client.connected() ? "OK" : "FAIL";
 
-    debugPrint("Status - Network: " + networkStatus + ", MQTT: " + mqttStatus);
+    LOG_DEBUG(CONN, "Status - Network: " + networkStatus + ", MQTT: " + mqttStatus);
 
     if (!isWiFiConnected() && mqttConnected) {
       mqttConnected = false;
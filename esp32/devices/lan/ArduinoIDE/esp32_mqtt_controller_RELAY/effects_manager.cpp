@@ -3,6 +3,7 @@
 #include "config.h"
 #include "hardware.h"
 #include "debug.h"
+#include <museum_metrics.h>
 
 // Active state per group
 bool groupActive[EFFECT_GROUP_COUNT];
@@ -16,6 +17,9 @@ struct DeviceRuntimeState {
 
 DeviceRuntimeState deviceRuntimes[20];
 
+// Zaznamy meskania pre devices/<id>/timing: auto-off + skupiny efektov
+static const char* timingNames[EFFECT_GROUP_COUNT + 1];
+
 // ---------------------------------------------------------------------------
 // initializeEffects
 // ---------------------------------------------------------------------------
@@ -28,19 +32,26 @@ void initializeEffects() {
     deviceRuntimes[i].isEffectOn       = false;
     deviceRuntimes[i].nextSwitchTime   = 0;
   }
-  debugPrint("Effects: Manager Ready");
+
+  timingNames[TIMING_AUTO_OFF] = "auto_off";
+  for (int i = 0; i < EFFECT_GROUP_COUNT; i++) {
+    timingNames[TIMING_AUTO_OFF + 1 + i] = EFFECT_GROUPS[i].name;
+  }
+  latenessBegin(timingNames, EFFECT_GROUP_COUNT + 1, TIMING_MISS_US);
+
+  LOG_INFO(EFFECTS, "Manager Ready");
 }
 
 // ---------------------------------------------------------------------------
 // startEffect
 // ---------------------------------------------------------------------------
-void startEffect(String groupName) {
+void startEffect(const char* groupName) {
   for (int i = 0; i < EFFECT_GROUP_COUNT; i++) {
-    if (String(EFFECT_GROUPS[i].name) != groupName) continue;
+    if (strcmp(EFFECT_GROUPS[i].name, groupName) != 0) continue;
 
     if (!groupActive[i]) {
       groupActive[i] = true;
-      debugPrint("Efekt START: " + groupName);
+      LOGR_INFO(EFFECTS, "Efekt START: %s", EFFECT_GROUPS[i].name);
 
       for (int j = 0; j < MAX_DEVICES_PER_GROUP; j++) {
         int devIdx = EFFECT_GROUPS[i].deviceIndices[j];
@@ -57,18 +68,18 @@ void startEffect(String groupName) {
     }
     return;
   }
-  debugPrint("Neznámy efekt: " + groupName);
+  LOGF_WARN(EFFECTS, "Neznámy efekt: %s", groupName);
 }
 
 // ---------------------------------------------------------------------------
 // stopEffect
 // ---------------------------------------------------------------------------
-void stopEffect(String groupName) {
+void stopEffect(const char* groupName) {
   for (int i = 0; i < EFFECT_GROUP_COUNT; i++) {
-    if (String(EFFECT_GROUPS[i].name) != groupName) continue;
+    if (strcmp(EFFECT_GROUPS[i].name, groupName) != 0) continue;
 
     groupActive[i] = false;
-    debugPrint("Efekt STOP: " + groupName);
+    LOGR_INFO(EFFECTS, "Efekt STOP: %s", EFFECT_GROUPS[i].name);
 
     for (int j = 0; j < MAX_DEVICES_PER_GROUP; j++) {
       int devIdx = EFFECT_GROUPS[i].deviceIndices[j];
@@ -115,6 +126,7 @@ void handleEffects() {
       // Toggle state
       deviceRuntimes[i].isEffectOn = !deviceRuntimes[i].isEffectOn;
       setDevice(i, deviceRuntimes[i].isEffectOn);
+      latenessRecordMs(TIMING_AUTO_OFF + 1 + groupIdx, deviceRuntimes[i].nextSwitchTime);
 
       // Schedule next toggle using group timing config
       long nextInterval = deviceRuntimes[i].isEffectOn
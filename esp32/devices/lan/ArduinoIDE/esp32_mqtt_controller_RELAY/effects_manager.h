@@ -5,8 +5,8 @@
 
 void initializeEffects();
 void handleEffects();
-void startEffect(String groupName);
-void stopEffect(String groupName);
+void startEffect(const char* groupName);
+void stopEffect(const char* groupName);
 void stopAllEffects();
 
 #endif
\ No newline at end of file
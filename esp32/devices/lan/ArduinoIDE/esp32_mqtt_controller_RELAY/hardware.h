@@ -9,9 +9,13 @@ extern bool allDevicesOff;
 
 extern bool effectControlled[];
 
+// Zaznam meskania auto-off v devices/<id>/timing, skupiny efektov su 1..N
+#define TIMING_AUTO_OFF 0
+
 void initializeHardware();
 void setDevice(int deviceIndex, bool state);
 void turnOffAllDevices();
+void forceOutputsOff();   // Iba fyzicke vypnutie, volatelne z ineho tasku (softverovy watchdog)
 void handleAutoOff();
 String getDeviceStatus();
 
@@ -4,6 +4,10 @@
 #include "hardware.h"
 #include "wifi_manager.h"
 #include "effects_manager.h"
+#include <museum_command.h>
+#include <museum_metrics.h>
+#include <museum_log_crash.h>
+#include <museum_log_flight.h>
 
 // Global MQTT objects and state
 NetworkClient networkClient;
@@ -12,6 +16,18 @@ bool mqttConnected    = false;
 unsigned long lastMqttAttempt   = 0;
 unsigned long lastStatusPublish = 0;
 String STATUS_TOPIC = String("devices/") + CLIENT_ID + "/status";
+String LOG_TOPIC     = String("devices/") + CLIENT_ID + "/log";
+String LOG_SET_TOPIC = LOG_TOPIC + "/set";
+String METRICS_TOPIC = String("devices/") + CLIENT_ID + "/metrics";
+String TIMING_TOPIC  = String("devices/") + CLIENT_ID + "/timing";
+String DIAG_TOPIC      = String("devices/") + CLIENT_ID + "/diag";
+String DIAG_GET_TOPIC  = DIAG_TOPIC + "/get";
+String DIAG_WARN_TOPIC = DIAG_TOPIC + "/warn";
+String CRASH_TOPIC     = String("devices/") + CLIENT_ID + "/crash";
+String FLIGHT_TOPIC     = String("devices/") + CLIENT_ID + "/flight";
+String FLIGHT_GET_TOPIC = FLIGHT_TOPIC + "/get";
+String BENCH_TOPIC     = String("devices/") + CLIENT_ID + "/bench";
+String BENCH_SET_TOPIC = BENCH_TOPIC + "/set";
 NetworkTransport mqttTransport = NETWORK_NONE;
 
 unsigned long lastCommandTime = 0;
@@ -31,7 +47,7 @@ static void handleNetworkTransportChange() {
   NetworkTransport activeTransport = getActiveNetworkTransport();
   if (activeTransport == mqttTransport) return;
 
-  debugPrint(
+  LOG_INFO(MQTT, 
     "MQTT transport switch: " +
     String(mqttTransportName(mqttTransport)) +
     " -> " +
@@ -47,23 +63,186 @@ static void handleNetworkTransportChange() {
   lastMqttAttempt = 0;
 }
 
+// Vzdialeny log: davky z MuseumLog streamu, publikuje ich len mqttLoop()
+static bool publishLogBatch(const char* payload, size_t length) {
+  return client.publish(LOG_TOPIC.c_str(), (const uint8_t*)payload, length, false);
+}
+
+// devices/<id>/log/set = OFF | ON[:<ERROR|WARN|INFO|DEBUG>]
+static void handleLogCommand(const char* topic, const char* message, unsigned int length) {
+  char feedbackTopic[96];
+  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+
+  uint8_t level;
+  CmdError parseError = parseLogCommand(message, length, &level);
+  if (parseError != CMD_OK) {
+    char feedback[24];
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+    client.publish(feedbackTopic, feedback, false);
+    return;
+  }
+
+  logStreamSetLevel(level);
+  client.publish(feedbackTopic, "OK", false);
+  LOGF_INFO(MQTT, "Vzdialeny log: %s", level == LOG_LEVEL_NONE ? "OFF" : logLevelName(level));
+}
+
+// Diagnostika taskov a heapu - publikuje ich len systemDiagLoop() z mqttLoop()
+static bool publishDiag(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_TOPIC.c_str(), payload, false);
+}
+
+static bool publishDiagWarning(const char* payload) {
+  LOGF_WARN(MQTT, "Diagnostika: %s", payload);
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_WARN_TOPIC.c_str(), payload, false);
+}
+
+// Crash zaznam predosleho bootu (panic / WDT / brownout) - raz, retained
+static void publishCrashRecord() {
+  static char payload[CRASH_PAYLOAD_MAX];
+  if (crashFormat(payload, sizeof(payload)) == 0) {
+    crashAcknowledge();
+    return;
+  }
+  if (client.publish(CRASH_TOPIC.c_str(), payload, true)) {
+    LOGF_WARN(MQTT, "Crash zaznam odoslany: %s", payload);
+    crashAcknowledge();
+  }
+}
+
+// Indexy topicov flight recordera: zariadenia podla DEVICES[], potom efekty a STOP
+static uint8_t flightTopicIndex(const char* deviceName) {
+  if (strncmp(deviceName, "effects/", 8) == 0) return DEVICE_COUNT;
+  if (strcmp(deviceName, "STOP") == 0) return DEVICE_COUNT + 1;
+  for (int i = 0; i < DEVICE_COUNT; i++) {
+    if (strcmp(DEVICES[i].name, deviceName) == 0) return i;
+  }
+  return FLIGHT_TOPIC_NONE;
+}
+
+static const char* flightTopicName(uint8_t topic) {
+  if (topic < DEVICE_COUNT) return DEVICES[topic].name;
+  if (topic == DEVICE_COUNT) return "effects";
+  if (topic == DEVICE_COUNT + 1) return "STOP";
+  return nullptr;
+}
+
+// Vypis flight recordera na poziadanie (devices/<id>/flight/get) - posiela ho mqttLoop()
+static bool flightDumpRequested = false;
+
+static void publishFlightDump() {
+  static char payload[FLIGHT_PAYLOAD_MAX];
+  flightDumpRequested = false;
+  if (flightFormat(payload, sizeof(payload)) == 0) {
+    LOG_WARN(MQTT, "Flight recorder: vypis sa nezmestil");
+    return;
+  }
+  client.publish(FLIGHT_TOPIC.c_str(), payload, false);
+}
+
+// Benchmark iba nad vypnutymi vystupmi - synteticke OFF potom nic nezmeni
+static bool outputsIdle() {
+  if (!allDevicesOff) return false;
+  for (int i = 0; i < DEVICE_COUNT; i++) {
+    if (effectControlled[i]) return false;
+  }
+  return true;
+}
+
+// devices/<id>/bench/set (alebo "bench ..." zo Serialu) = START[:<prikazov/s>[:<ms na krok>]] | STOP
+static const char* handleBenchCommand(const char* message, unsigned int length) {
+  static char feedback[24];
+  BenchCommand command;
+  CmdError parseError = parseBenchCommand(message, length, &command);
+  if (parseError != CMD_OK) {
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+    return feedback;
+  }
+
+  if (!command.start) {
+    benchStop("stop");
+    return "OK";
+  }
+  if (benchRunning() || !outputsIdle()) {
+    LOG_WARN(MQTT, "Benchmark odmietnuty: uz bezi alebo su zapnute vystupy / efekty");
+    return "ERROR";
+  }
+  benchStart(command.maxRate, command.stepMs);
+  LOGF_INFO(MQTT, "Benchmark: do %u prikazov/s, krok %u ms", command.maxRate, command.stepMs);
+  return "OK";
+}
+
+// Report benchmarku na devices/<id>/bench a na Serial
+static void publishBenchReport() {
+  static char payload[BENCH_PAYLOAD_MAX];
+  if (benchFormat(payload, sizeof(payload)) == 0) {
+    LOG_WARN(MQTT, "Benchmark: report sa nezmestil");
+    return;
+  }
+  Serial.println(payload);
+  if (isMqttConnected()) client.publish(BENCH_TOPIC.c_str(), payload, false);
+}
+
+// Prikazy zo Serialu bez blokovania loop(): "bench START[:<prikazov/s>[:<ms>]]" | "bench STOP"
+static void pollSerialCommand() {
+  static char line[48];
+  static uint8_t used = 0;
+  static bool overflow = false;
+
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (used < sizeof(line) - 1) line[used++] = c;
+      else overflow = true;
+      continue;
+    }
+
+    line[used] = '\0';
+    if (!overflow && strncmp(line, "bench ", 6) == 0) {
+      Serial.printf("bench: %s\n", handleBenchCommand(line + 6, used - 6));
+    } else if (used > 0) {
+      Serial.println("Neznamy prikaz. Pouzitie: bench START[:<prikazov/s>[:<ms>]] | bench STOP");
+    }
+    used = 0;
+    overflow = false;
+  }
+}
+
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
 
-  // --- Guard: payload size limit ---
-  if (length >= 32) {
-    debugPrint("MQTT: Payload too long, ignoring");
+  // The payload is parsed in place as a (pointer, length) view – no copy, no NUL terminator
+  const char* message = (const char*)payload;
+
+  // LOGF – bez String, payload nie je ukonceny nulou
+  LOGF_DEBUG(MQTT, "topic: %s, sprava: %.*s", topic, (int)length, (const char*)payload);
+
+  // --- Vzdialeny log (devices/<id>/log/set) ---
+  if (LOG_SET_TOPIC == topic) {
+    handleLogCommand(topic, message, length);
+    return;
+  }
+
+  // --- Diagnostika na poziadanie (devices/<id>/diag/get) ---
+  if (DIAG_GET_TOPIC == topic) {
+    systemDiagRequest();
     return;
   }
 
-  // Stack-allocated buffers – no heap involvement
-  char message[32];
-  memcpy(message, payload, length);
-  message[length] = '\0';
+  // --- Flight recorder na poziadanie (devices/<id>/flight/get) ---
+  if (FLIGHT_GET_TOPIC == topic) {
+    flightDumpRequested = true;
+    return;
+  }
 
-  // Use Serial directly here – topic and message are already char*, no String needed
-  if (DEBUG) {
-    Serial.print("[DEBUG] "); Serial.print(millis()); Serial.print("ms - MQTT topic: ");  Serial.println(topic);
-    Serial.print("[DEBUG] "); Serial.print(millis()); Serial.print("ms - MQTT sprava: "); Serial.println(message);
+  // --- Synteticka zataz (devices/<id>/bench/set) ---
+  if (BENCH_SET_TOPIC == topic) {
+    char feedbackTopic[96];
+    snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+    client.publish(feedbackTopic, handleBenchCommand(message, length), false);
+    return;
   }
 
   // --- Ignore feedback / status topics ---
@@ -77,14 +256,28 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
     return;
   }
 
+  // Skutocny prikaz pocas benchmarku ho ukonci - meranie by uz neplatilo
+  bool synthetic = benchInjecting();
+  if (!synthetic && benchRunning()) benchStop("command");
+
   // Reset inactivity timer on every valid command
-  lastCommandTime = millis();
+  if (!synthetic) lastCommandTime = millis();
+
+  // Posledne prikazy v RTC pamati - po resete idu do crash zaznamu. Flight recorder: prijatie tu,
+  // vysledok a cas aplikovania po vykonani (flightComplete). Synteticke prikazy benchmarku by
+  // historiu skutocnych prikazov prepisali - bez flightReceive() je aj flightComplete() naprazdno.
+  if (!synthetic) {
+    crashNoteCommand(topic + prefixLen, message, length);
+    flightReceive(flightTopicIndex(topic + prefixLen), message, length);
+  }
 
-  // feedbackTopic built on stack
+  // feedbackTopic built on stack; synteticke prikazy mimo feedbacku backendu
   char feedbackTopic[128];
-  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", synthetic ? BENCH_TOPIC.c_str() : topic);
 
   bool commandSuccessful = false;
+  CmdError parseError = CMD_OK;
+  SwitchAction action;
 
   // deviceName = everything after the prefix  e.g. "light/4", "effects/group1", "STOP"
   const char* deviceName = topic + prefixLen;
@@ -95,22 +288,21 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
   if (strncmp(deviceName, "effects/", 8) == 0) {
     const char* effectName = deviceName + 8;   // pointer into original topic
 
-    // Uppercase the command in-place on our stack copy
-    char cmd[32];
-    strncpy(cmd, message, sizeof(cmd) - 1);
-    cmd[sizeof(cmd) - 1] = '\0';
-    for (int i = 0; cmd[i]; i++) cmd[i] = toupper(cmd[i]);
-
-    debugPrint("EFEKT Prikaz: " + String(effectName) + " -> " + String(cmd));
-
-    if (strcmp(cmd, "ON") == 0 || strcmp(cmd, "1") == 0 || strcmp(cmd, "START") == 0) {
-      startEffect(String(effectName));
+    parseError = parseSwitchCommand(message, length, true, &action);
+    if (parseError == CMD_OK && action == SWITCH_ON) {
+      startEffect(effectName);
+      flightComplete(FLIGHT_OK);
       client.publish(feedbackTopic, "ACTIVE", false);
-    } else if (strcmp(cmd, "OFF") == 0 || strcmp(cmd, "0") == 0 || strcmp(cmd, "STOP") == 0) {
-      stopEffect(String(effectName));
+    } else if (parseError == CMD_OK) {
+      stopEffect(effectName);
+      flightComplete(FLIGHT_OK);
       client.publish(feedbackTopic, "INACTIVE", false);
     } else {
-      debugPrint("Neznamy prikaz pre efekt");
+      flightComplete(parseError);
+      char feedback[24];
+      snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+      client.publish(feedbackTopic, feedback, false);
+      LOGF_WARN(MQTT, "Neplatny prikaz pre efekt %s: %s", effectName, feedback);
     }
     return;
   }
@@ -122,7 +314,7 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
     turnOffAllDevices();
     stopAllEffects();
     commandSuccessful = true;
-    debugPrint("STOP prikaz vykonany (vratane efektov)");
+    LOG_INFO(MQTT, "STOP prikaz vykonany (vratane efektov)");
   }
 
   // -------------------------------------------------------------------------
@@ -139,38 +331,54 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
     }
 
     if (deviceIndex >= 0) {
-      // Uppercase command on stack copy
-      char cmd[32];
-      strncpy(cmd, message, sizeof(cmd) - 1);
-      cmd[sizeof(cmd) - 1] = '\0';
-      for (int i = 0; cmd[i]; i++) cmd[i] = toupper(cmd[i]);
-
-      if (strcmp(cmd, "ON") == 0 || strcmp(cmd, "1") == 0) {
-        setDevice(deviceIndex, true);
-        commandSuccessful = true;
-      } else if (strcmp(cmd, "OFF") == 0 || strcmp(cmd, "0") == 0) {
-        setDevice(deviceIndex, false);
+      parseError = parseSwitchCommand(message, length, false, &action);
+      if (parseError == CMD_OK) {
+        setDevice(deviceIndex, action == SWITCH_ON);
         commandSuccessful = true;
       } else {
-        debugPrint("Neznamy prikaz: " + String(cmd));
+        LOGF_WARN(MQTT, "Neplatny prikaz: %s", cmdErrorName(parseError));
       }
     } else {
-      debugPrint("Nezname zariadenie: " + String(deviceName));
+      LOGF_WARN(MQTT, "Nezname zariadenie: %s", deviceName);
     }
   }
 
-  // --- Publish feedback ---
-  const char* feedback = commandSuccessful ? "OK" : "ERROR";
+  // --- Publish feedback: OK, ERROR:<code> for a rejected payload, ERROR for an unknown device ---
+  char feedback[24] = "OK";
+  uint8_t flightResult = FLIGHT_OK;
+  if (!commandSuccessful) {
+    if (parseError != CMD_OK) {
+      snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+      flightResult = parseError;
+    } else {
+      strcpy(feedback, "ERROR");
+      flightResult = FLIGHT_REFUSED;
+    }
+  }
+  flightComplete(flightResult);
   if (client.publish(feedbackTopic, feedback, false)) {
-    debugPrint("Feedback: " + String(feedback) + " -> " + String(feedbackTopic));
+    LOGF_DEBUG(MQTT, "Feedback: %s -> %s", feedback, feedbackTopic);
   }
 }
 
+// Synteticky prikaz benchmarku: OFF na zariadenia po rade, normalnou cestou cez mqttCallback()
+static void benchInject(uint32_t sequence) {
+  char topic[64];
+  snprintf(topic, sizeof(topic), "%s%s", BASE_TOPIC_PREFIX, DEVICES[sequence % DEVICE_COUNT].name);
+  char payload[] = "OFF";
+  mqttCallback(topic, (byte*)payload, 3);
+}
+
 void initializeMqtt() {
   client.setServer(MQTT_SERVER, MQTT_PORT);
   client.setKeepAlive(MQTT_KEEP_ALIVE);
   client.setCallback(mqttCallback);
-  debugPrint("MQTT nakonfigurovane: " + String(MQTT_SERVER) + ":" + String(MQTT_PORT));
+  client.setBufferSize(LOG_STREAM_BATCH_MAX + 128);   // Davky vzdialeneho logu (default 256 B)
+
+  SystemThresholds limits = {DIAG_MIN_FREE_HEAP, DIAG_MAX_FRAGMENTATION, DIAG_MIN_STACK_FREE, DIAG_MAX_TASK_CPU};
+  systemDiagBegin(limits, DIAG_CHECK_INTERVAL, DIAG_REPORT_INTERVAL);
+  flightBegin(flightTopicName, DEVICE_COUNT + 2);
+  LOG_INFO(MQTT, "MQTT nakonfigurovane: " + String(MQTT_SERVER) + ":" + String(MQTT_PORT));
 }
 
 void connectToMqtt() {
@@ -186,12 +394,12 @@ void connectToMqtt() {
   static unsigned long mqttRetryInterval = MQTT_RETRY_INTERVAL;
 
   if (!client.connected() && (currentTime - lastMqttAttempt >= mqttRetryInterval)) {
-    debugPrint("Pripajam sa na MQTT broker...");
+    LOG_INFO(MQTT, "Pripajam sa na MQTT broker...");
     String willTopic = "devices/" + String(CLIENT_ID) + "/status";
 
     if (client.connect(CLIENT_ID, willTopic.c_str(), 0, true, "offline")) {
       Serial.println("MQTT pripojene");
-      debugPrint("MQTT uspesne pripojene");
+      LOG_INFO(MQTT, "MQTT uspesne pripojene");
       mqttConnected = true;
       mqttAttempts  = 0;
       mqttRetryInterval = MQTT_RETRY_INTERVAL;
@@ -202,24 +410,35 @@ void connectToMqtt() {
         char topicBuf[64];
         snprintf(topicBuf, sizeof(topicBuf), "%s%s", BASE_TOPIC_PREFIX, DEVICES[i].name);
         client.subscribe(topicBuf, 0);
-        debugPrint("Subscribed: " + String(topicBuf));
+        LOG_INFO(MQTT, "Subscribed: " + String(topicBuf));
       }
 
       // Wildcard for all effect groups
       char effectsTopic[64];
       snprintf(effectsTopic, sizeof(effectsTopic), "%seffects/#", BASE_TOPIC_PREFIX);
       client.subscribe(effectsTopic, 0);
-      debugPrint("Subscribed: " + String(effectsTopic));
+      LOG_INFO(MQTT, "Subscribed: " + String(effectsTopic));
 
       // STOP command
       char stopTopic[64];
       snprintf(stopTopic, sizeof(stopTopic), "%sSTOP", BASE_TOPIC_PREFIX);
       client.subscribe(stopTopic, 0);
-      debugPrint("Subscribed: " + String(stopTopic));
+      LOG_INFO(MQTT, "Subscribed: " + String(stopTopic));
+
+      // Zapnutie / vypnutie vzdialeneho logu
+      client.subscribe(LOG_SET_TOPIC.c_str(), 0);
+
+      // Diagnostika a flight recorder na poziadanie
+      client.subscribe(DIAG_GET_TOPIC.c_str(), 0);
+      client.subscribe(FLIGHT_GET_TOPIC.c_str(), 0);
+      client.subscribe(BENCH_SET_TOPIC.c_str(), 0);
+
+      // Benchmark preruseny vypadkom spojenia by meral hlavne reconnect
+      benchStop("mqtt");
 
       // Publish online status
       if (client.publish(STATUS_TOPIC.c_str(), "online", true)) {
-        debugPrint("Status: online");
+        LOG_INFO(MQTT, "Status: online");
       }
 
       // Reset lastStatusPublish to 0 so heartbeat publishes immediately in next mqttLoop()
@@ -229,10 +448,10 @@ void connectToMqtt() {
     } else {
       mqttAttempts++;
       Serial.println("MQTT zlyhalo. Pokus: " + String(mqttAttempts));
-      debugPrint("MQTT zlyhalo. RC=" + String(client.state()));
+      LOG_WARN(MQTT, "MQTT zlyhalo. RC=" + String(client.state()));
 
       if (mqttAttempts >= MAX_MQTT_ATTEMPTS) {
-        debugPrint("Max MQTT pokusov – restartujem");
+        LOGR_ERROR(MQTT, "Max MQTT pokusov - restartujem");
         delay(1000);
         ESP.restart();
       } else {
@@ -258,6 +477,12 @@ void mqttLoop() {
 
   client.loop();
 
+  // Synteticka zataz: najviac jeden prikaz za priechod, ako jeden paket za client.loop()
+  pollSerialCommand();
+  if (!client.connected()) benchStop("mqtt");
+  benchLoop(benchInject);
+  if (benchReportReady()) publishBenchReport();
+
   static unsigned long lastStatusTime = 0;
   unsigned long currentTime = millis();
 
@@ -265,6 +490,15 @@ void mqttLoop() {
     publishStatus();
     lastStatusTime = currentTime;
   }
+
+  // Najviac jedna davka vzdialeneho logu za LOG_STREAM_INTERVAL
+  if (isMqttConnected()) logStreamLoop(publishLogBatch);
+
+  // Kontrola limitov kazdych DIAG_CHECK_INTERVAL, report kazdych DIAG_REPORT_INTERVAL / na poziadanie
+  systemDiagLoop(publishDiag, publishDiagWarning);
+
+  if (crashPending() && isMqttConnected()) publishCrashRecord();
+  if (flightDumpRequested && isMqttConnected()) publishFlightDump();
 }
 
 void publishStatus() {
@@ -274,11 +508,29 @@ void publishStatus() {
   if (currentTime - lastStatusPublish < STATUS_PUBLISH_INTERVAL) return;
 
   if (client.publish(STATUS_TOPIC.c_str(), "online", true)) {
-    debugPrint("Status publikovany: online");
+    LOG_DEBUG(MQTT, "Status publikovany: online");
     lastStatusPublish = currentTime;
   }
 }
 
+// Okno profilera loop() - JSON z profilerFormat()
+bool publishMetrics(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(METRICS_TOPIC.c_str(), payload, false);
+}
+
+// Zasek fazy loop() zo softveroveho watchdogu - na diag/warn ako prekrocene limity
+void publishStageStall(const StageStall& stall) {
+  char payload[96];
+  if (formatStageStall(stall, payload, sizeof(payload)) > 0) publishDiagWarning(payload);
+}
+
+// Meskanie efektov a auto-off - JSON z latenessFormat()
+bool publishTiming(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(TIMING_TOPIC.c_str(), payload, false);
+}
+
 bool isMqttConnected() {
   NetworkTransport activeTransport = getActiveNetworkTransport();
   return (
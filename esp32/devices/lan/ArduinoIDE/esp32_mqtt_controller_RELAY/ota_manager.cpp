@@ -13,7 +13,7 @@ bool otaInitialized = false;
 
 void initializeOTA() {
   if (!wifiConnected || !isWiFiConnected()) {
-    debugPrint("OTA: network not connected, skipping setup");
+    LOG_WARN(OTA, "network not connected, skipping setup");
     return;
   }
 
@@ -86,7 +86,7 @@ void initializeOTA() {
   ArduinoOTA.begin();
   otaInitialized = true;
 
-  debugPrint("OTA: Initialized successfully via " + String(getActiveNetworkName()));
+  LOG_INFO(OTA, "Initialized successfully via " + String(getActiveNetworkName()));
   Serial.println("OTA READY: " + String(OTA_HOSTNAME) + " via " + String(getActiveNetworkName()));
 }
 
@@ -5,58 +5,119 @@
 // Natvrdo definovaný PIN pre Waveshare dosku
 #define LED_PIN 38
 
-// Maximálny jas (0-255). 
+// Maximálny jas (0-255).
 // 50 je dostatočné pre interiér, 255 je veľmi silné (môže oslepovať).
-#define MAX_BRIGHTNESS 50 
+#define MAX_BRIGHTNESS 50
 
-void initializeStatusLed() {
-  if (!USE_RELAY_MODULE) return;
+// WS2812 cez RMT: 10 MHz tick = 100 ns, bit 1.25 µs
+#define RMT_TICK_HZ 10000000
+#define WS_T0H 4   // 0: 400 ns HIGH, 850 ns LOW
+#define WS_T0L 8
+#define WS_T1H 8   // 1: 800 ns HIGH, 450 ns LOW
+#define WS_T1L 4
 
-  pinMode(LED_PIN, OUTPUT);
-  debugPrint("LED: Advanced Status Mode Init (Pin 38)");
-  
-  // Test pri štarte: Krátke bliknutie na modro (Signál, že CPU žije)
-  // GRB poradie: (0, 0, 50) -> Modrá
-  neopixelWrite(LED_PIN, 0, 0, 50); 
-  delay(200);
-  neopixelWrite(LED_PIN, 0, 0, 0);
+// Dýchanie: perióda 4 s, 128 krokov (~31 ms na krok)
+#define BREATHE_PERIOD_MS 4000
+#define BREATHE_STEPS 128
+
+static uint8_t breatheTable[BREATHE_STEPS];   // Predpočítané v initializeStatusLed()
+
+// 24 symbolov (GRB) musí ostať platných, kým RMT vysiela asynchrónne
+static rmt_data_t rmtFrame[24];
+static bool rmtReady = false;
+
+static uint32_t shownColor = 0xFFFFFFFF;      // Posledná odoslaná farba (0xRRGGBB), na začiatku žiadna
+static uint32_t wantedColor = 0;
+
+// Meranie: čas v handleStatusLed() a počet zápisov za okno logStatusLedStats()
+static uint32_t statCalls = 0;
+static uint32_t statWrites = 0;
+static uint64_t statTotalUs = 0;
+static uint32_t statMaxUs = 0;
+
+static uint32_t packColor(uint8_t r, uint8_t g, uint8_t b) {
+  return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
-// Pomocná funkcia na nastavenie farby s opravou GRB
+// Zápis iba pri zmene farby a iba ak predošlý rámec už odišiel (inak sa skúsi v ďalšom prechode)
+static void flushColor() {
+  if (!rmtReady || wantedColor == shownColor) return;
+  if (!rmtTransmitCompleted(LED_PIN)) return;
+
+  // Waveshare ESP32-S3 má poradie GRB (Green, Red, Blue)
+  uint8_t r = (wantedColor >> 16) & 0xFF;
+  uint8_t g = (wantedColor >> 8) & 0xFF;
+  uint8_t b = wantedColor & 0xFF;
+  uint32_t grb = ((uint32_t)g << 16) | ((uint32_t)r << 8) | b;
+  for (int i = 0; i < 24; i++) {
+    bool one = grb & (1UL << (23 - i));
+    rmtFrame[i].level0 = 1;
+    rmtFrame[i].duration0 = one ? WS_T1H : WS_T0H;
+    rmtFrame[i].level1 = 0;
+    rmtFrame[i].duration1 = one ? WS_T1L : WS_T0L;
+  }
+
+  if (rmtWriteAsync(LED_PIN, rmtFrame, 24)) {
+    shownColor = wantedColor;
+    statWrites++;
+  }
+}
+
+// Pomocná funkcia na nastavenie farby
 // Vstup: Červená, Zelená, Modrá (0-255)
 void setRawColor(uint8_t r, uint8_t g, uint8_t b) {
-  // Waveshare ESP32-S3 má poradie GRB (Green, Red, Blue)
-  // Prvý argument je fyzicky Zelená, druhý Červená, tretí Modrá
-  neopixelWrite(LED_PIN, g, r, b);
+  wantedColor = packColor(r, g, b);
+  flushColor();
 }
 
-void handleStatusLed(bool wifiOk, bool mqttOk) {
+// Mimo loop() (štart, OTA) sa ďalší prechod nemusí konať – počkať na dokončenie predošlého rámca (~30 µs)
+static void setColorNow(uint8_t r, uint8_t g, uint8_t b) {
+  while (rmtReady && !rmtTransmitCompleted(LED_PIN)) {
+  }
+  setRawColor(r, g, b);
+}
+
+void initializeStatusLed() {
   if (!USE_RELAY_MODULE) return;
 
-  unsigned long currentMillis = millis();
+  // Rovnaký priebeh ako pôvodné exp(sin()) dýchanie, mapovaný na 5..MAX_BRIGHTNESS – raz pri štarte
+  for (int i = 0; i < BREATHE_STEPS; i++) {
+    float val = (exp(sin(2.0 * PI * i / BREATHE_STEPS)) - 0.36787944) * 108.0;
+    breatheTable[i] = (uint8_t)map((int)val, 0, 255, 5, MAX_BRIGHTNESS);
+  }
+
+  rmtReady = rmtInit(LED_PIN, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, RMT_TICK_HZ);
+  if (!rmtReady) {
+    LOG_ERROR(LED, "RMT init failed (Pin 38)");
+    return;
+  }
+  LOG_INFO(LED, "Advanced Status Mode Init (Pin 38, RMT)");
+
+  // Test pri štarte: Krátke bliknutie na modro (Signál, že CPU žije)
+  setColorNow(0, 0, 50);
+  delay(200);
+  setColorNow(0, 0, 0);
+}
 
+static void updateStatusColor(bool wifiOk, bool mqttOk, unsigned long currentMillis) {
   // ---------------------------------------------------------
   // STAV 1: CRITICAL ERROR - Žiadna WiFi
-  // Efekt: Rýchly agresívny stroboskop (Červená)
+  // Efekt: Rýchly agresívny stroboskop (Červená), 100ms interval
   // ---------------------------------------------------------
   if (!wifiOk) {
-    static boolean ledState = false;
-    // Veľmi rýchle blikanie (100ms interval)
     if (currentMillis % 200 < 100) {
        setRawColor(MAX_BRIGHTNESS, 0, 0); // Červená
     } else {
        setRawColor(0, 0, 0); // Tma
     }
     return;
-  } 
+  }
 
   // ---------------------------------------------------------
   // STAV 2: SERVER ERROR - WiFi OK, ale žiadne MQTT
-  // Efekt: Pravidelné blikanie (Oranžová/Žltá)
+  // Efekt: Pravidelné blikanie (Oranžová/Žltá), 500ms zapnuté, 500ms vypnuté
   // ---------------------------------------------------------
   if (!mqttOk) {
-    // Oranžová sa mieša ako Veľa Červenej + Trochu Zelenej
-    // Interval 500ms zapnuté, 500ms vypnuté
     if (currentMillis % 1000 < 500) {
        setRawColor(MAX_BRIGHTNESS, 15, 0); // Oranžová (R=Max, G=slabšia)
     } else {
@@ -67,18 +128,33 @@ void handleStatusLed(bool wifiOk, bool mqttOk) {
 
   // ---------------------------------------------------------
   // STAV 3: ALL SYSTEMS GO - Všetko funguje
-  // Efekt: "Dýchanie" (Breathing) - Plynulá Zelená
+  // Efekt: "Dýchanie" (Breathing) - Plynulá Zelená z tabuľky
   // ---------------------------------------------------------
-  
-  // Matematika pre dýchanie: Použijeme funkciu sínus
-  // Perióda dýchania cca 3 sekundy
-  float val = (exp(sin(currentMillis / 2000.0 * PI)) - 0.36787944) * 108.0;
-  
-  // Mapovanie na náš maximálny jas
-  int brightness = map((int)val, 0, 255, 5, MAX_BRIGHTNESS);
-  
-  // Nastavenie Zelenej farby s vypočítaným jasom
-  setRawColor(0, brightness, 0); 
+  int step = (currentMillis % BREATHE_PERIOD_MS) * BREATHE_STEPS / BREATHE_PERIOD_MS;
+  setRawColor(0, breatheTable[step], 0);
+}
+
+void handleStatusLed(bool wifiOk, bool mqttOk) {
+  if (!USE_RELAY_MODULE) return;
+
+  uint32_t startUs = micros();
+  updateStatusColor(wifiOk, mqttOk, millis());
+
+  uint32_t elapsedUs = micros() - startUs;
+  statCalls++;
+  statTotalUs += elapsedUs;
+  if (elapsedUs > statMaxUs) statMaxUs = elapsedUs;
+}
+
+void logStatusLedStats() {
+  if (!USE_RELAY_MODULE || statCalls == 0) return;
+
+  LOGF_DEBUG(LED, "%lu calls, avg %lu us, max %lu us, %lu writes", (unsigned long)statCalls,
+             (unsigned long)(statTotalUs / statCalls), (unsigned long)statMaxUs, (unsigned long)statWrites);
+  statCalls = 0;
+  statWrites = 0;
+  statTotalUs = 0;
+  statMaxUs = 0;
 }
 
 void setOtaLedState(bool active) {
@@ -86,8 +162,8 @@ void setOtaLedState(bool active) {
 
   if (active) {
     // Počas update svieti tyrkysová/modrá
-    setRawColor(0, 20, 50); 
+    setColorNow(0, 20, 50);
   } else {
-    setRawColor(0, 0, 0);
+    setColorNow(0, 0, 0);
   }
-}
\ No newline at end of file
+}
@@ -44,7 +44,7 @@ static void updateActiveTransport() {
     Serial.print(transportName(activeTransport));
     Serial.print(" -> ");
     Serial.println(transportName(nextTransport));
-    debugPrint(
+    LOG_INFO(WIFI, 
       "Network transport: " +
       String(transportName(activeTransport)) +
       " -> " +
@@ -63,7 +63,7 @@ static void stopFallbackWiFi() {
   }
 
   Serial.println("Stopping WiFi fallback because LAN is active");
-  debugPrint("Stopping WiFi fallback because LAN is active");
+  LOG_INFO(WIFI, "Stopping WiFi fallback because LAN is active");
   WiFi.disconnect(true);
   fallbackWifiStarted = false;
   fallbackWifiConnected = false;
@@ -76,7 +76,7 @@ static void startFallbackWiFi() {
 
   Serial.print("Starting WiFi fallback: ");
   Serial.println(WIFI_SSID);
-  debugPrint("Starting WiFi fallback: " + String(WIFI_SSID));
+  LOG_INFO(WIFI, "Starting WiFi fallback: " + String(WIFI_SSID));
 
   WiFi.mode(WIFI_STA);
   WiFi.setHostname(OTA_HOSTNAME);
@@ -102,7 +102,7 @@ static void onNetworkEvent(arduino_event_id_t event, arduino_event_info_t info)
       lastWifiAttempt = 0;
       Serial.print("LAN connected - IP: ");
       Serial.println(ETH.localIP());
-      debugPrint("LAN connected: " + ETH.localIP().toString());
+      LOG_INFO(WIFI, "LAN connected: " + ETH.localIP().toString());
       updateActiveTransport();
       fallbackStopRequested = true;
       break;
@@ -138,7 +138,7 @@ static void onNetworkEvent(arduino_event_id_t event, arduino_event_info_t info)
       lastWifiAttempt = 0;
       Serial.print("WiFi fallback connected - IP: ");
       Serial.println(WiFi.localIP());
-      debugPrint("WiFi fallback connected: " + WiFi.localIP().toString());
+      LOG_INFO(WIFI, "WiFi fallback connected: " + WiFi.localIP().toString());
       updateActiveTransport();
       break;
 
@@ -171,7 +171,7 @@ static void startEthernet() {
   if (ethernetStarted) return;
 
   registerNetworkEvents();
-  debugPrint("Starting LAN Ethernet (W5500)");
+  LOG_INFO(WIFI, "Starting LAN Ethernet (W5500)");
   SPI.begin(ETH_SPI_SCK_PIN, ETH_SPI_MISO_PIN, ETH_SPI_MOSI_PIN);
   ETH.begin(
     ETH_PHY_W5500,
@@ -209,7 +209,7 @@ bool initializeWiFi() {
   }
 
   Serial.println("No LAN/WiFi network connected yet");
-  debugPrint("No LAN/WiFi network connected yet");
+  LOG_INFO(WIFI, "No LAN/WiFi network connected yet");
   return false;
 }
 
@@ -245,7 +245,7 @@ void reconnectWiFi() {
 
   lastWifiAttempt = currentTime;
   networkAttempts++;
-  debugPrint(
+  LOG_INFO(WIFI, 
     "Network reconnect check " +
     String(networkAttempts) +
     "/" +
@@ -256,7 +256,7 @@ void reconnectWiFi() {
   networkRetryInterval = min(networkRetryInterval * 2, MAX_RETRY_INTERVAL);
 
   if (networkAttempts >= MAX_NETWORK_ATTEMPTS) {
-    debugPrint("Max network reconnect checks reached - restarting ESP32");
+    LOG_ERROR(WIFI, "Max network reconnect checks reached - restarting ESP32");
     Serial.println("Restarting ESP32...");
     delay(1000);
     ESP.restart();
@@ -1,8 +1,5 @@
 #include "config.h"
 
-// Debug Mode
-const bool DEBUG = true;
-
 // WiFi Configuration
 const char* WIFI_SSID = "Museum-Room1"; // Upravte podľa potreby
 const char* WIFI_PASSWORD = "88888888"; // Upravte podľa potreby
@@ -13,20 +10,52 @@ const int MQTT_PORT = 1883;
 const char* BASE_TOPIC_PREFIX = "room1/";
 const char* CLIENT_ID = "Room1_ESP_Trigger";
 
-// Scene Configuration
-const char* SCENE_TOPIC_SUFFIX = "scene";
-const char* SCENE_PAYLOAD = "START";
+// SNTP – trigger nesie čas stlačenia <payload>@<unixMs> ("" = bez času)
+const char* NTP_SERVER = "pool.ntp.org";
+
+// Hardware - Button Inputs
+// Každý vstup: pin, cooldown a akcia pre krátke / dlhé / dvojité stlačenie (topic za BASE_TOPIC_PREFIX).
+// Vstup bez long aj double odošle short hneď pri stlačení; s long čaká na uvoľnenie,
+// s double ešte DOUBLE_PRESS_GAP_MS po uvoľnení.
+const ButtonInput BUTTON_INPUTS[] = {
+  // pin, cooldown, short,              long,                  double
+  { 32, 4000, {{"scene", "START"}, {nullptr, nullptr}, {nullptr, nullptr}} },
+  // Príklad stanice: { 33, 1000, {{"station1", "NEXT"}, {"station1", "STOP"}, {"station1", "LANG"}} },
+};
+const int BUTTON_INPUT_COUNT = sizeof(BUTTON_INPUTS) / sizeof(BUTTON_INPUTS[0]);
+
+const unsigned long DEBOUNCE_DELAY = 60;
+const unsigned long BUTTON_MIN_PRESS_MS = 20;
+const unsigned long LONG_PRESS_MS = 1500;
+const unsigned long DOUBLE_PRESS_GAP_MS = 350;
+const int BUTTON_EVENT_QUEUE_LEN = 8;
 
-// Hardware - Button Input
-const int BUTTON_PIN = 32;
-const unsigned long DEBOUNCE_DELAY = 60;    
-const unsigned long BUTTON_COOLDOWN = 4000; // 4 sekundy pauza medzi odoslaním
+// Outbox – trigger čaká na ack z backendu (<topic>/ack, napr. room1/scene/ack), prežije WDT reset
+const unsigned long OUTBOX_MAX_AGE_MS = 30000;      // Po 30 s už návštevník pri tlačidle nestojí
+const unsigned long OUTBOX_RETRY_INTERVAL = 1500;
+const unsigned long OUTBOX_STATS_INTERVAL = 60000;
+
+// Battery mode – vypnuté pre napájané tlačidlá, zapnúť pre vzdialené stanice na batériách
+const bool BATTERY_MODE = false;
+const unsigned long BATTERY_AWAKE_WINDOW_MS = 0;
+const unsigned long BATTERY_BOOT_AWAKE_MS = 60000;
+const unsigned long BATTERY_MAX_AWAKE_MS = 8000;
+const unsigned long BATTERY_JOIN_TIMEOUT = 4000;
+const unsigned long BATTERY_HEARTBEAT_INTERVAL = 150000; // Pod 180 s timeoutom device registry
+const unsigned long BATTERY_RETRY_WAKE_MS = 5000;
+const unsigned long POWER_STATS_INTERVAL = 600000;
+const unsigned long BATTERY_SLEEP_CURRENT_UA = 800;      // ESP32 light sleep, modul bez USB prevodníka
+const unsigned long BATTERY_ACTIVE_CURRENT_MA = 110;     // CPU + WiFi TX/RX priemer
 
 // Hardware - LED Feedback PWM
 const int LED_PIN = 25;                 // GPIO25 PWM output
 const int PWM_CHANNEL = 0;              // LEDC channel 0
 const int PWM_FREQUENCY = 5000;         // 5 kHz
 const int PWM_RESOLUTION = 8;           // 8-bit (0-255)
+const unsigned long LED_PULSE_INTERVAL = 1000;   // ~1 s cyklus
+const unsigned long LED_PENDING_INTERVAL = 400;
+const unsigned long LED_BLINK_FAST = 100;
+const int LED_BLINK_COUNT = 2;
 
 // Connection Management Settings
 const unsigned long WIFI_RETRY_INTERVAL = 3000;
@@ -38,6 +67,14 @@ const int MAX_WIFI_ATTEMPTS = 5;
 const int MAX_MQTT_ATTEMPTS = 5;
 const int MQTT_KEEP_ALIVE = 5;
 
+// Diagnostika taskov a heapu
+const unsigned long DIAG_CHECK_INTERVAL = 10000;
+const unsigned long DIAG_REPORT_INTERVAL = 300000;
+const uint32_t DIAG_MIN_FREE_HEAP = 20000;     // B
+const uint8_t DIAG_MAX_FRAGMENTATION = 70;     // %
+const uint32_t DIAG_MIN_STACK_FREE = 512;      // B na task
+const uint8_t DIAG_MAX_TASK_CPU = 80;          // %
+
 // Watchdog & OTA
 const unsigned long WDT_TIMEOUT = 30; // 30s reset ak kód úplne zamrzne
 const char* OTA_HOSTNAME = "ESP32-Room1-Trigger";
@@ -3,8 +3,18 @@
 
 #include <Arduino.h>
 
-// Debug
-extern const bool DEBUG;
+// Logging (museum_log.h) – compile-time: vypnutá úroveň sa neskompiluje, ani jej argumenty
+#define LOG_LEVEL LOG_LEVEL_DEBUG      // Release: LOG_LEVEL_WARN
+#define LOG_MODULE_MAIN   LOG_LEVEL
+#define LOG_MODULE_HW     LOG_LEVEL
+#define LOG_MODULE_MQTT   LOG_LEVEL
+#define LOG_MODULE_WIFI   LOG_LEVEL
+#define LOG_MODULE_OTA    LOG_LEVEL
+#define LOG_MODULE_WDT    LOG_LEVEL
+#define LOG_MODULE_CONN   LOG_LEVEL
+#define LOG_MODULE_LED    LOG_LEVEL
+#define LOG_MODULE_OUTBOX LOG_LEVEL
+#define LOG_MODULE_POWER  LOG_LEVEL
 
 // WiFi
 extern const char* WIFI_SSID;
@@ -15,19 +25,63 @@ extern const char* MQTT_SERVER;
 extern const int MQTT_PORT;
 extern const char* BASE_TOPIC_PREFIX;
 extern const char* CLIENT_ID;
-extern const char* SCENE_TOPIC_SUFFIX;
-extern const char* SCENE_PAYLOAD;
+extern const char* NTP_SERVER;          // Čas stlačenia v triggeri ("" = bez času)
 
-// Hardware - Button
-extern const int BUTTON_PIN;           
+// Hardware - Buttons (tabuľka vstupov)
+enum ButtonGesture : uint8_t {
+  GESTURE_SHORT,
+  GESTURE_LONG,     // Držanie aspoň LONG_PRESS_MS, odošle sa ešte počas držania
+  GESTURE_DOUBLE,   // Druhé stlačenie do DOUBLE_PRESS_GAP_MS po uvoľnení
+  GESTURE_COUNT
+};
+
+struct ButtonAction {
+  const char* topic;     // Za BASE_TOPIC_PREFIX ("scene" -> room1/scene), nullptr = gesto vypnuté
+  const char* payload;
+};
+
+struct ButtonInput {
+  int pin;                              // LOW = stlačené (externý pull-up)
+  unsigned long cooldownMs;             // Medzi odoslaniami tohto vstupu
+  ButtonAction actions[GESTURE_COUNT];  // short, long, double
+};
+
+#define MAX_BUTTON_INPUTS 8
+
+extern const ButtonInput BUTTON_INPUTS[];
+extern const int BUTTON_INPUT_COUNT;
 extern const unsigned long DEBOUNCE_DELAY;
-extern const unsigned long BUTTON_COOLDOWN; // NOVÉ: Čas medzi stlačeniami
+extern const unsigned long BUTTON_MIN_PRESS_MS;  // Kratšie LOW počas debounce = rušenie
+extern const unsigned long LONG_PRESS_MS;
+extern const unsigned long DOUBLE_PRESS_GAP_MS;
+extern const int BUTTON_EVENT_QUEUE_LEN;         // Stlačenia čakajúce na odoslanie
+
+// Outbox triggerov (RTC pamäť, doručenie s ack)
+extern const unsigned long OUTBOX_MAX_AGE_MS;     // Staršie nedoručené stlačenie sa zahodí
+extern const unsigned long OUTBOX_RETRY_INTERVAL; // Opakovanie triggeru bez ack
+extern const unsigned long OUTBOX_STATS_INTERVAL; // Publish štatistík doručenia
+
+// Battery mode (light sleep s prebudením tlačidlom)
+extern const bool BATTERY_MODE;
+extern const unsigned long BATTERY_AWAKE_WINDOW_MS;    // Spojenie drží po poslednej aktivite (0 = hneď po ack)
+extern const unsigned long BATTERY_BOOT_AWAKE_MS;      // Po zapnutí hore (OTA okno)
+extern const unsigned long BATTERY_MAX_AWAKE_MS;       // Bez siete to po tomto čase vzdá
+extern const unsigned long BATTERY_JOIN_TIMEOUT;
+extern const unsigned long BATTERY_HEARTBEAT_INTERVAL; // Prebudenie časovačom kvôli statusu (0 = vypnuté)
+extern const unsigned long BATTERY_RETRY_WAKE_MS;      // Prebudenie, kým čaká nedoručený trigger
+extern const unsigned long POWER_STATS_INTERVAL;
+extern const unsigned long BATTERY_SLEEP_CURRENT_UA;   // Model spotreby (odhad, nie meranie)
+extern const unsigned long BATTERY_ACTIVE_CURRENT_MA;
 
 // Hardware - LED Feedback
 extern const int LED_PIN;               // PWM LED pin
 extern const int PWM_CHANNEL;
 extern const int PWM_FREQUENCY;
 extern const int PWM_RESOLUTION;
+extern const unsigned long LED_PULSE_INTERVAL;    // Dýchanie pri výpadku WiFi / MQTT
+extern const unsigned long LED_PENDING_INTERVAL;  // Dýchanie, kým trigger čaká na ack
+extern const unsigned long LED_BLINK_FAST;        // Polfáza potvrdzovacieho bliknutia
+extern const int LED_BLINK_COUNT;
 
 // Connection Management
 extern const unsigned long WIFI_RETRY_INTERVAL;
@@ -39,6 +93,14 @@ extern const int MAX_WIFI_ATTEMPTS;
 extern const int MAX_MQTT_ATTEMPTS;
 extern const int MQTT_KEEP_ALIVE;
 
+// Diagnostika taskov a heapu (devices/<id>/diag), limity pre diag/warn (0 = bez kontroly)
+extern const unsigned long DIAG_CHECK_INTERVAL;
+extern const unsigned long DIAG_REPORT_INTERVAL;  // 0 = len na požiadanie (diag/get)
+extern const uint32_t DIAG_MIN_FREE_HEAP;
+extern const uint8_t DIAG_MAX_FRAGMENTATION;
+extern const uint32_t DIAG_MIN_STACK_FREE;
+extern const uint8_t DIAG_MAX_TASK_CPU;           // % jadra, IDLE sa nekontroluje
+
 // Watchdog & OTA
 extern const unsigned long WDT_TIMEOUT;
 extern const char* OTA_HOSTNAME;
@@ -13,16 +13,16 @@ void monitorConnections() {
 
   if (currentTime - lastConnectionCheck >= CONNECTION_CHECK_INTERVAL) {
     lastConnectionCheck = currentTime;
-    debugPrint("Status - WiFi: " + String(WiFi.status() == WL_CONNECTED ? "OK" : "FAIL") +
+    LOG_DEBUG(CONN, "Status - WiFi: " + String(WiFi.status() == WL_CONNECTED ? "OK" : "FAIL") +
                ", MQTT: " + String(client.connected() ? "OK" : "FAIL"));
 
     if (WiFi.status() != WL_CONNECTED && wifiConnected) {
       wifiConnected = false;
       mqttConnected = false;
-      debugPrint("WiFi connection lost");
+      LOG_WARN(CONN, "WiFi connection lost");
     } else if (WiFi.status() == WL_CONNECTED && !wifiConnected) {
       wifiConnected = true;
-      debugPrint("WiFi restored");
+      LOG_INFO(CONN, "WiFi restored");
     }
   }
 }
\ No newline at end of file
@@ -2,8 +2,7 @@
 #define DEBUG_H
 
 #include <Arduino.h>
-
-// Debug utility function
-void debugPrint(const String& message);
+#include <museum_log.h>
+#include "config.h"  // LOG_LEVEL, LOG_MODULE_*
 
 #endif
\ No newline at end of file
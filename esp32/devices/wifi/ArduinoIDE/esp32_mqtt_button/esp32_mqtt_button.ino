@@ -7,20 +7,24 @@
 #include "ota_manager.h"
 #include "wdt_manager.h"
 #include "led_manager.h"
+#include "outbox.h"
+#include "power_manager.h"
 
 void setup() {
   Serial.begin(115200);
   delay(100);
+  logRingBegin();       // Binárny log (LOGR_*) – záznamy spred WDT resetu sa vypíšu v loop()
 
   Serial.println("\n=== ESP32 Scene Trigger Starting ===");
-  debugPrint("=== Startup ===");
+  LOG_INFO(MAIN, "=== Startup ===");
 
   initializeWatchdog(); // Spustí WDT
+  initializeOutbox();   // Triggery nedoručené pred WDT resetom (RTC pamäť)
   initializeHardware(); // Inicializuje pin 32 s externým rezistorom
   initializeLED();      // Inicializuje PWM LED na GPIO25
 
   if (!initializeWiFi()) {
-    debugPrint("Initial WiFi failed");
+    LOG_WARN(MAIN, "Initial WiFi failed");
   }
 
   if (wifiConnected) {
@@ -28,7 +32,12 @@ void setup() {
   }
 
   initializeMqtt(); // Nastaví MQTT
-  Serial.println("Ready - Waiting for button press on PIN " + String(BUTTON_PIN));
+  initializePowerManager(); // Battery mode: cache spojenia, prvý spánok po BATTERY_BOOT_AWAKE_MS
+  String pins;
+  for (int i = 0; i < BUTTON_INPUT_COUNT; i++) {
+    pins += (i > 0 ? ", " : "") + String(BUTTON_INPUTS[i].pin);
+  }
+  Serial.println("Ready - Waiting for button press on PIN " + pins);
 }
 
 void loop() {
@@ -43,20 +52,23 @@ void loop() {
     mqttLoop();
   }
 
-  // 3. LOGIKA TLAČIDLA (Tu sa uplatňuje cooldown z hardware.cpp)
-  if (wasButtonPressed()) {
-    ledButtonConfirm(); // LED feedback: 4x rapid blink
-    publishSceneTrigger(); // Odoslanie MQTT správy
+  // 3. LOGIKA TLAČIDLA (hrany zachytáva ISR, debounce, gestá a cooldown vstupov beží v tasku v hardware.cpp)
+  ButtonEvent press;
+  while (wasButtonPressed(&press)) {
+    ledButtonConfirm(); // LED feedback: LED_BLINK_COUNT rýchlych bliknutí
+    outboxPush(press);  // Trigger čaká v outboxe na ack, aj cez výpadok spojenia
+    notePowerActivity();
   }
+  outboxLoop(); // Odoslanie / opakovanie / expirácia triggerov
 
   // 4. Watchdog reset - kŕmenie "psa" pre stabilitu
   resetWatchdog();
 
-  // 5. Connection Management (Automatický reconnect)
+  // 5. Connection Management (Automatický reconnect; v battery mode pripája power manager po prebudení)
   static unsigned long lastCheck = 0;
   unsigned long currentTime = millis();
 
-  if (currentTime - lastCheck >= 100) {
+  if (!BATTERY_MODE && currentTime - lastCheck >= 100) {
     lastCheck = currentTime;
     if (!isWiFiConnected()) {
       reconnectWiFi();
@@ -67,11 +79,17 @@ void loop() {
     }
   }
 
-  // 6. LED Status Update (každých 10ms)
-  updateLED(isWiFiConnected(), isMqttConnected(), (millis() - cooldown_start_time) < 4000);
+  // 6. LED Status Update (každých 10ms, iba porovnanie času – fade beží v LEDC)
+  updateLED(isWiFiConnected(), isMqttConnected(), outboxPending() > 0);
 
   // 7. Monitoring (Status logy do konzoly)
   monitorConnections();
 
+  // 8. Battery mode: po doručení light sleep až do stlačenia / časovača
+  powerManagerLoop();
+
+  // 9. Výpis binárneho logu (iba ak má UART voľné miesto)
+  logRingDrain(Serial);
+
   delay(10); 
 }
\ No newline at end of file
@@ -2,62 +2,371 @@
 #include "config.h"
 #include "debug.h"
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <soc/gpio_reg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
 
-// Stavové premenné pre debouncing
-int lastButtonState = HIGH;  
-int currentButtonState = HIGH;
-unsigned long lastDebounceTime = 0;
+// Debounce task: nad Arduino loop (1), aby blokujúci WiFi reconnect nezdržal vyhodnotenie
+static const UBaseType_t BUTTON_TASK_PRIORITY = 5;
+static const BaseType_t BUTTON_TASK_CORE = 1;
+static const uint32_t BUTTON_TASK_STACK = 3072;
 
-// Ochrana pred spamovaním (Cooldown)
-unsigned long lastValidPressTime = 0; 
+// Hrany z ISR – chránené edgeMux (64-bit zápis nie je atomický)
+struct EdgeCapture {
+  bool pending;          // Prebieha dávka hrán (zákmity)
+  int64_t firstEdgeUs;   // Prvá hrana dávky (čas uvoľnenia)
+  int64_t firstFallUs;   // Prvá hrana do LOW v tejto dávke, 0 = žiadna
+  int64_t lastEdgeUs;    // Posledná hrana, od nej sa meria DEBOUNCE_DELAY
+};
 
-void initializeHardware() {
-  debugPrint("Initializing Hardware (External Pull-up)...");
-  
-  // DÔLEŽITÉ: Používame INPUT, pretože máte externý rezistor na 3.3V
-  pinMode(BUTTON_PIN, INPUT);
-  
-  debugPrint("Button initialized on PIN " + String(BUTTON_PIN));
-}
-
-bool wasButtonPressed() {
-  int reading = digitalRead(BUTTON_PIN);
-  unsigned long currentTime = millis();
-
-  // Detekcia fyzickej zmeny stavu
-  if (reading != lastButtonState) {
-    lastDebounceTime = currentTime;
-  }
-
-  bool verifiedPress = false;
-
-  // 1. Debounce filter (50ms) - odstránenie mechanického šumu
-  if ((currentTime - lastDebounceTime) > DEBOUNCE_DELAY) {
-    
-    // Ak je stav stabilný a zmenil sa oproti predchádzajúcemu
-    if (reading != currentButtonState) {
-      currentButtonState = reading;
-
-      // Logika: LOW znamená stlačené (spojené s GND)
-      if (currentButtonState == LOW) {
-        
-        // 2. Cooldown filter (ochrana pred "pinzetou" a rýchlym spamom)
-        if (currentTime - lastValidPressTime >= BUTTON_COOLDOWN) {
-          debugPrint("Button logic: PRESSED (Valid)");
-          lastValidPressTime = currentTime; 
-          verifiedPress = true;
-        } else {
-          // Len pre debug, aby ste videli, že kód žije, ale blokuje spam
-          debugPrint("Button: Blocked by cooldown");
+enum GestureState : uint8_t {
+  GESTURE_IDLE,
+  GESTURE_DOWN,          // Prvé stlačenie drží
+  GESTURE_WAIT_SECOND,   // Uvoľnené, čaká sa na druhé stlačenie (double)
+  GESTURE_HOLD           // Gesto už odoslané, čaká sa iba na uvoľnenie
+};
+
+// Stav gesta – zapisuje iba task
+struct InputState {
+  GestureState state;
+  int64_t firstPressUs;  // Začiatok gesta (čas udalosti)
+  int64_t downUs;        // Posledné stlačenie, od neho sa meria LONG_PRESS_MS
+  int64_t upUs;          // Posledné uvoľnenie, od neho sa meria DOUBLE_PRESS_GAP_MS
+  int64_t lastFireUs;    // Cooldown vstupu
+  bool anyFire;
+};
+
+static int inputCount = 0;
+static uint64_t pinBits[MAX_BUTTON_INPUTS];   // 1 << pin pre GPIO_IN / GPIO_IN1
+static EdgeCapture edges[MAX_BUTTON_INPUTS] = {};
+static InputState inputs[MAX_BUTTON_INPUTS] = {};
+static portMUX_TYPE edgeMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t buttonTaskHandle = nullptr;
+static QueueHandle_t buttonEvents = nullptr;
+
+// Bit i = vstup i; stableMask zapisuje iba task, busyMask číta isButtonIdle()
+static uint32_t stableMask = 0;               // Po debounce stlačené
+static volatile uint32_t busyMask = 0;        // Rozpracované gesto
+
+// Všetky vstupy jedným čítaním GPIO registrov: bit i = vstup i je LOW (stlačený)
+static uint32_t readPressedMask() {
+  uint64_t levels = ((uint64_t)REG_READ(GPIO_IN1_REG) << 32) | REG_READ(GPIO_IN_REG);
+  uint32_t pressed = 0;
+  for (int i = 0; i < inputCount; i++) {
+    if ((levels & pinBits[i]) == 0) pressed |= 1u << i;
+  }
+  return pressed;
+}
+
+// Každá hrana: čas v µs, žiadne čítanie stavu ani debounce tu
+static void ARDUINO_ISR_ATTR onButtonEdge(void* arg) {
+  int index = (int)(intptr_t)arg;
+  int64_t now = esp_timer_get_time();
+  bool low = digitalRead(BUTTON_INPUTS[index].pin) == LOW;
+
+  portENTER_CRITICAL_ISR(&edgeMux);
+  EdgeCapture& edge = edges[index];
+  if (!edge.pending) {
+    edge.pending = true;
+    edge.firstEdgeUs = now;
+    edge.firstFallUs = 0;
+  }
+  if (low && edge.firstFallUs == 0) {
+    edge.firstFallUs = now;
+  }
+  edge.lastEdgeUs = now;
+  portEXIT_CRITICAL_ISR(&edgeMux);
+
+  BaseType_t woken = pdFALSE;
+  if (buttonTaskHandle != nullptr) {
+    vTaskNotifyGiveFromISR(buttonTaskHandle, &woken);
+  }
+  portYIELD_FROM_ISR(woken);
+}
+
+static const char* gestureName(uint8_t gesture) {
+  switch (gesture) {
+    case GESTURE_LONG: return "long";
+    case GESTURE_DOUBLE: return "double";
+    default: return "short";
+  }
+}
+
+static bool hasAction(int index, ButtonGesture gesture) {
+  return BUTTON_INPUTS[index].actions[gesture].topic != nullptr;
+}
+
+static void fireGesture(int index, ButtonGesture gesture) {
+  InputState& input = inputs[index];
+  int64_t pressUs = input.firstPressUs;
+
+  // Cooldown podľa času stlačenia, nie podľa toho, kedy ho loop() spracuje
+  if (input.anyFire && pressUs - input.lastFireUs < (int64_t)BUTTON_INPUTS[index].cooldownMs * 1000) {
+    LOGR_DEBUG(HW, "Button %d: Blocked by cooldown", index);
+    return;
+  }
+  input.anyFire = true;
+  input.lastFireUs = pressUs;
+
+  ButtonEvent event = {pressUs, (uint8_t)index, (uint8_t)gesture};
+  if (xQueueSend(buttonEvents, &event, 0) != pdTRUE) {
+    LOGR_WARN(HW, "Button %d: event queue full, press dropped", index);
+  }
+}
+
+static void onPress(int index, int64_t atUs) {
+  InputState& input = inputs[index];
+
+  if (input.state == GESTURE_WAIT_SECOND) {
+    if (atUs - input.upUs <= (int64_t)DOUBLE_PRESS_GAP_MS * 1000) {
+      fireGesture(index, GESTURE_DOUBLE);
+      input.state = GESTURE_HOLD;
+      return;
+    }
+    fireGesture(index, GESTURE_SHORT);  // Medzera uplynula skôr, než ju tick stihol uzavrieť
+  }
+
+  input.state = GESTURE_DOWN;
+  input.firstPressUs = atUs;
+  input.downUs = atUs;
+
+  // Bez long aj double nie je na čo čakať – odoslať hneď pri stlačení
+  if (!hasAction(index, GESTURE_LONG) && !hasAction(index, GESTURE_DOUBLE)) {
+    fireGesture(index, GESTURE_SHORT);
+    input.state = GESTURE_HOLD;
+  }
+}
+
+static void onRelease(int index, int64_t atUs) {
+  InputState& input = inputs[index];
+  if (input.state != GESTURE_DOWN) {
+    input.state = GESTURE_IDLE;
+    return;
+  }
+
+  if (hasAction(index, GESTURE_DOUBLE)) {
+    input.state = GESTURE_WAIT_SECOND;
+    input.upUs = atUs;
+    return;
+  }
+  fireGesture(index, GESTURE_SHORT);
+  input.state = GESTURE_IDLE;
+}
+
+// Časové prechody (long, koniec double okna); vracia najbližší termín alebo INT64_MAX
+static int64_t tickGesture(int index, int64_t nowUs) {
+  InputState& input = inputs[index];
+
+  if (input.state == GESTURE_DOWN && hasAction(index, GESTURE_LONG)) {
+    int64_t deadline = input.downUs + (int64_t)LONG_PRESS_MS * 1000;
+    if (nowUs < deadline) return deadline;
+    fireGesture(index, GESTURE_LONG);
+    input.state = GESTURE_HOLD;
+  } else if (input.state == GESTURE_WAIT_SECOND) {
+    int64_t deadline = input.upUs + (int64_t)DOUBLE_PRESS_GAP_MS * 1000;
+    if (nowUs < deadline) return deadline;
+    fireGesture(index, GESTURE_SHORT);
+    input.state = GESTURE_IDLE;
+  }
+  return INT64_MAX;
+}
+
+// Jeden prechod cez všetky vstupy: dávky ticho DEBOUNCE_DELAY sa uzavrú naraz
+// (jedno čítanie GPIO registrov, zmeny ako bitové masky), potom časové prechody gest.
+// Vracia čas najbližšej udalosti (debounce / long / double) alebo INT64_MAX.
+static int64_t processInputs() {
+  const int64_t debounceUs = (int64_t)DEBOUNCE_DELAY * 1000;
+  const int64_t minPressUs = (int64_t)BUTTON_MIN_PRESS_MS * 1000;
+
+  EdgeCapture burst[MAX_BUTTON_INPUTS];
+  portENTER_CRITICAL(&edgeMux);
+  memcpy(burst, edges, sizeof(burst));
+  portEXIT_CRITICAL(&edgeMux);
+
+  int64_t nowUs = esp_timer_get_time();
+  int64_t next = INT64_MAX;
+  uint32_t pendingMask = 0;
+  uint32_t settledMask = 0;
+  for (int i = 0; i < inputCount; i++) {
+    if (!burst[i].pending) continue;
+    pendingMask |= 1u << i;
+    int64_t quietAt = burst[i].lastEdgeUs + debounceUs;
+    if (nowUs >= quietAt) {
+      settledMask |= 1u << i;
+    } else if (quietAt < next) {
+      next = quietAt;
+    }
+  }
+
+  if (settledMask != 0) {
+    uint32_t pressedMask = readPressedMask();
+
+    // Hrana počas čítania – tento vstup počká na ďalšie ticho
+    portENTER_CRITICAL(&edgeMux);
+    for (int i = 0; i < inputCount; i++) {
+      if (!(settledMask & (1u << i))) continue;
+      if (edges[i].lastEdgeUs == burst[i].lastEdgeUs) {
+        edges[i].pending = false;
+      } else {
+        settledMask &= ~(1u << i);
+      }
+    }
+    portEXIT_CRITICAL(&edgeMux);
+    if (settledMask != 0 && next > nowUs + debounceUs) next = nowUs + debounceUs;
+
+    uint32_t wasUp = settledMask & ~stableMask;
+    uint32_t pressed = wasUp & pressedMask;                 // HIGH -> LOW
+    uint32_t tapped = wasUp & ~pressedMask;                 // Stlačené a pustené v jednom okne
+    uint32_t released = settledMask & stableMask & ~pressedMask;  // LOW -> HIGH
+    stableMask = (stableMask & ~settledMask) | (pressedMask & settledMask);
+
+    for (int i = 0; i < inputCount; i++) {
+      uint32_t bit = 1u << i;
+      if (pressed & bit) {
+        if (burst[i].firstFallUs != 0) onPress(i, burst[i].firstFallUs);
+      } else if (tapped & bit) {
+        // Krátke stlačenie, ktoré sa uvoľnilo ešte počas debounce okna, platí,
+        // ak linka bola LOW aspoň BUTTON_MIN_PRESS_MS
+        if (burst[i].firstFallUs != 0 && burst[i].lastEdgeUs - burst[i].firstFallUs >= minPressUs) {
+          onPress(i, burst[i].firstFallUs);
+          onRelease(i, burst[i].lastEdgeUs);
         }
+      } else if (released & bit) {
+        onRelease(i, burst[i].firstEdgeUs);
       }
     }
+    pendingMask &= ~settledMask;
+  }
+
+  // Vstup s otvorenou dávkou sa vyhodnotí až po jej uzavretí (uvoľnenie pred termínom long)
+  uint32_t busy = 0;
+  for (int i = 0; i < inputCount; i++) {
+    if (pendingMask & (1u << i)) {
+      busy |= 1u << i;
+      continue;
+    }
+    int64_t deadline = tickGesture(i, nowUs);
+    if (deadline < next) next = deadline;
+    if (inputs[i].state != GESTURE_IDLE) busy |= 1u << i;
+  }
+  busyMask = busy;
+  return next;
+}
+
+static void buttonTask(void* parameter) {
+  TickType_t wait = portMAX_DELAY;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, wait);
+
+    int64_t next = processInputs();
+    if (next == INT64_MAX) {
+      wait = portMAX_DELAY;
+    } else {
+      int64_t waitUs = next - esp_timer_get_time();
+      wait = waitUs > 0 ? pdMS_TO_TICKS(waitUs / 1000 + 1) : 1;
+    }
+  }
+}
+
+void initializeHardware() {
+  LOG_INFO(HW, "Initializing Hardware (External Pull-up)...");
+
+  inputCount = BUTTON_INPUT_COUNT;
+  if (inputCount > MAX_BUTTON_INPUTS) {
+    LOG_WARN(HW, "Button: " + String(inputCount) + " inputs configured, using first " + String(MAX_BUTTON_INPUTS));
+    inputCount = MAX_BUTTON_INPUTS;
+  }
+
+  // DÔLEŽITÉ: Používame INPUT, pretože máte externý rezistor na 3.3V
+  for (int i = 0; i < inputCount; i++) {
+    pinMode(BUTTON_INPUTS[i].pin, INPUT);
+    pinBits[i] = 1ULL << BUTTON_INPUTS[i].pin;
   }
+  stableMask = readPressedMask();
+
+  buttonEvents = xQueueCreate(BUTTON_EVENT_QUEUE_LEN, sizeof(ButtonEvent));
 
-  lastButtonState = reading;
-  return verifiedPress;
+  // Task musí existovať pred prvou hranou
+  xTaskCreatePinnedToCore(buttonTask, "button", BUTTON_TASK_STACK, nullptr,
+                          BUTTON_TASK_PRIORITY, &buttonTaskHandle, BUTTON_TASK_CORE);
+  for (int i = 0; i < inputCount; i++) {
+    attachInterruptArg(digitalPinToInterrupt(BUTTON_INPUTS[i].pin), onButtonEdge, (void*)(intptr_t)i, CHANGE);
+    LOG_INFO(HW, "Button " + String(i) + " initialized on PIN " + String(BUTTON_INPUTS[i].pin) + " (interrupt)");
+  }
+}
+
+bool wasButtonPressed(ButtonEvent* event) {
+  ButtonEvent received;
+  if (buttonEvents == nullptr || xQueueReceive(buttonEvents, &received, 0) != pdTRUE) {
+    return false;
+  }
+
+  LOGR_DEBUG(HW, "Button %d: %s (Valid), %ld ms ago", received.input, gestureName(received.gesture),
+             (long)((esp_timer_get_time() - received.pressUs) / 1000));
+  if (event != nullptr) *event = received;
+  return true;
+}
+
+void armButtonWake() {
+  for (int i = 0; i < inputCount; i++) {
+    gpio_num_t pin = (gpio_num_t)BUTTON_INPUTS[i].pin;
+    gpio_intr_disable(pin);  // Úrovňové prerušenie by pri držaní zahltilo CPU
+    gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+  }
+}
+
+void disarmButtonWake(bool wokenByButton, int64_t wakeUs) {
+  for (int i = 0; i < inputCount; i++) {
+    gpio_num_t pin = (gpio_num_t)BUTTON_INPUTS[i].pin;
+    gpio_wakeup_disable(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+    gpio_intr_enable(pin);
+  }
+  if (!wokenByButton) return;
+
+  // Hrana do LOW prebehla v spánku – ISR ju nevidel. ESP32 nehlási, ktorý pin prebudil,
+  // preto ju dostane každý vstup, ktorý je teraz stlačený.
+  uint32_t pressedMask = readPressedMask();
+  if (pressedMask == 0) return;
+
+  portENTER_CRITICAL(&edgeMux);
+  for (int i = 0; i < inputCount; i++) {
+    if (!(pressedMask & (1u << i))) continue;
+    EdgeCapture& edge = edges[i];
+    if (!edge.pending) {
+      edge.pending = true;
+      edge.firstEdgeUs = wakeUs;
+      edge.firstFallUs = 0;
+    }
+    if (edge.firstFallUs == 0 || wakeUs < edge.firstFallUs) {
+      edge.firstFallUs = wakeUs;
+    }
+    if (wakeUs > edge.lastEdgeUs) {
+      edge.lastEdgeUs = wakeUs;
+    }
+  }
+  portEXIT_CRITICAL(&edgeMux);
+
+  if (buttonTaskHandle != nullptr) {
+    xTaskNotifyGive(buttonTaskHandle);
+  }
+}
+
+bool isButtonIdle() {
+  bool pending = false;
+  portENTER_CRITICAL(&edgeMux);
+  for (int i = 0; i < inputCount; i++) {
+    pending = pending || edges[i].pending;
+  }
+  portEXIT_CRITICAL(&edgeMux);
+
+  return !pending && busyMask == 0 && stableMask == 0 && readPressedMask() == 0 &&
+         (buttonEvents == nullptr || uxQueueMessagesWaiting(buttonEvents) == 0);
 }
 
 void turnOffHardware() {
-  debugPrint("Hardware safe mode active");
-}
\ No newline at end of file
+  LOG_INFO(HW, "Hardware safe mode active");
+}
@@ -1,13 +1,30 @@
 #ifndef HARDWARE_H
 #define HARDWARE_H
 
-// Inicializácia tlačidla
+#include <stdint.h>
+
+// Jedno rozpoznané gesto z debounce tasku
+struct ButtonEvent {
+  int64_t pressUs;   // esp_timer_get_time() prvej hrany gesta (µs od bootu)
+  uint8_t input;     // Index v BUTTON_INPUTS
+  uint8_t gesture;   // ButtonGesture
+};
+
+// Inicializácia tlačidiel z BUTTON_INPUTS (GPIO prerušenia + debounce task)
 void initializeHardware();
 
-// Funkcia na kontrolu stlačenia (vracia true, ak bolo práve stlačené)
-bool wasButtonPressed();
+// Vyberie ďalšie gesto z fronty (vracia true, ak nejaké čakalo)
+bool wasButtonPressed(ButtonEvent* event = nullptr);
+
+// Light sleep: počas spánku hrany neprerušujú, prebúdza úroveň LOW na ktoromkoľvek vstupe.
+// Po prebudení tlačidlom sa stlačeným vstupom doplní zmeškaná hrana s časom prebudenia.
+void armButtonWake();
+void disarmButtonWake(bool wokenByButton, int64_t wakeUs);
+
+// Všetko pustené, žiadny debounce, rozpracované gesto ani nespracovaná udalosť (podmienka pre spánok)
+bool isButtonIdle();
 
 // Vypnutie (pre OTA bezpečnosť, aj keď tu nemá čo bežať)
 void turnOffHardware();
 
-#endif
\ No newline at end of file
+#endif
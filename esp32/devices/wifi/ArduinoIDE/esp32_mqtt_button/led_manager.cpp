@@ -0,0 +1,140 @@
+#include "led_manager.h"
+#include "config.h"
+#include "debug.h"
+#include <Arduino.h>
+#include <math.h>
+
+// Body krivky pre polovicu dýchania (0 -> max); medzi nimi lineárne hardvérové fade
+static const int CURVE_STEPS = 16;
+
+enum LedPattern : uint8_t {
+  LED_PATTERN_OFF,
+  LED_PATTERN_SOLID,
+  LED_PATTERN_BREATHE,
+  LED_PATTERN_BLINK
+};
+
+static uint32_t maxDuty = 255;
+static uint32_t curve[CURVE_STEPS + 1];   // Predpočítané v initializeLED()
+
+static LedPattern pattern = LED_PATTERN_OFF;
+static unsigned long breathePeriod = 0;
+static int breatheStep = 0;               // 0..2*CURVE_STEPS-1 (hore, potom dole)
+static unsigned long nextStepTime = 0;
+
+static int blinkPhases = 0;               // Zostávajúce polfázy potvrdenia (vyp / zap)
+static unsigned long nextBlinkTime = 0;
+
+static uint32_t currentDuty = 0;
+static unsigned long fadeEndTime = 0;     // Počas hardvérového fade sa do kanála nezapisuje
+static bool ledReady = false;
+
+static bool fadeRunning(unsigned long now) {
+  return (long)(fadeEndTime - now) > 0;
+}
+
+// Zápis iba pri zmene
+static void setDuty(uint32_t duty) {
+  if (duty == currentDuty) return;
+  ledcWrite(LED_PIN, duty);
+  currentDuty = duty;
+}
+
+static void fadeTo(uint32_t duty, unsigned long durationMs, unsigned long now) {
+  if (duty == currentDuty) return;
+  ledcFade(LED_PIN, currentDuty, duty, durationMs);
+  currentDuty = duty;
+  fadeEndTime = now + durationMs + 1;
+}
+
+static void startPattern(LedPattern next, unsigned long period, unsigned long now) {
+  pattern = next;
+  breathePeriod = period;
+  breatheStep = 0;
+  nextStepTime = now;
+}
+
+void initializeLED() {
+  maxDuty = (1UL << PWM_RESOLUTION) - 1;
+
+  // Dýchanie: kosínusový nábeh, gama 2.2 – oko vníma jas logaritmicky
+  for (int i = 0; i <= CURVE_STEPS; i++) {
+    float phase = (1.0f - cosf((float)M_PI * i / CURVE_STEPS)) / 2.0f;
+    curve[i] = (uint32_t)lroundf(powf(phase, 2.2f) * maxDuty);
+  }
+
+  ledReady = ledcAttachChannel(LED_PIN, PWM_FREQUENCY, PWM_RESOLUTION, PWM_CHANNEL);
+  if (!ledReady) {
+    LOG_ERROR(LED, "LEDC attach failed on GPIO" + String(LED_PIN));
+    return;
+  }
+  ledcWrite(LED_PIN, 0);
+  currentDuty = 0;
+  LOG_INFO(LED, "Initialized on GPIO" + String(LED_PIN));
+}
+
+void ledButtonConfirm() {
+  blinkPhases = LED_BLINK_COUNT * 2;
+  nextBlinkTime = millis();
+}
+
+static void stepBreathe(unsigned long now) {
+  if ((long)(now - nextStepTime) < 0) return;
+
+  unsigned long segmentMs = max(1UL, breathePeriod / (2 * CURVE_STEPS));
+  int index = breatheStep < CURVE_STEPS ? breatheStep + 1 : 2 * CURVE_STEPS - breatheStep - 1;
+  fadeTo(curve[index], segmentMs, now);
+  breatheStep = (breatheStep + 1) % (2 * CURVE_STEPS);
+  nextStepTime = now + segmentMs;
+}
+
+void updateLED(bool wifiOk, bool mqttOk, bool triggerPending) {
+  if (!ledReady) return;
+
+  unsigned long now = millis();
+  if (fadeRunning(now)) return;  // Zápis počas fade by sa s ním pobil, segment trvá desiatky ms
+
+  // 1. Potvrdenie stlačenia: vyp / zap, končí rozsvietená
+  if (blinkPhases > 0) {
+    if ((long)(now - nextBlinkTime) < 0) return;
+    blinkPhases--;
+    setDuty(blinkPhases % 2 == 1 ? 0 : maxDuty);
+    nextBlinkTime = now + LED_BLINK_FAST;
+    if (blinkPhases == 0) pattern = LED_PATTERN_BLINK;  // Status vzor začne odznova
+    return;
+  }
+
+  // 2.–4. Status
+  LedPattern wanted = LED_PATTERN_SOLID;
+  unsigned long period = 0;
+  if (!wifiOk || !mqttOk) {
+    wanted = LED_PATTERN_BREATHE;
+    period = LED_PULSE_INTERVAL;
+  } else if (triggerPending) {
+    wanted = LED_PATTERN_BREATHE;
+    period = LED_PENDING_INTERVAL;
+  }
+  if (wanted != pattern || period != breathePeriod) {
+    startPattern(wanted, period, now);
+    // Dýchanie začína od tmy, nie skokom z aktuálneho jasu
+    if (wanted == LED_PATTERN_BREATHE) setDuty(0);
+  }
+
+  if (pattern == LED_PATTERN_SOLID) {
+    setDuty(maxDuty);
+  } else if (pattern == LED_PATTERN_BREATHE) {
+    stepBreathe(now);
+  }
+}
+
+void turnOffLED() {
+  if (!ledReady) return;
+
+  // Najviac jeden segment krivky (LED_PULSE_INTERVAL / 32)
+  while (fadeRunning(millis())) {
+    delay(1);
+  }
+  setDuty(0);
+  blinkPhases = 0;
+  pattern = LED_PATTERN_OFF;
+}
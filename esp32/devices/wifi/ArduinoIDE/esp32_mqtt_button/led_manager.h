@@ -0,0 +1,22 @@
+#ifndef LED_MANAGER_H
+#define LED_MANAGER_H
+
+// LED v tlačidle cez LEDC PWM. Vzory (podľa priority):
+//   1. potvrdenie stlačenia – LED_BLINK_COUNT rýchlych bliknutí
+//   2. WiFi alebo MQTT FAIL – pomalé dýchanie (LED_PULSE_INTERVAL)
+//   3. trigger čaká na ack – rýchle dýchanie (LED_PENDING_INTERVAL)
+//   4. všetko OK – trvalo svieti
+// Dýchanie = hardvérové fade medzi bodmi predpočítanej krivky; žiadne delay(),
+// updateLED() iba skontroluje čas a prípadne zapíše jednu hodnotu.
+void initializeLED();
+
+// Volať v každom prechode loop()
+void updateLED(bool wifiOk, bool mqttOk, bool triggerPending);
+
+// Spustí potvrdzovacie blikanie (prerušuje status vzor, potom sa k nemu vráti)
+void ledButtonConfirm();
+
+// Pred light sleep: počká na koniec rozbehnutého fade segmentu a zhasne
+void turnOffLED();
+
+#endif
@@ -2,6 +2,15 @@
 #include "config.h"
 #include "debug.h"
 #include "wifi_manager.h"
+#include "outbox.h"
+#include "power_manager.h"
+#include <esp_timer.h>
+#include <museum_command.h>
+#include <museum_metrics.h>
+#include <sys/time.h>
+
+// Unix čas pod touto hranicou = SNTP ešte nesynchronizoval
+static const time_t MIN_VALID_EPOCH = 1600000000;
 
 WiFiClient wifiClient;
 PubSubClient client(wifiClient);
@@ -9,31 +18,197 @@ bool mqttConnected = false;
 unsigned long lastMqttAttempt = 0;
 unsigned long lastStatusPublish = 0;
 String STATUS_TOPIC;
+String OUTBOX_TOPIC;
+String POWER_TOPIC;
+String LOG_TOPIC;
+String LOG_SET_TOPIC;
+String DIAG_TOPIC;
+String DIAG_GET_TOPIC;
+String DIAG_WARN_TOPIC;
+
+static const char ACK_SUFFIX[] = "/ack";
+
+static bool isAckTopic(const char* topic) {
+  size_t length = strlen(topic);
+  size_t suffix = sizeof(ACK_SUFFIX) - 1;
+  return length > suffix && strcmp(topic + length - suffix, ACK_SUFFIX) == 0;
+}
+
+// Vzdialený log: dávky z MuseumLog streamu, publikuje ich len mqttLoop()
+static bool publishLogBatch(const char* payload, size_t length) {
+  return client.publish(LOG_TOPIC.c_str(), (const uint8_t*)payload, length, false);
+}
+
+// devices/<id>/log/set = OFF | ON[:<ERROR|WARN|INFO|DEBUG>], odpoveď na .../feedback
+static void handleLogCommand(const char* topic, const char* message, unsigned int length) {
+  char feedbackTopic[96];
+  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+
+  uint8_t level;
+  CmdError error = parseLogCommand(message, length, &level);
+  if (error != CMD_OK) {
+    char feedback[24];
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(error));
+    client.publish(feedbackTopic, feedback, false);
+    return;
+  }
+
+  logStreamSetLevel(level);
+  client.publish(feedbackTopic, "OK", false);
+  LOGF_INFO(MQTT, "Vzdialený log: %s", level == LOG_LEVEL_NONE ? "OFF" : logLevelName(level));
+}
+
+// Diagnostika taskov a heapu – publikuje ich len systemDiagLoop() z mqttLoop()
+static bool publishDiag(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_TOPIC.c_str(), payload, false);
+}
+
+static bool publishDiagWarning(const char* payload) {
+  LOGF_WARN(MQTT, "Diagnostika: %s", payload);
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_WARN_TOPIC.c_str(), payload, false);
+}
 
-// Callback nepotrebujeme, pretože nič nepočúvame, ale knižnica ho vyžaduje
+// Odbery <prefix><topic>/ack akcií z BUTTON_INPUTS (payload ACK:<seq>), devices/<id>/log/set
+// a devices/<id>/diag/get.
+// Seq je jedinečné naprieč vstupmi, netreba rozlišovať, z ktorého topicu prišiel.
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  // Prázdny callback
+  if (LOG_SET_TOPIC == topic) {
+    handleLogCommand(topic, (const char*)payload, length);
+    return;
+  }
+  if (DIAG_GET_TOPIC == topic) {
+    systemDiagRequest();
+    return;
+  }
+  if (!isAckTopic(topic)) return;
+
+  uint32_t seq;
+  CmdError error = parseAckCommand((const char*)payload, length, &seq);
+  if (error != CMD_OK) {
+    LOG_WARN(MQTT, "Invalid trigger ack: " + String(cmdErrorName(error)));
+    return;
+  }
+  outboxAcknowledge(seq);
+}
+
+// Topic môže používať viac vstupov / gest – odoberá sa raz
+static bool topicSeenBefore(int input, int gesture) {
+  const char* topic = BUTTON_INPUTS[input].actions[gesture].topic;
+  for (int i = 0; i <= input; i++) {
+    int lastGesture = (i == input) ? gesture : GESTURE_COUNT;
+    for (int g = 0; g < lastGesture; g++) {
+      const char* other = BUTTON_INPUTS[i].actions[g].topic;
+      if (other != nullptr && strcmp(other, topic) == 0) return true;
+    }
+  }
+  return false;
+}
+
+static void subscribeAckTopics() {
+  for (int i = 0; i < BUTTON_INPUT_COUNT; i++) {
+    for (int g = 0; g < GESTURE_COUNT; g++) {
+      if (BUTTON_INPUTS[i].actions[g].topic == nullptr || topicSeenBefore(i, g)) continue;
+      String ackTopic = String(BASE_TOPIC_PREFIX) + BUTTON_INPUTS[i].actions[g].topic + ACK_SUFFIX;
+      client.subscribe(ackTopic.c_str());
+    }
+  }
 }
 
 void initializeMqtt() {
   STATUS_TOPIC = "devices/" + String(CLIENT_ID) + "/status";
+  OUTBOX_TOPIC = "devices/" + String(CLIENT_ID) + "/outbox";
+  POWER_TOPIC = "devices/" + String(CLIENT_ID) + "/power";
+  LOG_TOPIC = "devices/" + String(CLIENT_ID) + "/log";
+  LOG_SET_TOPIC = LOG_TOPIC + "/set";
+  DIAG_TOPIC = "devices/" + String(CLIENT_ID) + "/diag";
+  DIAG_GET_TOPIC = DIAG_TOPIC + "/get";
+  DIAG_WARN_TOPIC = DIAG_TOPIC + "/warn";
   client.setServer(MQTT_SERVER, MQTT_PORT);
   client.setKeepAlive(MQTT_KEEP_ALIVE);
   client.setCallback(mqttCallback);
-  debugPrint("MQTT initialized");
+  client.setBufferSize(LOG_STREAM_BATCH_MAX + 128);  // Dávky vzdialeného logu (default 256 B)
+  SystemThresholds limits = {DIAG_MIN_FREE_HEAP, DIAG_MAX_FRAGMENTATION, DIAG_MIN_STACK_FREE, DIAG_MAX_TASK_CPU};
+  systemDiagBegin(limits, DIAG_CHECK_INTERVAL, DIAG_REPORT_INTERVAL);
+  if (strlen(NTP_SERVER) > 0) {
+    configTime(0, 0, NTP_SERVER);  // Synchronizuje sa na pozadí po pripojení WiFi
+  }
+  LOG_INFO(MQTT, "MQTT initialized");
+}
+
+// Čas stlačenia v Unix ms: aktuálny čas mínus vek udalosti. Vracia false bez SNTP.
+static bool pressUnixMs(const ButtonEvent& event, int64_t* unixMs) {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  if (now.tv_sec < MIN_VALID_EPOCH) return false;
+
+  int64_t nowUs = (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+  *unixMs = (nowUs - (esp_timer_get_time() - event.pressUs)) / 1000;
+  return true;
 }
 
-void publishSceneTrigger() {
-  if (!isMqttConnected()) return;
+bool publishButtonAction(const ButtonEvent& event, uint32_t seq) {
+  if (!isMqttConnected()) return false;
+
+  const ButtonAction& action = BUTTON_INPUTS[event.input].actions[event.gesture];
+  if (action.topic == nullptr) return true;  // Gesto bez akcie sa do outboxu nedostane, len poistka
 
-  String topic = String(BASE_TOPIC_PREFIX) + String(SCENE_TOPIC_SUFFIX);
-  // Výsledok: "room1/scene" -> "START"
-  
-  if (client.publish(topic.c_str(), SCENE_PAYLOAD, false)) {
-    debugPrint(">>> SCENE TRIGGER SENT: " + topic + " -> " + String(SCENE_PAYLOAD));
+  // Výsledok: "room1/scene" -> "START@1760612345678#42" (backend meria latenciu, deduplikuje a potvrdí seq)
+  char topic[96];
+  char payload[80];
+  snprintf(topic, sizeof(topic), "%s%s", BASE_TOPIC_PREFIX, action.topic);
+  int64_t unixMs;
+  if (pressUnixMs(event, &unixMs)) {
+    snprintf(payload, sizeof(payload), "%s@%lld#%lu", action.payload, (long long)unixMs, (unsigned long)seq);
   } else {
-    debugPrint("!!! Failed to send scene trigger");
+    snprintf(payload, sizeof(payload), "%s#%lu", action.payload, (unsigned long)seq);
+  }
+
+  if (client.publish(topic, payload, false)) {
+    LOG_INFO(MQTT, ">>> TRIGGER SENT: " + String(topic) + " -> " + String(payload));
+    powerNoteTriggerPublished();
+    return true;
   }
+  LOG_WARN(MQTT, "Failed to send trigger on " + String(topic));
+  return false;
+}
+
+bool publishOutboxStats(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(OUTBOX_TOPIC.c_str(), payload, false);
+}
+
+bool publishPowerStats(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(POWER_TOPIC.c_str(), payload, false);
+}
+
+// Jeden pokus o spojenie vrátane subscribe a "online"
+static bool mqttConnectOnce() {
+  LOG_INFO(MQTT, "MQTT connecting...");
+
+  // Last Will: "offline"
+  if (!client.connect(CLIENT_ID, STATUS_TOPIC.c_str(), 0, true, "offline")) {
+    LOG_WARN(MQTT, "MQTT Failed rc=" + String(client.state()));
+    return false;
+  }
+
+  LOG_INFO(MQTT, "MQTT Connected!");
+  mqttConnected = true;
+
+  // Ack triggerov; čakajúci trigger poslať hneď, ack pred výpadkom sa mohol stratiť
+  subscribeAckTopics();
+  client.subscribe(LOG_SET_TOPIC.c_str());
+  client.subscribe(DIAG_GET_TOPIC.c_str());
+  outboxResend();
+
+  // Oznámime, že sme online
+  client.publish(STATUS_TOPIC.c_str(), "online", true);
+
+  // Reset lastStatusPublish to 0 so heartbeat publishes immediately
+  lastStatusPublish = 0;
+  return true;
 }
 
 void connectToMqtt() {
@@ -43,30 +218,40 @@ void connectToMqtt() {
   static unsigned long mqttRetryInterval = MQTT_RETRY_INTERVAL;
 
   if (!client.connected() && (currentTime - lastMqttAttempt >= mqttRetryInterval)) {
-    debugPrint("MQTT connecting...");
-    
-    // Last Will: "offline"
-    if (client.connect(CLIENT_ID, STATUS_TOPIC.c_str(), 0, true, "offline")) {
-      debugPrint("MQTT Connected!");
-      mqttConnected = true;
+    if (mqttConnectOnce()) {
       mqttRetryInterval = MQTT_RETRY_INTERVAL;
-
-      // Nepotrebujeme subscribe, lebo nič nepočúvame
-      
-      // Oznámime, že sme online
-      client.publish(STATUS_TOPIC.c_str(), "online", true);
-      
-      // Reset lastStatusPublish to 0 so heartbeat publishes immediately
-      lastStatusPublish = 0;
-
     } else {
-      debugPrint("MQTT Failed rc=" + String(client.state()));
       mqttRetryInterval = min(mqttRetryInterval * 2, MAX_RETRY_INTERVAL);
     }
     lastMqttAttempt = currentTime;
   }
 }
 
+// IP brokera z posledného spojenia – po prebudení bez mDNS dotazu na MQTT_SERVER
+RTC_DATA_ATTR static uint32_t cachedBrokerIp = 0;
+
+bool connectMqttNow() {
+  if (!wifiConnected || !isWiFiConnected()) return false;
+
+  if (cachedBrokerIp != 0) {
+    client.setServer(IPAddress(cachedBrokerIp), MQTT_PORT);
+    if (mqttConnectOnce()) return true;
+    cachedBrokerIp = 0;
+    client.setServer(MQTT_SERVER, MQTT_PORT);
+  }
+
+  if (!mqttConnectOnce()) return false;
+  cachedBrokerIp = (uint32_t)wifiClient.remoteIP();
+  return true;
+}
+
+void disconnectMqtt() {
+  if (client.connected()) {
+    client.disconnect();  // Čisté odpojenie – bez LWT "offline", registry drží heartbeat
+  }
+  mqttConnected = false;
+}
+
 void mqttLoop() {
   if (!wifiConnected) return;
   client.loop(); // Udržiava spojenie (ping)
@@ -79,6 +264,12 @@ void mqttLoop() {
     }
     lastStatusPublish = currentTime;
   }
+
+  // Najviac jedna dávka vzdialeného logu za LOG_STREAM_INTERVAL
+  if (isMqttConnected()) logStreamLoop(publishLogBatch);
+
+  // Kontrola limitov každých DIAG_CHECK_INTERVAL, report každých DIAG_REPORT_INTERVAL / na požiadanie
+  systemDiagLoop(publishDiag, publishDiagWarning);
 }
 
 bool isMqttConnected() {
@@ -3,13 +3,24 @@
 
 #include <PubSubClient.h>
 #include <WiFi.h>
+#include "hardware.h"
 
 void initializeMqtt();
 void connectToMqtt();
 void mqttLoop();
 
-// Odoslanie triggeru scény
-void publishSceneTrigger();
+// Battery mode: jeden okamžitý pokus bez backoffu (IP brokera z cache) a čisté odpojenie
+bool connectMqttNow();
+void disconnectMqtt();
+
+// Odoslanie akcie gesta na <prefix><topic> (<payload>@<unixMs>#<seq>, bez SNTP <payload>#<seq>), volá outbox
+bool publishButtonAction(const ButtonEvent& event, uint32_t seq);
+
+// Štatistiky outboxu na devices/<CLIENT_ID>/outbox
+bool publishOutboxStats(const char* payload);
+
+// Spotreba a latencia prebudenia na devices/<CLIENT_ID>/power (battery mode)
+bool publishPowerStats(const char* payload);
 
 // Status
 void publishStatus();
@@ -12,12 +12,12 @@ bool otaInitialized = false;
 
 void initializeOTA() {
   if (!wifiConnected || !isWiFiConnected()) {
-    debugPrint("OTA: WiFi not connected, skipping OTA setup");
+    LOG_WARN(OTA, "WiFi not connected, skipping OTA setup");
     return;
   }
 
   if (otaInitialized) {
-    debugPrint("OTA: Already initialized");
+    LOG_INFO(OTA, "Already initialized");
     return;
   }
 
@@ -30,7 +30,7 @@ void initializeOTA() {
   // OTA Start callback - prepare for upload
   ArduinoOTA.onStart([]() {
     otaInProgress = true;
-    debugPrint("OTA: Update starting - preparing system...");
+    LOG_INFO(OTA, "Update starting - preparing system...");
     Serial.println("=== OTA UPDATE STARTING ===");
     Serial.println("Preparing system for upload...");
 
@@ -38,7 +38,7 @@ void initializeOTA() {
     try {
       esp_task_wdt_deinit();
       Serial.println("✅ Watchdog disabled");
-      debugPrint("OTA: Watchdog timer disabled");
+      LOG_INFO(OTA, "Watchdog timer disabled");
     } catch (...) {
       Serial.println("⚠️  Watchdog already disabled");
     }
@@ -46,20 +46,20 @@ void initializeOTA() {
     // Step 2: Turn off all hardware
     turnOffHardware();
     Serial.println("✅ All hardware turned OFF");
-    debugPrint("OTA: Hardware safely disabled");
+    LOG_INFO(OTA, "Hardware safely disabled");
 
     // Step 3: Stop all non-essential tasks
     Serial.println("✅ System prepared for upload");
 
     String update_type = (ArduinoOTA.getCommand() == U_FLASH) ? "sketch" : "filesystem";
     Serial.println("Updating: " + update_type);
-    debugPrint("OTA: Starting " + update_type + " update");
+    LOG_INFO(OTA, "Starting " + update_type + " update");
   });
 
   // OTA End callback - restore system
   ArduinoOTA.onEnd([]() {
     otaInProgress = false;
-    debugPrint("OTA: Update completed successfully");
+    LOG_INFO(OTA, "Update completed successfully");
     Serial.println("\n=== OTA UPDATE COMPLETE ===");
     Serial.println("✅ Upload successful!");
     Serial.println("🔄 Rebooting in 2 seconds...");
@@ -109,7 +109,7 @@ void initializeOTA() {
     }
 
     Serial.println(errorMsg);
-    debugPrint("OTA Error: " + errorMsg);
+    LOG_ERROR(OTA, "Error: " + errorMsg);
 
     Serial.println("💡 Try again - make sure WiFi is stable");
     Serial.println("=================");
@@ -123,9 +123,9 @@ void initializeOTA() {
       };
       esp_task_wdt_init(&wdt_config);
       esp_task_wdt_add(NULL);
-      debugPrint("OTA: Watchdog re-enabled after error");
+      LOG_INFO(OTA, "Watchdog re-enabled after error");
     } catch (...) {
-      debugPrint("OTA: Could not re-enable watchdog");
+      LOG_WARN(OTA, "Could not re-enable watchdog");
     }
   });
 
@@ -137,7 +137,7 @@ void initializeOTA() {
   ArduinoOTA.begin();
   otaInitialized = true;
 
-  debugPrint("OTA: Initialized successfully");
+  LOG_INFO(OTA, "Initialized successfully");
   Serial.println("=== OTA READY ===");
   Serial.println("Hostname: " + String(OTA_HOSTNAME));
   Serial.println("IP: " + WiFi.localIP().toString());
@@ -166,7 +166,7 @@ bool isOTAInProgress() {
 
 void reinitializeOTAAfterWiFiReconnect() {
   if (wifiConnected && !otaInitialized) {
-    debugPrint("OTA: Reinitializing after WiFi reconnect");
+    LOG_INFO(OTA, "Reinitializing after WiFi reconnect");
     initializeOTA();
   }
 }
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "outbox.h"
+#include "config.h"
+#include "debug.h"
+#include "mqtt_manager.h"
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+
+static const int OUTBOX_CAPACITY = 8;
+static const uint32_t OUTBOX_MAGIC = 0x4F425832;  // "OBX2"
+
+// Systémový čas v ms pod touto hranicou = SNTP ešte nesynchronizoval
+static const int64_t MIN_VALID_EPOCH_MS = 1600000000000LL;
+
+struct OutboxEntry {
+  uint32_t seq;
+  uint8_t input;     // Index v BUTTON_INPUTS
+  uint8_t gesture;
+  int64_t pressUs;   // esp_timer_get_time() v aktuálnom boote (po resete prepočítané)
+  int64_t sysMs;     // gettimeofday() v ms – tikanie RTC časovača prežije softvérový reset
+};
+
+// Celé v RTC_NOINIT – po WDT / panic / softvérovom resete ostane, checksum odhalí smetie
+struct OutboxStore {
+  uint32_t magic;
+  uint32_t tableHash;  // BUTTON_INPUTS pri zápise – po OTA s inou tabuľkou by index ukazoval inam
+  uint32_t nextSeq;
+  uint8_t head;
+  uint8_t count;
+  OutboxEntry entries[OUTBOX_CAPACITY];
+  uint32_t delivered;
+  uint32_t expired;    // Staršie ako OUTBOX_MAX_AGE_MS
+  uint32_t overflow;   // Vytlačené novším stlačením pri plnej fronte
+  uint32_t retries;
+  uint32_t checksum;
+};
+
+RTC_NOINIT_ATTR static OutboxStore store;
+
+// Doručovanie – iba RAM, po resete sa čakajúci trigger pošle znova
+static bool headSent = false;
+static unsigned long lastSendTime = 0;
+static unsigned long lastStatsTime = 0;
+
+// Latencia stlačenie → ack za okno štatistík
+static uint32_t latencyMin = 0;
+static uint32_t latencyMax = 0;
+static uint64_t latencySum = 0;
+static uint32_t latencyCount = 0;
+
+static uint32_t storeChecksum() {
+  const uint8_t* bytes = (const uint8_t*)&store;
+  uint32_t hash = 2166136261u;  // FNV-1a
+  for (size_t i = 0; i < offsetof(OutboxStore, checksum); i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static void sealStore() {
+  store.checksum = storeChecksum();
+}
+
+static uint32_t hashString(uint32_t hash, const char* text) {
+  for (; text != nullptr && *text; text++) {
+    hash = (hash ^ (uint8_t)*text) * 16777619u;
+  }
+  return (hash ^ 0xFF) * 16777619u;  // Oddeľovač (aj pre nullptr)
+}
+
+// Odtlačok tabuľky vstupov: piny a akcie, cooldown nie (nemení význam udalosti)
+static uint32_t inputTableHash() {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < BUTTON_INPUT_COUNT; i++) {
+    hash = (hash ^ (uint8_t)BUTTON_INPUTS[i].pin) * 16777619u;
+    for (int g = 0; g < GESTURE_COUNT; g++) {
+      hash = hashString(hash, BUTTON_INPUTS[i].actions[g].topic);
+      hash = hashString(hash, BUTTON_INPUTS[i].actions[g].payload);
+    }
+  }
+  return hash;
+}
+
+static bool storeValid() {
+  if (store.magic != OUTBOX_MAGIC || store.count > OUTBOX_CAPACITY ||
+      store.head >= OUTBOX_CAPACITY || store.checksum != storeChecksum()) {
+    return false;
+  }
+  for (int i = 0; i < store.count; i++) {
+    const OutboxEntry& entry = store.entries[(store.head + i) % OUTBOX_CAPACITY];
+    if (entry.input >= BUTTON_INPUT_COUNT || entry.gesture >= GESTURE_COUNT) return false;
+  }
+  return store.tableHash == inputTableHash();
+}
+
+static int64_t systemTimeMs() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return (int64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+static OutboxEntry& entryAt(int index) {
+  return store.entries[(store.head + index) % OUTBOX_CAPACITY];
+}
+
+static void popHead() {
+  store.head = (store.head + 1) % OUTBOX_CAPACITY;
+  store.count--;
+  headSent = false;
+}
+
+// Vek udalosti z predošlého bootu podľa systémového času. Ak SNTP medzitým posunul
+// hodiny (alebo ich reset vynuloval), vek sa nedá určiť – vracia -1.
+static int64_t ageAcrossResetMs(const OutboxEntry& entry, int64_t nowSysMs) {
+  bool entrySynced = entry.sysMs >= MIN_VALID_EPOCH_MS;
+  bool nowSynced = nowSysMs >= MIN_VALID_EPOCH_MS;
+  if (entrySynced != nowSynced) return -1;
+
+  int64_t age = nowSysMs - entry.sysMs;
+  return age >= 0 ? age : -1;
+}
+
+void initializeOutbox() {
+  esp_reset_reason_t reason = esp_reset_reason();
+  bool coldBoot = reason == ESP_RST_POWERON || reason == ESP_RST_BROWNOUT || reason == ESP_RST_UNKNOWN;
+
+  if (coldBoot || !storeValid()) {
+    memset(&store, 0, sizeof(store));
+    store.magic = OUTBOX_MAGIC;
+    store.tableHash = inputTableHash();
+    store.nextSeq = esp_random();  // Backend deduplikuje podľa seq – po vypnutí nezačínať od 0
+    sealStore();
+    LOG_INFO(OUTBOX, "empty (cold boot)");
+    return;
+  }
+
+  // Prežité udalosti prepočítať na esp_timer nového bootu, neurčiteľné / staré zahodiť
+  int64_t nowUs = esp_timer_get_time();
+  int64_t nowSysMs = systemTimeMs();
+  int kept = 0;
+  int total = store.count;
+  for (int i = 0; i < total; i++) {
+    OutboxEntry entry = entryAt(i);
+    int64_t ageMs = ageAcrossResetMs(entry, nowSysMs);
+    if (ageMs < 0 || ageMs > (int64_t)OUTBOX_MAX_AGE_MS) {
+      store.expired++;
+      continue;
+    }
+    entry.pressUs = nowUs - ageMs * 1000;
+    store.entries[(store.head + kept) % OUTBOX_CAPACITY] = entry;
+    kept++;
+  }
+  store.count = kept;
+  sealStore();
+
+  LOG_INFO(OUTBOX, String(kept) + "/" + String(total) + " trigger(s) survived reset");
+}
+
+void outboxPush(const ButtonEvent& event) {
+  if (store.count == OUTBOX_CAPACITY) {
+    LOGR_WARN(OUTBOX, "full, dropping oldest seq %lu", (unsigned long)entryAt(0).seq);
+    popHead();
+    store.overflow++;
+  }
+
+  int64_t ageMs = (esp_timer_get_time() - event.pressUs) / 1000;
+  OutboxEntry& entry = entryAt(store.count);
+  entry.seq = store.nextSeq++;
+  entry.input = event.input;
+  entry.gesture = event.gesture;
+  entry.pressUs = event.pressUs;
+  entry.sysMs = systemTimeMs() - ageMs;
+  store.count++;
+  sealStore();
+
+  LOGR_INFO(OUTBOX, "queued seq %lu (%d pending)", (unsigned long)entry.seq, (int)store.count);
+}
+
+// Zahodí expirované z čela fronty a obnoví sysMs ostatných (SNTP mohol posunúť hodiny)
+static void expireEntries() {
+  int64_t nowUs = esp_timer_get_time();
+  int64_t nowSysMs = systemTimeMs();
+  bool changed = false;
+
+  while (store.count > 0) {
+    OutboxEntry& head = entryAt(0);
+    if ((nowUs - head.pressUs) / 1000 <= (int64_t)OUTBOX_MAX_AGE_MS) break;
+    LOGR_WARN(OUTBOX, "seq %lu expired undelivered", (unsigned long)head.seq);
+    popHead();
+    store.expired++;
+    changed = true;
+  }
+
+  for (int i = 0; i < store.count; i++) {
+    OutboxEntry& entry = entryAt(i);
+    int64_t sysMs = nowSysMs - (nowUs - entry.pressUs) / 1000;
+    if (sysMs != entry.sysMs) {
+      entry.sysMs = sysMs;
+      changed = true;
+    }
+  }
+
+  if (changed) sealStore();
+}
+
+static void publishStats() {
+  char payload[160];
+  int written = snprintf(payload, sizeof(payload),
+                         "{\"pending\":%d,\"delivered\":%lu,\"expired\":%lu,\"overflow\":%lu,\"retries\":%lu",
+                         store.count, (unsigned long)store.delivered, (unsigned long)store.expired,
+                         (unsigned long)store.overflow, (unsigned long)store.retries);
+  if (latencyCount > 0 && written > 0 && (size_t)written < sizeof(payload)) {
+    written += snprintf(payload + written, sizeof(payload) - written, ",\"lat_ms\":[%lu,%lu,%lu]",
+                        (unsigned long)latencyMin, (unsigned long)(latencySum / latencyCount),
+                        (unsigned long)latencyMax);
+  }
+  if (written <= 0 || (size_t)written + 2 > sizeof(payload)) return;
+  strcat(payload, "}");
+
+  if (publishOutboxStats(payload)) {
+    latencyCount = 0;
+    latencySum = 0;
+  }
+}
+
+void outboxLoop() {
+  expireEntries();
+
+  unsigned long currentTime = millis();
+  if (store.count > 0 && isMqttConnected() &&
+      (!headSent || currentTime - lastSendTime >= OUTBOX_RETRY_INTERVAL)) {
+    OutboxEntry& head = entryAt(0);
+    if (headSent) {
+      store.retries++;
+      sealStore();
+    }
+    // Neúspešný publish sa ráta ako odoslaný – ďalší pokus až po retry intervale
+    ButtonEvent event = {head.pressUs, head.input, head.gesture};
+    publishButtonAction(event, head.seq);
+    headSent = true;
+    lastSendTime = currentTime;
+  }
+
+  if (currentTime - lastStatsTime >= OUTBOX_STATS_INTERVAL && isMqttConnected()) {
+    publishStats();
+    lastStatsTime = currentTime;
+  }
+}
+
+void outboxAcknowledge(uint32_t seq) {
+  // Posiela sa iba čelo fronty, iný seq = oneskorený duplikátny ack
+  if (store.count == 0 || entryAt(0).seq != seq) return;
+
+  uint32_t latencyMs = (uint32_t)((esp_timer_get_time() - entryAt(0).pressUs) / 1000);
+  if (latencyCount == 0 || latencyMs < latencyMin) latencyMin = latencyMs;
+  if (latencyCount == 0 || latencyMs > latencyMax) latencyMax = latencyMs;
+  latencySum += latencyMs;
+  latencyCount++;
+
+  popHead();
+  store.delivered++;
+  sealStore();
+
+  LOGR_INFO(OUTBOX, "seq %lu delivered after %lu ms", (unsigned long)seq, (unsigned long)latencyMs);
+}
+
+void outboxResend() {
+  headSent = false;
+}
+
+int outboxPending() {
+  return store.count;
+}
@@ -0,0 +1,27 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <stdint.h>
+#include "hardware.h"
+
+// Outbox triggerov v RTC pamäti – prežije WDT / softvérový reset, nie vypnutie napájania.
+// Doručenie "aspoň raz": trigger nesie poradové číslo, backend ho potvrdí na
+// <prefix><topic>/ack a kým ack nepríde, posiela sa znova každých OUTBOX_RETRY_INTERVAL.
+// Udalosti staršie ako OUTBOX_MAX_AGE_MS sa zahodia (scéna by štartovala pre nikoho).
+void initializeOutbox();
+
+// Zaradí rozpoznané gesto (plná fronta = zahodí najstaršie)
+void outboxPush(const ButtonEvent& event);
+
+// Volať v každom prechode loop(): expirácia, (re)transmisia, štatistiky
+void outboxLoop();
+
+// Ack z backendu (payload ACK:<seq>)
+void outboxAcknowledge(uint32_t seq);
+
+// Po (re)connecte poslať čakajúci trigger hneď, nie až po retry intervale
+void outboxResend();
+
+int outboxPending();
+
+#endif
@@ -0,0 +1,198 @@
+#include "power_manager.h"
+#include "config.h"
+#include "debug.h"
+#include "hardware.h"
+#include "led_manager.h"
+#include "wifi_manager.h"
+#include "mqtt_manager.h"
+#include "ota_manager.h"
+#include "outbox.h"
+#include "wdt_manager.h"
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+struct LatencyStat {
+  uint32_t minMs;
+  uint32_t maxMs;
+  uint32_t sumMs;
+  uint32_t count;
+};
+
+static void addLatency(LatencyStat& stat, uint32_t ms) {
+  if (stat.count == 0 || ms < stat.minMs) stat.minMs = ms;
+  if (stat.count == 0 || ms > stat.maxMs) stat.maxMs = ms;
+  stat.sumMs += ms;
+  stat.count++;
+}
+
+// Appends ,"<key>":[min,avg,max] – nothing if the window is empty
+static int appendLatency(char* out, size_t size, const char* key, const LatencyStat& stat) {
+  if (stat.count == 0 || size == 0) return 0;
+  int written = snprintf(out, size, ",\"%s\":[%lu,%lu,%lu]", key, (unsigned long)stat.minMs,
+                         (unsigned long)(stat.sumMs / stat.count), (unsigned long)stat.maxMs);
+  return (written < 0 || (size_t)written >= size) ? 0 : written;
+}
+
+// Aktuálne prebudenie
+static unsigned long awakeSince = 0;       // millis() prebudenia (alebo bootu)
+static unsigned long lastActivity = 0;
+static unsigned long awakeWindow = 0;      // Minimálny čas hore od lastActivity
+static int64_t wakeUs = 0;
+static bool pressWake = false;
+static bool publishPending = false;        // Čaká sa na prvý publish po prebudení tlačidlom
+
+// Kumulatívne od bootu – model spotreby
+static uint64_t sleepMsTotal = 0;
+static uint64_t awakeMsTotal = 0;
+static uint64_t pressAwakeMsTotal = 0;
+static uint32_t wakes = 0;
+static uint32_t pressWakes = 0;
+static uint32_t fastJoinFails = 0;
+
+// Okno štatistík
+static LatencyStat wakeToPublish = {};
+static LatencyStat joinTime = {};
+static unsigned long lastStatsTime = 0;
+
+void notePowerActivity() {
+  lastActivity = millis();
+}
+
+void powerNoteTriggerPublished() {
+  if (!BATTERY_MODE || !publishPending) return;
+  publishPending = false;
+
+  uint32_t latencyMs = (uint32_t)((esp_timer_get_time() - wakeUs) / 1000);
+  addLatency(wakeToPublish, latencyMs);
+  LOGR_INFO(POWER, "wake-to-publish %lu ms", (unsigned long)latencyMs);
+}
+
+// Priemerný prúd z času v spánku / hore a konfigurovaných prúdov (odhad, nie meranie)
+static uint32_t averageCurrentUa() {
+  uint64_t totalMs = sleepMsTotal + awakeMsTotal;
+  if (totalMs == 0) return 0;
+  uint64_t chargeUaMs = sleepMsTotal * BATTERY_SLEEP_CURRENT_UA +
+                        awakeMsTotal * BATTERY_ACTIVE_CURRENT_MA * 1000;
+  return (uint32_t)(chargeUaMs / totalMs);
+}
+
+static void publishStats() {
+  char payload[256];
+  size_t size = sizeof(payload);
+  int written = snprintf(payload, size,
+                         "{\"wakes\":%lu,\"press_wakes\":%lu,\"fast_join_fail\":%lu,\"awake_pct\":%.2f,\"avg_ua\":%lu",
+                         (unsigned long)wakes, (unsigned long)pressWakes, (unsigned long)fastJoinFails,
+                         (sleepMsTotal + awakeMsTotal) > 0
+                             ? 100.0 * awakeMsTotal / (double)(sleepMsTotal + awakeMsTotal) : 0.0,
+                         (unsigned long)averageCurrentUa());
+  if (written <= 0 || (size_t)written >= size) return;
+
+  // Náboj na jedno stlačenie: čas hore po prebudení tlačidlom × BATTERY_ACTIVE_CURRENT_MA
+  if (pressWakes > 0) {
+    double masPerPress = (double)pressAwakeMsTotal * BATTERY_ACTIVE_CURRENT_MA / 1000.0 / pressWakes;
+    int n = snprintf(payload + written, size - written, ",\"mas_per_press\":%.1f", masPerPress);
+    if (n > 0 && (size_t)n < size - written) written += n;
+  }
+  written += appendLatency(payload + written, size - written, "wake_pub_ms", wakeToPublish);
+  written += appendLatency(payload + written, size - written, "join_ms", joinTime);
+  if ((size_t)written + 2 > size) return;
+  strcat(payload, "}");
+
+  if (publishPowerStats(payload)) {
+    wakeToPublish = LatencyStat{};
+    joinTime = LatencyStat{};
+  }
+}
+
+void initializePowerManager() {
+  if (!BATTERY_MODE) return;
+
+  // Po zapnutí napájania ostane hore BATTERY_BOOT_AWAKE_MS (OTA, diagnostika)
+  awakeSince = millis();
+  lastActivity = awakeSince;
+  awakeWindow = BATTERY_BOOT_AWAKE_MS;
+  wakeUs = esp_timer_get_time();
+
+  if (wifiConnected) {
+    saveWiFiLink();
+    connectMqttNow();
+  }
+  LOG_INFO(POWER, "battery mode, first sleep in " + String(BATTERY_BOOT_AWAKE_MS / 1000) + " s");
+}
+
+// Pripojenie po prebudení – všetko blokujúce, stlačenie už zachytil debounce task
+static void reconnectAfterWake() {
+  int64_t joinStartUs = esp_timer_get_time();
+  if (!connectWiFiFast(BATTERY_JOIN_TIMEOUT)) {
+    LOG_WARN(POWER, "WiFi join failed");
+    return;
+  }
+  if (!lastJoinWasFast()) fastJoinFails++;
+  addLatency(joinTime, (uint32_t)((esp_timer_get_time() - joinStartUs) / 1000));
+
+  connectMqttNow();
+}
+
+static void sleepUntilWake() {
+  // Spojenie čisto ukončiť – broker nepošle LWT, status drží heartbeat
+  if (isMqttConnected() && millis() - lastStatsTime >= POWER_STATS_INTERVAL) {
+    publishStats();
+    lastStatsTime = millis();
+  }
+  disconnectMqtt();
+  shutdownWiFi();
+  turnOffLED();  // LEDC v light sleep stojí – LED by ostala zamrznutá v aktuálnom jase
+
+  unsigned long awakeMs = millis() - awakeSince;
+  awakeMsTotal += awakeMs;
+  if (pressWake) pressAwakeMsTotal += awakeMs;
+
+  // Nedoručený trigger: skoré prebudenie na ďalší pokus, inak heartbeat
+  unsigned long timerMs = outboxPending() > 0 ? BATTERY_RETRY_WAKE_MS : BATTERY_HEARTBEAT_INTERVAL;
+  if (timerMs > 0) {
+    esp_sleep_enable_timer_wakeup((uint64_t)timerMs * 1000);
+  }
+  armButtonWake();
+  esp_sleep_enable_gpio_wakeup();
+
+  LOG_INFO(POWER, "sleeping after " + String(awakeMs) + " ms awake");
+  Serial.flush();
+  resetWatchdog();  // TWDT počas light sleep nebeží (APB hodiny stojí)
+
+  int64_t sleepStartUs = esp_timer_get_time();
+  esp_light_sleep_start();
+  wakeUs = esp_timer_get_time();
+
+  esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  pressWake = cause == ESP_SLEEP_WAKEUP_GPIO;
+  disarmButtonWake(pressWake, wakeUs);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  resetWatchdog();
+
+  sleepMsTotal += (uint64_t)((wakeUs - sleepStartUs) / 1000);
+  wakes++;
+  if (pressWake) pressWakes++;
+  publishPending = pressWake;
+
+  awakeSince = millis();
+  lastActivity = awakeSince;
+  awakeWindow = BATTERY_AWAKE_WINDOW_MS;
+  LOGR_INFO(POWER, "woken by %s", pressWake ? "button" : "timer");
+
+  reconnectAfterWake();
+}
+
+void powerManagerLoop() {
+  if (!BATTERY_MODE || isOTAInProgress()) return;
+
+  unsigned long currentTime = millis();
+  bool windowOver = currentTime - lastActivity >= awakeWindow;
+  bool delivered = outboxPending() == 0;
+  bool giveUp = currentTime - awakeSince >= max(BATTERY_MAX_AWAKE_MS, awakeWindow);
+
+  if (!giveUp && !(windowOver && delivered)) return;
+  if (!isButtonIdle()) return;  // Držané tlačidlo by hneď prebudilo, stlačenie v debounce by sa oneskorilo
+
+  sleepUntilWake();
+}
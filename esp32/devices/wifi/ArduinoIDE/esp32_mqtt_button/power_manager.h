@@ -0,0 +1,19 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+// Battery mode (BATTERY_MODE): medzi stlačeniami light sleep s vypnutou WiFi.
+// Prebudí tlačidlo (úroveň LOW) alebo časovač (heartbeat / nedoručený trigger),
+// potom rýchle pripojenie z cache, publish, ack a späť do spánku.
+// Bez BATTERY_MODE sú všetky funkcie prázdne.
+void initializePowerManager();
+
+// Volať na konci loop(): rozhodne o spánku a obslúži prebudenie
+void powerManagerLoop();
+
+// Stlačenie / prichádzajúca správa predĺži okno BATTERY_AWAKE_WINDOW_MS
+void notePowerActivity();
+
+// Prvý úspešný publish triggeru po prebudení tlačidlom – latencia prebudenie → publish
+void powerNoteTriggerPublished();
+
+#endif
@@ -6,8 +6,22 @@
 bool wifiConnected = false;
 unsigned long lastWifiAttempt = 0;
 
+// Posledné úspešné spojenie – RTC pamäť, po vypnutí napájania sa začína plným pripojením
+struct WiFiLinkCache {
+  bool valid;
+  uint8_t channel;
+  uint8_t bssid[6];
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+RTC_DATA_ATTR static WiFiLinkCache linkCache = {};
+static bool fastJoin = false;
+
 bool initializeWiFi() {
-  debugPrint("Connecting to WiFi: " + String(WIFI_SSID));
+  LOG_INFO(WIFI, "Connecting to WiFi: " + String(WIFI_SSID));
   WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
@@ -20,14 +34,14 @@ bool initializeWiFi() {
   if (WiFi.status() == WL_CONNECTED) {
     Serial.print("WiFi connected - IP: ");
     Serial.println(WiFi.localIP());
-    debugPrint("WiFi connected: " + WiFi.localIP().toString());
+    LOG_INFO(WIFI, "WiFi connected: " + WiFi.localIP().toString());
     wifiConnected = true;
     lastWifiAttempt = 0;
     return true;
   }
 
   wifiConnected = false;
-  debugPrint("WiFi connection failed");
+  LOG_WARN(WIFI, "WiFi connection failed");
   return false;
 }
 
@@ -37,7 +51,7 @@ void reconnectWiFi() {
   static unsigned long wifiRetryInterval = WIFI_RETRY_INTERVAL;
 
   if (WiFi.status() != WL_CONNECTED && (currentTime - lastWifiAttempt >= wifiRetryInterval)) {
-    debugPrint("WiFi reconnect attempt " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
+    LOG_INFO(WIFI, "WiFi reconnect attempt " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
     lastWifiAttempt = currentTime;
     wifiAttempts++;
 
@@ -46,15 +60,15 @@ void reconnectWiFi() {
 
     if (initializeWiFi()) {
       Serial.println("WiFi reconnected");
-      debugPrint("WiFi reconnected successfully");
+      LOG_INFO(WIFI, "WiFi reconnected successfully");
       wifiAttempts = 0;
       wifiRetryInterval = WIFI_RETRY_INTERVAL;
     } else {
       wifiRetryInterval = min(wifiRetryInterval * 2, MAX_RETRY_INTERVAL);
-      debugPrint("WiFi failed - retry in " + String(wifiRetryInterval) + "ms");
+      LOG_WARN(WIFI, "WiFi failed - retry in " + String(wifiRetryInterval) + "ms");
 
       if (wifiAttempts >= MAX_WIFI_ATTEMPTS) {
-        debugPrint("Max WiFi attempts - restarting");
+        LOGR_ERROR(WIFI, "Max WiFi attempts - restarting");   // Vypíše sa po reštarte z ringu
         ESP.restart();
       }
     }
@@ -63,4 +77,66 @@ void reconnectWiFi() {
 
 bool isWiFiConnected() {
   return WiFi.status() == WL_CONNECTED;
-}
\ No newline at end of file
+}
+
+static bool waitForWiFi(unsigned long startTime, unsigned long timeoutMs) {
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - startTime >= timeoutMs) return false;
+    delay(5);
+  }
+  return true;
+}
+
+bool connectWiFiFast(unsigned long timeoutMs) {
+  unsigned long startTime = millis();
+  WiFi.mode(WIFI_STA);
+  fastJoin = false;
+
+  if (linkCache.valid) {
+    WiFi.config(IPAddress(linkCache.ip), IPAddress(linkCache.gateway),
+                IPAddress(linkCache.subnet), IPAddress(linkCache.dns));
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, linkCache.channel, linkCache.bssid);
+    fastJoin = waitForWiFi(startTime, timeoutMs / 2);
+    if (!fastJoin) {
+      // AP zmenil kanál alebo IP už nie je naša – ďalej cez sken a DHCP
+      LOG_WARN(WIFI, "WiFi fast join failed, falling back to full join");
+      linkCache.valid = false;
+      WiFi.disconnect();
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+  }
+
+  if (!fastJoin) {
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    if (!waitForWiFi(startTime, timeoutMs)) {
+      wifiConnected = false;
+      return false;
+    }
+  }
+
+  wifiConnected = true;
+  saveWiFiLink();
+  return true;
+}
+
+void saveWiFiLink() {
+  if (WiFi.status() != WL_CONNECTED) return;
+
+  linkCache.channel = WiFi.channel();
+  memcpy(linkCache.bssid, WiFi.BSSID(), sizeof(linkCache.bssid));
+  linkCache.ip = (uint32_t)WiFi.localIP();
+  linkCache.gateway = (uint32_t)WiFi.gatewayIP();
+  linkCache.subnet = (uint32_t)WiFi.subnetMask();
+  linkCache.dns = (uint32_t)WiFi.dnsIP();
+  linkCache.valid = true;
+}
+
+void shutdownWiFi() {
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+  wifiConnected = false;
+}
+
+bool lastJoinWasFast() {
+  return fastJoin;
+}
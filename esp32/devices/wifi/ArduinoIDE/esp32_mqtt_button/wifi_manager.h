@@ -8,6 +8,13 @@ bool initializeWiFi();
 void reconnectWiFi();
 bool isWiFiConnected();
 
+// Battery mode: pripojenie s uloženým kanálom, BSSID a IP (bez skenu a DHCP),
+// pri neúspechu jeden plný pokus v zostávajúcom čase
+bool connectWiFiFast(unsigned long timeoutMs);
+void saveWiFiLink();
+void shutdownWiFi();
+bool lastJoinWasFast();
+
 // WiFi state
 extern bool wifiConnected;
 extern unsigned long lastWifiAttempt;
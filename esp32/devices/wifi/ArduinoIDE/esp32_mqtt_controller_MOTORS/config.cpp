@@ -1,8 +1,5 @@
 #include "config.h"
 
-// Debug Mode
-const bool DEBUG = true;
-
 // WiFi Configuration
 
 // Router 1
@@ -19,6 +16,9 @@ const int MQTT_PORT = 1883;
 const char* BASE_TOPIC_PREFIX = "room1/";
 const char* CLIENT_ID = "Room1_ESP_Motory";
 
+// SNTP (only for TRAJ:START:@<unixMs>, "" = disabled)
+const char* NTP_SERVER = "pool.ntp.org";
+
 // Hardware - PWM Motors Only
 const int MOTOR1_LEFT_PIN = 18;
 const int MOTOR1_RIGHT_PIN = 19;
@@ -34,6 +34,67 @@ const int PWM_RESOLUTION = 8;
 // Smooth Motor Control Settings
 const int SMOOTH_STEP = 2;
 const int SMOOTH_DELAY = 100;
+const unsigned long TIMING_MISS_US = 20000;           // Ramp step later than this = deadline miss
+const unsigned long TIMING_PUBLISH_INTERVAL = 60000;  // devices/<id>/timing, 0 = off
+
+// Encoder / Closed-loop Speed Control
+// A only = single tach line, A + B = quadrature. Free inputs e.g. 32/33, 34/35.
+const int MOTOR1_ENCODER_A_PIN = -1;
+const int MOTOR1_ENCODER_B_PIN = -1;
+const int MOTOR2_ENCODER_A_PIN = -1;
+const int MOTOR2_ENCODER_B_PIN = -1;
+const int ENCODER_COUNTS_PER_REV = 1200;     // PCNT counts per output shaft revolution (x4 for quadrature)
+const float MOTOR_MAX_RPM = 60.0;            // RPM that corresponds to speed 100
+const unsigned long SPEED_LOOP_INTERVAL_MS = 10;
+const float SPEED_KP = 0.8;                  // % duty per RPM of error
+const float SPEED_KI = 4.0;
+const float SPEED_KD = 0.0;
+const float SPEED_FILTER_ALPHA = 0.3;        // Low-pass on measured RPM (1.0 = no filter)
+const unsigned long SPEED_PUBLISH_INTERVAL = 1000; // room1/motorN/speed, 0 = off
+
+// Position / Homing (MOVE / HOME)
+// End-stop or index input per motor, -1 = not wired (HOME falls back to dead-reckoning)
+const int MOTOR1_HOME_PIN = -1;
+const int MOTOR2_HOME_PIN = -1;
+const int HOME_PIN_ACTIVE_LEVEL = LOW;       // Switch to GND with internal pull-up
+const int MOTION_SPEED = 40;                 // Default MOVE speed (%), also the dead-reckoning unit
+const int MOTION_APPROACH_SPEED = 15;        // Speed inside the slowdown zone
+const long MOTION_SLOWDOWN_COUNTS = 300;     // Slowdown zone with encoder
+const long MOTION_SLOWDOWN_MS = 1500;        // Slowdown zone without encoder (ms at MOTION_SPEED)
+const long MOTION_TOLERANCE_COUNTS = 5;
+const int HOMING_SPEED = 25;
+const char HOMING_DIRECTION = 'L';
+const unsigned long HOMING_TIMEOUT = 60000;
+
+// Stop modes – OFF without a mode uses OFF_STOP_MODE, room1/STOP uses STOP_TOPIC_MODE
+const StopMode OFF_STOP_MODE = STOP_MODE_RAMP;
+const StopMode STOP_TOPIC_MODE = STOP_MODE_COAST;
+const int STOP_RAMP_MAX_DECEL = 0;           // %/s for RAMP, 0 = SMOOTH_STEP per SMOOTH_DELAY
+const int STOP_BRAKE_MAX_DECEL = 0;          // %/s ramp-down before the brake engages, 0 = brake at once
+const unsigned long BRAKE_RELEASE_MS = 500;  // BRAKE_RELEASE hold time
+const float STANDSTILL_RPM = 0.5;            // Encoder only: below this the motor counts as stopped
+const unsigned long STANDSTILL_TIMEOUT = 10000;
+
+// Current Sensing – driver sense output (e.g. BTS7960 IS pin) on an ADC1 input (GPIO 32-39)
+const int MOTOR1_CURRENT_PIN = -1;
+const int MOTOR2_CURRENT_PIN = -1;
+const float CURRENT_AMPS_PER_VOLT = 8.5;     // BTS7960: kILIS 8500 with 1 kOhm IS resistor
+const uint32_t CURRENT_SAMPLE_FREQ_HZ = 20000; // Total ADC rate, 20 conversions/pin per DMA frame
+const float CURRENT_FILTER_ALPHA = 0.2;
+const float STALL_AMPS = 6.0;                // Sustained current (+ no rotation with encoder) = stall
+const unsigned long STALL_TIME_MS = 300;
+const float OVERCURRENT_AMPS = 12.0;
+const unsigned long OVERCURRENT_TIME_MS = 20;
+const StopMode CURRENT_FAULT_STOP_MODE = STOP_MODE_RAMP;
+const int CURRENT_FAULT_MAX_DECEL = 400;      // %/s for the fault stop ramp (100 % -> 0 in 250 ms)
+const unsigned long CURRENT_PUBLISH_INTERVAL = 1000; // room1/motorN/current min/avg/max, 0 = off
+
+// Telemetry – window length also settable at runtime with TELEMETRY:<ms>
+const unsigned long TELEMETRY_INTERVAL = 0;          // Publish window in ms, 0 = off until TELEMETRY:<ms>
+const unsigned long TELEMETRY_SAMPLE_INTERVAL = 50;  // Aggregation sample period
+const unsigned long TELEMETRY_SLOW_PUBLISH_MS = 20;  // Slower publish() = TCP buffer backing up
+const int TELEMETRY_MAX_BACKOFF = 8;                 // Max window multiplier while backed off
+const int TELEMETRY_RECOVER_COUNT = 5;               // Good publishes before halving the backoff
 
 // Connection Management Settings
 const unsigned long WIFI_RETRY_INTERVAL = 3000;
@@ -46,8 +107,17 @@ const int MAX_MQTT_ATTEMPTS = 3;
 const int MQTT_KEEP_ALIVE = 5;
 const unsigned long NO_COMMAND_TIMEOUT = 180000;
 
+// Task / heap diagnostics: limits raise devices/<id>/diag/warn (0 = no check)
+const unsigned long DIAG_CHECK_INTERVAL = 10000;
+const unsigned long DIAG_REPORT_INTERVAL = 300000;  // Full report, 0 = on request only (diag/get)
+const uint32_t DIAG_MIN_FREE_HEAP = 20000;          // bytes
+const uint8_t DIAG_MAX_FRAGMENTATION = 70;          // %
+const uint32_t DIAG_MIN_STACK_FREE = 512;           // bytes per task
+const uint8_t DIAG_MAX_TASK_CPU = 80;               // % of a core, IDLE excluded
+
 // Watchdog Timer Configuration 
 const unsigned long WDT_TIMEOUT = 60;
+const unsigned long STAGE_WDT_CHECK_MS = 100;   // loop() stage budget check (budgets in the .ino)
 
 // OTA Configuration
 const char* OTA_HOSTNAME = "ESP32-Museum-Room1";
@@ -6,8 +6,22 @@
 // Configuration Constants
 // -----------------------------------------------------------------------------
 
-// Debug
-extern const bool DEBUG;
+// Logging (museum_log.h) – compile-time: a disabled level is not compiled, arguments included
+#define LOG_LEVEL LOG_LEVEL_DEBUG        // Release: LOG_LEVEL_WARN
+#define LOG_MODULE_MAIN      LOG_LEVEL
+#define LOG_MODULE_HW        LOG_LEVEL
+#define LOG_MODULE_MQTT      LOG_LEVEL
+#define LOG_MODULE_WIFI      LOG_LEVEL
+#define LOG_MODULE_OTA       LOG_LEVEL
+#define LOG_MODULE_WDT       LOG_LEVEL
+#define LOG_MODULE_CONN      LOG_LEVEL
+#define LOG_MODULE_MOTION    LOG_LEVEL
+#define LOG_MODULE_SPEED     LOG_LEVEL
+#define LOG_MODULE_SYNC      LOG_LEVEL
+#define LOG_MODULE_TRAJ      LOG_LEVEL
+#define LOG_MODULE_TELEMETRY LOG_LEVEL
+#define LOG_MODULE_ENCODER   LOG_LEVEL
+#define LOG_MODULE_CURRENT   LOG_LEVEL
 
 // WiFi
 extern const char* WIFI_SSID;
@@ -19,6 +33,9 @@ extern const int MQTT_PORT;
 extern const char* BASE_TOPIC_PREFIX;
 extern const char* CLIENT_ID;
 
+// SNTP (only for TRAJ:START:@<unixMs>, "" = disabled)
+extern const char* NTP_SERVER;
+
 // Hardware - PWM Motors Only
 extern const int MOTOR1_LEFT_PIN;
 extern const int MOTOR1_RIGHT_PIN;
@@ -34,6 +51,71 @@ extern const int PWM_RESOLUTION;
 // Smooth Motor Control Settings
 extern const int SMOOTH_STEP;
 extern const int SMOOTH_DELAY;
+extern const unsigned long TIMING_MISS_US;
+extern const unsigned long TIMING_PUBLISH_INTERVAL;
+
+// Encoder / Closed-loop Speed Control (-1 = not wired, motor stays open-loop)
+extern const int MOTOR1_ENCODER_A_PIN;
+extern const int MOTOR1_ENCODER_B_PIN;
+extern const int MOTOR2_ENCODER_A_PIN;
+extern const int MOTOR2_ENCODER_B_PIN;
+extern const int ENCODER_COUNTS_PER_REV;
+extern const float MOTOR_MAX_RPM;
+extern const unsigned long SPEED_LOOP_INTERVAL_MS;
+extern const float SPEED_KP;
+extern const float SPEED_KI;
+extern const float SPEED_KD;
+extern const float SPEED_FILTER_ALPHA;
+extern const unsigned long SPEED_PUBLISH_INTERVAL;
+
+// Position / Homing (MOVE / HOME)
+extern const int MOTOR1_HOME_PIN;
+extern const int MOTOR2_HOME_PIN;
+extern const int HOME_PIN_ACTIVE_LEVEL;
+extern const int MOTION_SPEED;
+extern const int MOTION_APPROACH_SPEED;
+extern const long MOTION_SLOWDOWN_COUNTS;
+extern const long MOTION_SLOWDOWN_MS;
+extern const long MOTION_TOLERANCE_COUNTS;
+extern const int HOMING_SPEED;
+extern const char HOMING_DIRECTION;
+extern const unsigned long HOMING_TIMEOUT;
+
+// Stop modes (OFF / STOP)
+enum StopMode {
+  STOP_MODE_COAST,          // Bridge disabled, mechanism freewheels
+  STOP_MODE_RAMP,           // Drive ramps down to 0 (SMOOTH_STEP or STOP_RAMP_MAX_DECEL)
+  STOP_MODE_BRAKE,          // Short brake (both legs driven), held until next command
+  STOP_MODE_BRAKE_RELEASE   // Short brake for BRAKE_RELEASE_MS, then coast
+};
+extern const StopMode OFF_STOP_MODE;
+extern const StopMode STOP_TOPIC_MODE;
+extern const int STOP_RAMP_MAX_DECEL;
+extern const int STOP_BRAKE_MAX_DECEL;
+extern const unsigned long BRAKE_RELEASE_MS;
+extern const float STANDSTILL_RPM;
+extern const unsigned long STANDSTILL_TIMEOUT;
+
+// Current Sensing (ADC continuous mode, -1 = not wired)
+extern const int MOTOR1_CURRENT_PIN;
+extern const int MOTOR2_CURRENT_PIN;
+extern const float CURRENT_AMPS_PER_VOLT;
+extern const uint32_t CURRENT_SAMPLE_FREQ_HZ;
+extern const float CURRENT_FILTER_ALPHA;
+extern const float STALL_AMPS;
+extern const unsigned long STALL_TIME_MS;
+extern const float OVERCURRENT_AMPS;
+extern const unsigned long OVERCURRENT_TIME_MS;
+extern const StopMode CURRENT_FAULT_STOP_MODE;
+extern const int CURRENT_FAULT_MAX_DECEL;
+extern const unsigned long CURRENT_PUBLISH_INTERVAL;
+
+// Telemetry (room1/motorN/telemetry)
+extern const unsigned long TELEMETRY_INTERVAL;
+extern const unsigned long TELEMETRY_SAMPLE_INTERVAL;
+extern const unsigned long TELEMETRY_SLOW_PUBLISH_MS;
+extern const int TELEMETRY_MAX_BACKOFF;
+extern const int TELEMETRY_RECOVER_COUNT;
 
 // Connection Management
 extern const unsigned long WIFI_RETRY_INTERVAL;
@@ -46,8 +128,17 @@ extern const int MAX_MQTT_ATTEMPTS;
 extern const int MQTT_KEEP_ALIVE;
 extern const unsigned long NO_COMMAND_TIMEOUT;
 
+// Task / heap diagnostics (devices/<id>/diag)
+extern const unsigned long DIAG_CHECK_INTERVAL;
+extern const unsigned long DIAG_REPORT_INTERVAL;
+extern const uint32_t DIAG_MIN_FREE_HEAP;
+extern const uint8_t DIAG_MAX_FRAGMENTATION;
+extern const uint32_t DIAG_MIN_STACK_FREE;
+extern const uint8_t DIAG_MAX_TASK_CPU;
+
 // Watchdog Timer Configuration
 extern const unsigned long WDT_TIMEOUT;
+extern const unsigned long STAGE_WDT_CHECK_MS;
 
 extern const char* OTA_HOSTNAME;
 extern const char* OTA_PASSWORD;
@@ -0,0 +1,198 @@
+#include "current_sense.h"
+#include "config.h"
+#include "debug.h"
+#include "hardware.h"
+#include "motion_control.h"
+#include "mqtt_manager.h"
+#include "speed_control.h"
+#include "trajectory.h"
+#include "sync_control.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Below the speed loop (5), above the Arduino loop task (1)
+static const UBaseType_t CURRENT_TASK_PRIORITY = 4;
+static const BaseType_t CURRENT_TASK_CORE = 1;
+static const uint32_t CURRENT_TASK_STACK = 3072;
+
+// Every DMA frame holds this many conversions per pin, averaged by the driver
+static const uint32_t CONVERSIONS_PER_PIN = 20;
+
+enum CurrentFault {
+  FAULT_NONE,
+  FAULT_STALL,
+  FAULT_OVERCURRENT
+};
+
+struct CurrentChannel {
+  int pin;
+  float amps;                        // Filtered, written only by the task
+  unsigned long stallSince;          // 0 = below STALL_AMPS
+  unsigned long overcurrentSince;    // 0 = below OVERCURRENT_AMPS
+  volatile CurrentFault pendingFault;  // Task -> loop()
+
+  // Telemetry window, guarded by windowMux
+  float windowMin;
+  float windowMax;
+  float windowSum;
+  uint32_t windowCount;
+};
+
+static CurrentChannel channels[2] = {};
+static portMUX_TYPE windowMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t currentTaskHandle = nullptr;
+
+static const char* faultName(CurrentFault fault) {
+  return (fault == FAULT_OVERCURRENT) ? "OVERCURRENT" : "STALL";
+}
+
+// ADC driver callback when a DMA frame is complete (ISR context)
+static void ARDUINO_ISR_ATTR onCurrentFrame() {
+  BaseType_t woken = pdFALSE;
+  if (currentTaskHandle != nullptr) {
+    vTaskNotifyGiveFromISR(currentTaskHandle, &woken);
+  }
+  portYIELD_FROM_ISR(woken);
+}
+
+// Time above a threshold; returns true once it lasted at least holdMs
+static bool aboveFor(bool above, unsigned long& since, unsigned long now, unsigned long holdMs) {
+  if (!above) {
+    since = 0;
+    return false;
+  }
+  if (since == 0) since = now;
+  return now - since >= holdMs;
+}
+
+static void processSample(int motorNum, int millivolts, unsigned long now) {
+  CurrentChannel& ch = channels[motorNum - 1];
+
+  float rawAmps = millivolts / 1000.0f * CURRENT_AMPS_PER_VOLT;
+  ch.amps += CURRENT_FILTER_ALPHA * (rawAmps - ch.amps);
+
+  portENTER_CRITICAL(&windowMux);
+  if (ch.windowCount == 0 || ch.amps < ch.windowMin) ch.windowMin = ch.amps;
+  if (ch.windowCount == 0 || ch.amps > ch.windowMax) ch.windowMax = ch.amps;
+  ch.windowSum += ch.amps;
+  ch.windowCount++;
+  portEXIT_CRITICAL(&windowMux);
+
+  // Only a driven motor can stall; a short brake legitimately spikes the current
+  const MotorState& state = getMotorState(motorNum);
+  bool driven = state.enabled && state.targetSpeed > 0 && state.currentSpeed > 0 && !isMotorBraking(motorNum);
+  if (!driven || ch.pendingFault != FAULT_NONE) {
+    ch.stallSince = 0;
+    ch.overcurrentSince = 0;
+    return;
+  }
+
+  // With an encoder a stall also needs the shaft to be (nearly) stopped
+  bool stalled = ch.amps >= STALL_AMPS &&
+                 (!isClosedLoop(motorNum) || getMeasuredRpm(motorNum) < STANDSTILL_RPM);
+
+  if (aboveFor(ch.amps >= OVERCURRENT_AMPS, ch.overcurrentSince, now, OVERCURRENT_TIME_MS)) {
+    ch.pendingFault = FAULT_OVERCURRENT;
+  } else if (aboveFor(stalled, ch.stallSince, now, STALL_TIME_MS)) {
+    ch.pendingFault = FAULT_STALL;
+  }
+}
+
+static void currentSenseTask(void* parameter) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    adc_continuous_data_t* result = nullptr;
+    if (!analogContinuousRead(&result, 0)) continue;
+
+    unsigned long now = millis();
+    int index = 0;
+    for (int motorNum = 1; motorNum <= 2; motorNum++) {
+      if (channels[motorNum - 1].pin < 0) continue;
+      processSample(motorNum, result[index].avg_read_mvolts, now);
+      index++;
+    }
+  }
+}
+
+void initializeCurrentSense() {
+  channels[0].pin = MOTOR1_CURRENT_PIN;
+  channels[1].pin = MOTOR2_CURRENT_PIN;
+
+  uint8_t pins[2];
+  size_t pinCount = 0;
+  for (int i = 0; i < 2; i++) {
+    if (channels[i].pin >= 0) pins[pinCount++] = channels[i].pin;
+  }
+
+  if (pinCount == 0) {
+    LOG_INFO(CURRENT, "no inputs configured");
+    return;
+  }
+
+  // Task must exist before the first DMA frame notifies it
+  xTaskCreatePinnedToCore(currentSenseTask, "current_sense", CURRENT_TASK_STACK, nullptr,
+                          CURRENT_TASK_PRIORITY, &currentTaskHandle, CURRENT_TASK_CORE);
+
+  // 11 dB attenuation: full 0–3.1 V range of the sense output
+  analogContinuousSetAtten(ADC_11db);
+  if (!analogContinuous(pins, pinCount, CONVERSIONS_PER_PIN, CURRENT_SAMPLE_FREQ_HZ, &onCurrentFrame) ||
+      !analogContinuousStart()) {
+    LOG_WARN(CURRENT, "ADC continuous mode failed (ADC1 pins 32-39 only)");
+    vTaskDelete(currentTaskHandle);
+    currentTaskHandle = nullptr;
+    channels[0].pin = -1;
+    channels[1].pin = -1;
+    return;
+  }
+
+  LOG_INFO(CURRENT, "" + String(pinCount) + " input(s) at " + String(CURRENT_SAMPLE_FREQ_HZ) + " Hz");
+}
+
+void updateCurrentSense() {
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    CurrentChannel& ch = channels[motorNum - 1];
+    CurrentFault fault = ch.pendingFault;
+    if (fault == FAULT_NONE) continue;
+
+    LOGR_ERROR(CURRENT, "Motor%d %s at %.2fA - stopping", motorNum, faultName(fault), ch.amps);
+
+    // Motion modes would otherwise re-drive the motor straight back into the jam
+    cancelSync();
+    cancelTrajectory(motorNum);
+    cancelMotion(motorNum);
+    // Fast ramp: the default SMOOTH_STEP rate would keep driving the jam for seconds
+    stopMotor(motorNum, CURRENT_FAULT_STOP_MODE, CURRENT_FAULT_MAX_DECEL);
+    publishMotorEvent(motorNum, "fault", faultName(fault));
+
+    // Re-arm; with target 0 the stop ramp is not "driven", so no re-trigger before the next command
+    ch.pendingFault = FAULT_NONE;
+  }
+}
+
+bool hasCurrentSense(int motorNum) {
+  return channels[motorNum - 1].pin >= 0;
+}
+
+float getMotorCurrent(int motorNum) {
+  if (!hasCurrentSense(motorNum)) return 0.0f;
+  return channels[motorNum - 1].amps;
+}
+
+bool takeCurrentWindow(int motorNum, CurrentWindow* window) {
+  CurrentChannel& ch = channels[motorNum - 1];
+
+  portENTER_CRITICAL(&windowMux);
+  uint32_t count = ch.windowCount;
+  if (count > 0) {
+    window->minAmps = ch.windowMin;
+    window->maxAmps = ch.windowMax;
+    window->avgAmps = ch.windowSum / count;
+    window->samples = count;
+    ch.windowSum = 0.0f;
+    ch.windowCount = 0;
+  }
+  portEXIT_CRITICAL(&windowMux);
+
+  return count > 0;
+}
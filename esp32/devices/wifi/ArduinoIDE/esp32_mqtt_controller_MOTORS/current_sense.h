@@ -0,0 +1,29 @@
+#ifndef CURRENT_SENSE_H
+#define CURRENT_SENSE_H
+
+#include <Arduino.h>
+
+// Driver current-sense inputs sampled by the ADC in continuous (DMA) mode.
+// Filtering and stall/overcurrent detection run in a background task,
+// the resulting stop is executed from loop() via updateCurrentSense().
+void initializeCurrentSense();
+
+// Call every loop() pass – handles detected faults
+void updateCurrentSense();
+
+bool hasCurrentSense(int motorNum);
+
+// Filtered motor current in A (0 without a sense input)
+float getMotorCurrent(int motorNum);
+
+struct CurrentWindow {
+  float minAmps;
+  float avgAmps;
+  float maxAmps;
+  uint32_t samples;
+};
+
+// Min/avg/max since the previous call; false if no sample arrived in between
+bool takeCurrentWindow(int motorNum, CurrentWindow* window);
+
+#endif
@@ -1,20 +0,0 @@
-#include "debug.h"
-#include "config.h"
-
-void debugPrint(const String& message) {
-  if (DEBUG) {
-    Serial.print("[DEBUG] ");
-    Serial.print(millis());
-    Serial.print("ms - ");
-    Serial.println(message);
-  }
-}
-
-void debugPrint(const char* message) {
-  if (DEBUG) {
-    Serial.print("[DEBUG] ");
-    Serial.print(millis());
-    Serial.print("ms - ");
-    Serial.println(message);
-  }
-}
\ No newline at end of file
@@ -2,11 +2,7 @@
 #define DEBUG_H
 
 #include <Arduino.h>
+#include <museum_log.h>
+#include "config.h"  // LOG_LEVEL, LOG_MODULE_*
 
-// String overload – for existing callers that build a String message
-void debugPrint(const String& message);
-
-// const char* overload – zero heap allocation, use this in hot paths
-void debugPrint(const char* message);
-
-#endif
\ No newline at end of file
+#endif
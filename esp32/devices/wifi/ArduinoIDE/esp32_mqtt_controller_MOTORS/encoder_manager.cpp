@@ -0,0 +1,131 @@
+#include "encoder_manager.h"
+#include "config.h"
+#include "debug.h"
+#include <driver/pulse_cnt.h>
+
+// Hardware counter limit – with accum_count the driver extends it to 32 bit
+static const int ENCODER_PCNT_LIMIT = 30000;
+// Pulses shorter than this are treated as noise from the motor leads
+static const uint32_t ENCODER_GLITCH_NS = 1000;
+
+static pcnt_unit_handle_t encoderUnits[2] = {nullptr, nullptr};
+static bool encoderQuadrature[2] = {false, false};
+
+// Undo a partial setup: channels before the unit, a running unit is stopped and disabled first
+static void teardownEncoder(pcnt_unit_handle_t unit, pcnt_channel_handle_t chanA, pcnt_channel_handle_t chanB,
+                            bool enabled) {
+  if (enabled) {
+    pcnt_unit_stop(unit);
+    pcnt_unit_disable(unit);
+  }
+  if (chanB != nullptr) pcnt_del_channel(chanB);
+  if (chanA != nullptr) pcnt_del_channel(chanA);
+  pcnt_del_unit(unit);
+}
+
+// Runs the call only while all previous steps succeeded; the first failure names the step
+#define ENCODER_STEP(name, call)                          \
+  do {                                                    \
+    if (err == ESP_OK && (err = (call)) != ESP_OK) {      \
+      failedStep = (name);                                \
+    }                                                     \
+  } while (0)
+
+static bool setupEncoder(int motorNum, int pinA, int pinB) {
+  if (pinA < 0) return false;
+
+  pcnt_unit_config_t unitConfig = {};
+  unitConfig.low_limit = -ENCODER_PCNT_LIMIT;
+  unitConfig.high_limit = ENCODER_PCNT_LIMIT;
+  unitConfig.flags.accum_count = 1;
+
+  pcnt_unit_handle_t unit = nullptr;
+  if (pcnt_new_unit(&unitConfig, &unit) != ESP_OK) {
+    LOG_ERROR(ENCODER, "Encoder" + String(motorNum) + ": no free PCNT unit - motor stays open-loop");
+    return false;
+  }
+
+  esp_err_t err = ESP_OK;
+  const char* failedStep = nullptr;
+  pcnt_channel_handle_t chanA = nullptr;
+  pcnt_channel_handle_t chanB = nullptr;
+  bool enabled = false;
+
+  pcnt_glitch_filter_config_t filterConfig = {};
+  filterConfig.max_glitch_ns = ENCODER_GLITCH_NS;
+  ENCODER_STEP("glitch filter", pcnt_unit_set_glitch_filter(unit, &filterConfig));
+
+  // Channel A counts edges of A, direction from level of B (-1 = tach, no level input)
+  pcnt_chan_config_t chanAConfig = {};
+  chanAConfig.edge_gpio_num = pinA;
+  chanAConfig.level_gpio_num = pinB;
+  ENCODER_STEP("channel A", pcnt_new_channel(unit, &chanAConfig, &chanA));
+
+  if (pinB >= 0) {
+    // Full x4 quadrature decoding: second channel with swapped roles
+    pcnt_chan_config_t chanBConfig = {};
+    chanBConfig.edge_gpio_num = pinB;
+    chanBConfig.level_gpio_num = pinA;
+    ENCODER_STEP("channel B", pcnt_new_channel(unit, &chanBConfig, &chanB));
+
+    ENCODER_STEP("channel A edge action",
+                 pcnt_channel_set_edge_action(chanA, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+    ENCODER_STEP("channel A level action",
+                 pcnt_channel_set_level_action(chanA, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+    ENCODER_STEP("channel B edge action",
+                 pcnt_channel_set_edge_action(chanB, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE));
+    ENCODER_STEP("channel B level action",
+                 pcnt_channel_set_level_action(chanB, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+  } else {
+    // Single tach line: count rising edges only
+    ENCODER_STEP("channel A edge action",
+                 pcnt_channel_set_edge_action(chanA, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD));
+  }
+
+  // Watch points at the limits let the driver accumulate overflows
+  ENCODER_STEP("high watch point", pcnt_unit_add_watch_point(unit, ENCODER_PCNT_LIMIT));
+  ENCODER_STEP("low watch point", pcnt_unit_add_watch_point(unit, -ENCODER_PCNT_LIMIT));
+
+  ENCODER_STEP("enable", pcnt_unit_enable(unit));
+  enabled = (err == ESP_OK);
+  ENCODER_STEP("clear", pcnt_unit_clear_count(unit));
+  ENCODER_STEP("start", pcnt_unit_start(unit));
+
+  // A unit that never counts would make the PID drive the output to full duty
+  if (err != ESP_OK) {
+    teardownEncoder(unit, chanA, chanB, enabled);
+    LOG_ERROR(ENCODER, "Encoder" + String(motorNum) + ": PCNT " + failedStep + " failed (" + String(err) +
+                           ") - motor stays open-loop");
+    return false;
+  }
+
+  encoderUnits[motorNum - 1] = unit;
+  encoderQuadrature[motorNum - 1] = (pinB >= 0);
+  LOG_INFO(ENCODER, "Encoder" + String(motorNum) + " ready on GPIO " + String(pinA) +
+             (pinB >= 0 ? "/" + String(pinB) + " (quadrature)" : String(" (tach)")));
+  return true;
+}
+
+#undef ENCODER_STEP
+
+void initializeEncoders() {
+  setupEncoder(1, MOTOR1_ENCODER_A_PIN, MOTOR1_ENCODER_B_PIN);
+  setupEncoder(2, MOTOR2_ENCODER_A_PIN, MOTOR2_ENCODER_B_PIN);
+}
+
+bool hasEncoder(int motorNum) {
+  if (motorNum < 1 || motorNum > 2) return false;
+  return encoderUnits[motorNum - 1] != nullptr;
+}
+
+bool isQuadratureEncoder(int motorNum) {
+  return hasEncoder(motorNum) && encoderQuadrature[motorNum - 1];
+}
+
+int32_t readEncoderCount(int motorNum) {
+  if (!hasEncoder(motorNum)) return 0;
+
+  int count = 0;
+  pcnt_unit_get_count(encoderUnits[motorNum - 1], &count);
+  return count;
+}
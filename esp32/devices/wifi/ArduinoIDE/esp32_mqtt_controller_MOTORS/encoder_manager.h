@@ -0,0 +1,18 @@
+#ifndef ENCODER_MANAGER_H
+#define ENCODER_MANAGER_H
+
+#include <Arduino.h>
+
+// PCNT based encoder / tach input per motor
+void initializeEncoders();
+
+// True if the motor has an encoder pin configured and its PCNT unit is running
+bool hasEncoder(int motorNum);
+
+// True for A+B quadrature (signed count), false for a single tach line
+bool isQuadratureEncoder(int motorNum);
+
+// Accumulated count since boot (signed for quadrature, rising only for tach)
+int32_t readEncoderCount(int motorNum);
+
+#endif
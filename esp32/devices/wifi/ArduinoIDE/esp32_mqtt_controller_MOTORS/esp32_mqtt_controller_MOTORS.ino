@@ -6,23 +6,78 @@
 #include "connection_monitor.h"
 #include "ota_manager.h"
 #include "wdt_manager.h"
+#include "speed_control.h"
+#include "motion_control.h"
+#include "trajectory.h"
+#include "current_sense.h"
+#include "telemetry.h"
+#include "sync_control.h"
+#include <museum_log_crash.h>
+
+// loop() stages kept in RTC memory - the crash record (devices/<id>/crash) names the one that hung
+enum LoopStage : uint8_t {
+  STAGE_OTA,
+  STAGE_MQTT,
+  STAGE_CURRENT,
+  STAGE_RAMP,
+  STAGE_SYNC,
+  STAGE_TRAJECTORY,
+  STAGE_MOTION,
+  STAGE_TELEMETRY,
+  STAGE_NET,
+  STAGE_COUNT
+};
+static const char* const LOOP_STAGE_NAMES[STAGE_COUNT] = {
+  "ota", "mqtt", "current", "ramp", "sync", "trajectory", "motion", "telemetry", "net"};
+
+// Stage watchdog budget in ms, 0 = unchecked (an OTA upload blocks longer - only the
+// hardware WDT covers it). A blocking Wi-Fi / MQTT reconnect in "net" takes seconds: after
+// 300 ms the monitor disables the bridges, nothing would control the motors meanwhile.
+static const uint16_t LOOP_STAGE_BUDGET_MS[STAGE_COUNT] = {
+  0, 1000, 50, 50, 50, 50, 50, 500, 300};
+
+// A stuck stage has returned: the monitor already disabled the bridges,
+// bring the motor state in line and report it
+static void handleStageStall() {
+  StageStall stall;
+  if (!takeStageStall(&stall)) return;
+  turnOffHardware();
+  publishStageStall(stall);
+}
+
+// Stage in RTC memory (survives WDT / panic) + budget check
+#define LOOP_STAGE(stage, ...)          \
+  do {                                  \
+    stageEnter(stage);                  \
+    __VA_ARGS__;                        \
+    stageExit();                        \
+    handleStageStall();                 \
+  } while (0)
 
 void setup() {
   Serial.begin(115200);
   delay(100);
+  logRingBegin();  // Binary log (LOGR_*) - records from before a WDT reset are printed in loop()
+  crashBegin(LOOP_STAGE_NAMES, STAGE_COUNT);  // Reset reason, stage and commands before a crash
 
   Serial.println("\n=== ESP32 MQTT Controller Starting ===");
-  debugPrint("=== ESP32 MQTT Controller Starting ===");
+  LOG_INFO(MAIN, "=== ESP32 MQTT Controller Starting ===");
 
   // Initialize Watchdog Timer
   initializeWatchdog();
 
   // Initialize hardware and Wi-Fi
   initializeHardware();
+  initializeSpeedControl();
+  initializeCurrentSense();
+  initializeMotion();
+  initializeSync();
   if (!initializeWiFi()) {
     Serial.println("WiFi failed, will retry...");
-    debugPrint("Initial WiFi failed");
+    LOG_WARN(MAIN, "Initial WiFi failed");
   }
+  initializeTrajectories();
+  initializeTelemetry();
 
   // Initialize OTA ONLY after WiFi is connected
   if (wifiConnected) {
@@ -32,15 +87,17 @@ void setup() {
   // Initialize MQTT
   initializeMqtt();
 
+  initializeStageWatchdog(LOOP_STAGE_NAMES, LOOP_STAGE_BUDGET_MS, STAGE_COUNT, forceOutputsOff);
+
   Serial.println("=== Setup Complete ===");
   Serial.println("Ready - Listening on: " + String(BASE_TOPIC_PREFIX) + "#");
-  debugPrint("=== Setup completed ===");
+  LOG_INFO(MAIN, "=== Setup completed ===");
 }
 
 void loop() {
   // Handle OTA first
   if (wifiConnected) {
-    handleOTA();
+    LOOP_STAGE(STAGE_OTA, handleOTA());
     // If OTA upload is happening, do nothing else
     if (isOTAInProgress()) {
       delay(10);
@@ -50,11 +107,16 @@ void loop() {
 
   // MQTT loop must be first for fast feedback
   if (isMqttConnected()) {
-    mqttLoop();
+    LOOP_STAGE(STAGE_MQTT, mqttLoop());
   }
 
   // Smooth motor update
-  updateMotorSmoothly();
+  LOOP_STAGE(STAGE_CURRENT, updateCurrentSense());
+  LOOP_STAGE(STAGE_RAMP, updateMotorSmoothly());
+  LOOP_STAGE(STAGE_SYNC, updateSync());
+  LOOP_STAGE(STAGE_TRAJECTORY, updateTrajectories());
+  LOOP_STAGE(STAGE_MOTION, updateMotion());
+  LOOP_STAGE(STAGE_TELEMETRY, updateTelemetry());
 
   // Watchdog reset (only if not doing an OTA update)
   if (!isOTAInProgress()) {
@@ -68,6 +130,7 @@ void loop() {
   // Handle Wi-Fi and MQTT reconnections more frequently
   if (currentTime - lastQuickCheck >= 100) {
     lastQuickCheck = currentTime;
+    stageEnter(STAGE_NET);
     if (!isWiFiConnected()) {
       reconnectWiFi();
       // Re-initialize OTA after Wi-Fi reconnect
@@ -79,6 +142,8 @@ void loop() {
     if (wifiConnected && !isMqttConnected()) {
       connectToMqtt();
     }
+    stageExit();
+    handleStageStall();
   }
 
   // Perform more detailed checks less frequently
@@ -96,10 +161,13 @@ void loop() {
   // Deadman timeout: if no valid command arrives for too long, force motors off.
   if (!hardwareOff && lastCommandTime > 0 &&
       (currentTime - lastCommandTime > NO_COMMAND_TIMEOUT)) {
-    debugPrint("Command inactivity timeout -> turning motors OFF");
+    LOGR_WARN(MAIN, "Command inactivity timeout -> turning motors OFF");
     turnOffHardware();
     lastCommandTime = currentTime;
   }
 
+  // Deferred binary log, only when the UART has room
+  logRingDrain(Serial);
+
   delay(10);
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "hardware.h"
 #include "config.h"
 #include "debug.h"
+#include "speed_control.h"
+#include "mqtt_manager.h"
 #include <Arduino.h>
+#include <museum_metrics.h>
 
 // Global hardware state
 bool hardwareOff = false;
@@ -10,8 +13,38 @@ bool hardwareOff = false;
 MotorState motor1State = {false, 0, 0, 0, 'S', 0, false, 0, 0, false, 0, 0, 0};
 MotorState motor2State = {false, 0, 0, 0, 'S', 0, false, 0, 0, false, 0, 0, 0};
 
+MotorState& getMotorState(int motorNum) {
+  return (motorNum == 1) ? motor1State : motor2State;
+}
+
+static int leftPinFor(int motorNum)   { return (motorNum == 1) ? MOTOR1_LEFT_PIN : MOTOR2_LEFT_PIN; }
+static int rightPinFor(int motorNum)  { return (motorNum == 1) ? MOTOR1_RIGHT_PIN : MOTOR2_RIGHT_PIN; }
+static int enablePinFor(int motorNum) { return (motorNum == 1) ? MOTOR1_ENABLE_PIN : MOTOR2_ENABLE_PIN; }
+
+// Stop sequence per motor (OFF/STOP with a stop mode)
+struct StopSequence {
+  StopMode mode;
+  bool brakePending;          // Ramping down, brake engages at currentSpeed 0
+  bool braking;               // Both legs driven
+  unsigned long brakeStart;
+  bool measuring;             // Waiting for encoder standstill
+  unsigned long stopStart;
+};
+
+static StopSequence stopSequences[2] = {};
+
+// Motors whose profile is computed outside updateSingleMotor() (sync group)
+static bool profileHeld[2] = {false, false};
+
+// Last duty written to the bridge (telemetry), written by loop() and the speed task
+static volatile int motorDuty[2] = {0, 0};
+
+// Ramp step lateness per motor (devices/<id>/timing)
+static const char* const TIMING_NAMES[2] = {"motor1", "motor2"};
+static bool rampStepping[2] = {false, false};
+
 void initializeHardware() {
-  debugPrint("Initializing PWM motors...");
+  LOG_INFO(HW, "Initializing PWM motors...");
 
   ledcAttach(MOTOR1_LEFT_PIN, PWM_FREQUENCY, PWM_RESOLUTION);
   ledcAttach(MOTOR1_RIGHT_PIN, PWM_FREQUENCY, PWM_RESOLUTION);
@@ -23,287 +56,455 @@ void initializeHardware() {
   pinMode(MOTOR2_ENABLE_PIN, OUTPUT);
 
   turnOffHardware();
-  debugPrint("Hardware initialized - PWM motors ready");
+  latenessBegin(TIMING_NAMES, 2, TIMING_MISS_US);
+  LOG_INFO(HW, "Hardware initialized - PWM motors ready");
 }
 
-void updateMotorPWM(int motorNum, int speed, char direction) {
-  int pwmValue = map(speed, 0, 100, 0, 255);
-  pwmValue = constrain(pwmValue, 0, 255);
-
-  if (motorNum == 1) {
-    if (speed == 0) {
-      ledcWrite(MOTOR1_LEFT_PIN, 0);
-      ledcWrite(MOTOR1_RIGHT_PIN, 0);
-    } else if (direction == 'L') {
-      ledcWrite(MOTOR1_LEFT_PIN, pwmValue);
-      ledcWrite(MOTOR1_RIGHT_PIN, 0);
-    } else if (direction == 'R') {
-      ledcWrite(MOTOR1_LEFT_PIN, 0);
-      ledcWrite(MOTOR1_RIGHT_PIN, pwmValue);
-    }
-  } else if (motorNum == 2) {
-    if (speed == 0) {
-      ledcWrite(MOTOR2_LEFT_PIN, 0);
-      ledcWrite(MOTOR2_RIGHT_PIN, 0);
-    } else if (direction == 'L') {
-      ledcWrite(MOTOR2_LEFT_PIN, pwmValue);
-      ledcWrite(MOTOR2_RIGHT_PIN, 0);
-    } else if (direction == 'R') {
-      ledcWrite(MOTOR2_LEFT_PIN, 0);
-      ledcWrite(MOTOR2_RIGHT_PIN, pwmValue);
-    }
+void writeMotorDuty(int motorNum, int duty, char direction) {
+  int leftPin = leftPinFor(motorNum);
+  int rightPin = rightPinFor(motorNum);
+  motorDuty[motorNum - 1] = duty;
+
+  uint32_t applyStart = micros();
+  if (duty == 0) {
+    ledcWrite(leftPin, 0);
+    ledcWrite(rightPin, 0);
+  } else if (direction == 'L') {
+    ledcWrite(leftPin, duty);
+    ledcWrite(rightPin, 0);
+  } else if (direction == 'R') {
+    ledcWrite(leftPin, 0);
+    ledcWrite(rightPin, duty);
   }
+  benchRecordApply(micros() - applyStart);   // Counted only for a synthetic command on the loop task
 }
 
-// Function: Smooth motor update with custom ramp and direction change support
-void updateMotorSmoothly() {
-  unsigned long currentTime = millis();
+float getMotorDutyPercent(int motorNum) {
+  const int maxDuty = (1 << PWM_RESOLUTION) - 1;
+  return motorDuty[motorNum - 1] * 100.0f / maxDuty;
+}
 
-  // ----- MOTOR 1 LOGIKA -----
-  if (currentTime - motor1State.lastUpdate >= SMOOTH_DELAY) {
-    
-    // 1. LOGIKA ZMENY SMERU (Čaká na nulovú rýchlosť)
-    if (motor1State.pendingDirectionChange) {
-       if (motor1State.currentSpeed == 0) {
-          motor1State.direction = motor1State.newDirection;
-          motor1State.targetSpeed = motor1State.savedSpeed;
-          motor1State.pendingDirectionChange = false;
-          debugPrint("Motor1 reached 0, flipping direction to: " + String(motor1State.direction) + ", resuming to: " + String(motor1State.targetSpeed));
-       } 
-       else {
-          motor1State.targetSpeed = 0;
-          motor1State.rampActive = false; // Pri otáčaní nepoužívame custom rampu, ale štandardný dobeh
-       }
-    }
+void updateMotorPWM(int motorNum, int speed, char direction) {
+  // Closed-loop motors: speed is only the setpoint, the control task owns the PWM output
+  if (isClosedLoop(motorNum)) return;
 
-    // 2. LOGIKA CUSTOM RAMPY (Iba ak nemeníme smer)
-    if (motor1State.rampActive && !motor1State.pendingDirectionChange) {
-      if (currentTime >= motor1State.rampStartTime + motor1State.rampDurationMs) {
-        motor1State.currentSpeed = motor1State.targetSpeed;
-        motor1State.rampActive = false;
-        debugPrint("Motor1 Ramp finished.");
-      } else {
-        unsigned long elapsedTime = currentTime - motor1State.rampStartTime;
-        long deltaSpeed = motor1State.targetSpeed - motor1State.rampStartSpeed;
-        motor1State.currentSpeed = motor1State.rampStartSpeed + (int)((deltaSpeed * elapsedTime) / motor1State.rampDurationMs);
-        updateMotorPWM(1, motor1State.currentSpeed, motor1State.direction);
-        motor1State.lastUpdate = currentTime;
-        return; // Pri rampe neriešime štandardný krok nižšie
-      }
-    }
-    
-    // 3. ŠTANDARDNÁ Plynulá zmena rýchlosti
-    if (motor1State.currentSpeed != motor1State.targetSpeed) {
-      if (motor1State.currentSpeed < motor1State.targetSpeed) {
-        motor1State.currentSpeed = min(motor1State.currentSpeed + SMOOTH_STEP, motor1State.targetSpeed);
-      } else {
-        motor1State.currentSpeed = max(motor1State.currentSpeed - SMOOTH_STEP, motor1State.targetSpeed);
-      }
-      updateMotorPWM(1, motor1State.currentSpeed, motor1State.direction);
-      motor1State.lastUpdate = currentTime;
-    }
+  const int maxDuty = (1 << PWM_RESOLUTION) - 1;
+  int pwmValue = map(speed, 0, 100, 0, maxDuty);
+  pwmValue = constrain(pwmValue, 0, maxDuty);
+  writeMotorDuty(motorNum, pwmValue, direction);
+}
+
+// A step of a running ramp was due SMOOTH_DELAY after the previous one; the
+// first step after idle has no schedule and is not recorded
+static void recordRampStep(int motorNum, MotorState& state, unsigned long currentTime) {
+  if (rampStepping[motorNum - 1]) {
+    latenessRecordMs(motorNum - 1, state.lastUpdate + SMOOTH_DELAY);
   }
+  rampStepping[motorNum - 1] = true;
+  state.lastUpdate = currentTime;
+}
 
-  // ----- MOTOR 2 LOGIKA -----
-  if (currentTime - motor2State.lastUpdate >= SMOOTH_DELAY) {
-
-    // 1. LOGIKA ZMENY SMERU
-    if (motor2State.pendingDirectionChange) {
-       if (motor2State.currentSpeed == 0) {
-          motor2State.direction = motor2State.newDirection;
-          motor2State.targetSpeed = motor2State.savedSpeed;
-          motor2State.pendingDirectionChange = false;
-          debugPrint("Motor2 reached 0, flipping direction to: " + String(motor2State.direction));
-       } else {
-          motor2State.targetSpeed = 0;
-          motor2State.rampActive = false;
-       }
+// Smooth update of one motor: direction change, custom ramp, standard step
+static void updateSingleMotor(int motorNum, MotorState& state, unsigned long currentTime) {
+  if (profileHeld[motorNum - 1]) {
+    rampStepping[motorNum - 1] = false;
+    return;
+  }
+  if (currentTime - state.lastUpdate < SMOOTH_DELAY) return;
+
+  // 1. LOGIKA ZMENY SMERU (Čaká na nulovú rýchlosť)
+  if (state.pendingDirectionChange) {
+    if (state.currentSpeed == 0) {
+      state.direction = state.newDirection;
+      state.targetSpeed = state.savedSpeed;
+      state.pendingDirectionChange = false;
+      LOG_INFO(HW, "Motor" + String(motorNum) + " reached 0, flipping direction to: " + String(state.direction) + ", resuming to: " + String(state.targetSpeed));
+    } else {
+      state.targetSpeed = 0;
+      state.rampActive = false; // Pri otáčaní nepoužívame custom rampu, ale štandardný dobeh
     }
+  }
 
-    // 2. LOGIKA CUSTOM RAMPY
-    if (motor2State.rampActive && !motor2State.pendingDirectionChange) {
-      if (currentTime >= motor2State.rampStartTime + motor2State.rampDurationMs) {
-        motor2State.currentSpeed = motor2State.targetSpeed;
-        motor2State.rampActive = false;
-        debugPrint("Motor2 Ramp finished.");
-      } else {
-        unsigned long elapsedTime = currentTime - motor2State.rampStartTime;
-        long deltaSpeed = motor2State.targetSpeed - motor2State.rampStartSpeed;
-        motor2State.currentSpeed = motor2State.rampStartSpeed + (int)((deltaSpeed * elapsedTime) / motor2State.rampDurationMs);
-        updateMotorPWM(2, motor2State.currentSpeed, motor2State.direction);
-        motor2State.lastUpdate = currentTime;
-        return; 
-      }
-    }
-    
-    // 3. ŠTANDARDNÁ Plynulá zmena
-    if (motor2State.currentSpeed != motor2State.targetSpeed) {
-      if (motor2State.currentSpeed < motor2State.targetSpeed) {
-        motor2State.currentSpeed = min(motor2State.currentSpeed + SMOOTH_STEP, motor2State.targetSpeed);
-      } else {
-        motor2State.currentSpeed = max(motor2State.currentSpeed - SMOOTH_STEP, motor2State.targetSpeed);
-      }
-      updateMotorPWM(2, motor2State.currentSpeed, motor2State.direction);
-      motor2State.lastUpdate = currentTime;
+  // 2. LOGIKA CUSTOM RAMPY (Iba ak nemeníme smer)
+  if (state.rampActive && !state.pendingDirectionChange) {
+    if (currentTime >= state.rampStartTime + state.rampDurationMs) {
+      state.currentSpeed = state.targetSpeed;
+      state.rampActive = false;
+      LOGR_DEBUG(HW, "Motor%d Ramp finished.", motorNum);
+    } else {
+      unsigned long elapsedTime = currentTime - state.rampStartTime;
+      long deltaSpeed = state.targetSpeed - state.rampStartSpeed;
+      state.currentSpeed = state.rampStartSpeed + (int)((deltaSpeed * elapsedTime) / state.rampDurationMs);
+      updateMotorPWM(motorNum, state.currentSpeed, state.direction);
+      recordRampStep(motorNum, state, currentTime);
+      return; // Pri rampe neriešime štandardný krok nižšie
     }
   }
-}
 
-// controlMotor1
-void controlMotor1(const char* command, const char* speed, const char* direction, const char* rampTime) {
-  debugPrint("Motor1 CMD: " + String(command) + " Spd:" + String(speed) + " Dir:" + String(direction));
-
-  if (strcmp(command, "ON") == 0) {
-    motor1State.enabled = true;
-    digitalWrite(MOTOR1_ENABLE_PIN, HIGH);
-    
-    int targetSpd = atoi(speed);
-    char targetDir = direction[0];
-    unsigned long rampDuration = atol(rampTime);
-
-    // --- FIX: Detekcia zmeny smeru za behu ---
-    if (motor1State.currentSpeed > 0 && motor1State.direction != targetDir) {
-        debugPrint("Motor1 changing direction while running! Initiating smooth reversal.");
-        motor1State.pendingDirectionChange = true;
-        motor1State.newDirection = targetDir;
-        motor1State.savedSpeed = targetSpd;
-        motor1State.targetSpeed = 0;
-        motor1State.rampActive = false; // Vypneme rampu pre spomalenie
-        hardwareOff = false;
-        return; // DÔLEŽITÉ: Nespustiť kód nižšie, kým sa motor neotočí
-    }
-    // -----------------------------------------
-    
-    motor1State.direction = targetDir;
-    motor1State.speed = targetSpd;
-    motor1State.pendingDirectionChange = false;
-
-    if (rampDuration > 0) {
-      motor1State.rampActive = true;
-      motor1State.rampDurationMs = rampDuration;
-      motor1State.rampStartTime = millis();
-      motor1State.rampStartSpeed = motor1State.currentSpeed;
-      motor1State.targetSpeed = motor1State.speed;
+  // 3. ŠTANDARDNÁ Plynulá zmena rýchlosti
+  if (state.currentSpeed != state.targetSpeed) {
+    if (state.currentSpeed < state.targetSpeed) {
+      state.currentSpeed = min(state.currentSpeed + SMOOTH_STEP, state.targetSpeed);
     } else {
-      motor1State.targetSpeed = motor1State.speed;
-      motor1State.rampActive = false;
+      state.currentSpeed = max(state.currentSpeed - SMOOTH_STEP, state.targetSpeed);
     }
-    
-    hardwareOff = false;
+    updateMotorPWM(motorNum, state.currentSpeed, state.direction);
+    recordRampStep(motorNum, state, currentTime);
+  } else {
+    rampStepping[motorNum - 1] = false;
+  }
+}
 
-  } else if (strcmp(command, "OFF") == 0) {
-    // --- FIX: PLYNULÉ ZASTAVENIE ---
-    if (motor1State.enabled) {
-        motor1State.targetSpeed = 0;
-        motor1State.speed = 0;
-        motor1State.rampActive = false; // Použije sa štandardný SMOOTH_STEP
-        debugPrint("Motor1 stopping smoothly (OFF command)");
-        // Nechávame enabled = true, kým nedobehne, resp. kým sa nezavolá turnOffHardware
-    }
+static const char* stopModeName(StopMode mode) {
+  switch (mode) {
+    case STOP_MODE_RAMP:          return "RAMP";
+    case STOP_MODE_BRAKE:         return "BRAKE";
+    case STOP_MODE_BRAKE_RELEASE: return "BRAKE_RELEASE";
+    default:                      return "COAST";
+  }
+}
 
-  } else if (strcmp(command, "SPEED") == 0) {
-    if (motor1State.enabled) {
-      motor1State.speed = atoi(speed);
-      motor1State.targetSpeed = motor1State.speed;
-      motor1State.rampActive = false;
-    }
+static bool nameEquals(const char* name, size_t length, const char* keyword) {
+  return strlen(keyword) == length && strncmp(name, keyword, length) == 0;
+}
+
+bool parseStopMode(const char* name, size_t length, StopMode* mode) {
+  if (nameEquals(name, length, "COAST"))         { *mode = STOP_MODE_COAST;         return true; }
+  if (nameEquals(name, length, "RAMP"))          { *mode = STOP_MODE_RAMP;          return true; }
+  if (nameEquals(name, length, "BRAKE"))         { *mode = STOP_MODE_BRAKE;         return true; }
+  if (nameEquals(name, length, "BRAKE_RELEASE")) { *mode = STOP_MODE_BRAKE_RELEASE; return true; }
+  return false;
+}
+
+bool isMotorBraking(int motorNum) {
+  return stopSequences[motorNum - 1].braking;
+}
+
+// Short brake: both legs at full duty so the motor windings are shorted through the high side
+static void engageBrake(int motorNum, unsigned long currentTime) {
+  MotorState& state = getMotorState(motorNum);
+  StopSequence& seq = stopSequences[motorNum - 1];
+  const int maxDuty = (1 << PWM_RESOLUTION) - 1;
+
+  state.speed = 0;
+  state.targetSpeed = 0;
+  state.currentSpeed = 0;
+  state.rampActive = false;
+  state.enabled = true;
+
+  seq.brakePending = false;
+  seq.braking = true;
+  seq.brakeStart = currentTime;
+
+  digitalWrite(enablePinFor(motorNum), HIGH);
+  ledcWrite(leftPinFor(motorNum), maxDuty);
+  ledcWrite(rightPinFor(motorNum), maxDuty);
+  motorDuty[motorNum - 1] = 0;  // No drive torque while braking
+  LOG_INFO(HW, "Motor" + String(motorNum) + " brake engaged");
+}
+
+static void releaseToCoast(int motorNum) {
+  MotorState& state = getMotorState(motorNum);
 
-  } else if (strcmp(command, "DIR") == 0) {
-    if (motor1State.enabled) {
-      char newDir = direction[0];
-      if (motor1State.direction == newDir) return;
-
-      if (motor1State.currentSpeed > 0) {
-        motor1State.savedSpeed = motor1State.speed;
-        motor1State.newDirection = newDir;
-        motor1State.pendingDirectionChange = true;
-        motor1State.targetSpeed = 0;
-        motor1State.rampActive = false;
-        debugPrint("Motor1 reversing direction via DIR command");
+  stopSequences[motorNum - 1].braking = false;
+  writeMotorDuty(motorNum, 0, state.direction);
+  digitalWrite(enablePinFor(motorNum), LOW);
+  state.enabled = false;
+}
+
+// A new drive command takes the motor out of any stop sequence
+static void cancelStopSequence(int motorNum) {
+  StopSequence& seq = stopSequences[motorNum - 1];
+  seq.brakePending = false;
+  seq.braking = false;
+  seq.measuring = false;
+}
+
+// Limits the ramp-down to maxDecel %/s by reusing the custom ramp; 0 = SMOOTH_STEP
+static void startStopRamp(MotorState& state, int maxDecel, unsigned long currentTime) {
+  if (maxDecel > 0 && state.currentSpeed > 0) {
+    state.rampActive = true;
+    state.rampStartTime = currentTime;
+    state.rampStartSpeed = state.currentSpeed;
+    state.rampDurationMs = max(1UL, (unsigned long)state.currentSpeed * 1000UL / maxDecel);
+  } else {
+    state.rampActive = false;
+  }
+}
+
+void stopMotor(int motorNum, StopMode mode, int maxDecel) {
+  MotorState& state = getMotorState(motorNum);
+  StopSequence& seq = stopSequences[motorNum - 1];
+  unsigned long currentTime = millis();
+
+  LOGR_INFO(HW, "Motor%d stop: %s", motorNum, stopModeName(mode));
+
+  seq.mode = mode;
+  seq.brakePending = false;
+  seq.braking = false;
+  seq.stopStart = currentTime;
+  // Standstill time is only meaningful if the motor was actually driven
+  seq.measuring = isClosedLoop(motorNum) && state.enabled && state.currentSpeed > 0;
+
+  state.speed = 0;
+  state.targetSpeed = 0;
+  state.pendingDirectionChange = false;
+
+  switch (mode) {
+    case STOP_MODE_COAST:
+      state.currentSpeed = 0;
+      state.rampActive = false;
+      releaseToCoast(motorNum);
+      break;
+
+    case STOP_MODE_RAMP:
+      startStopRamp(state, maxDecel > 0 ? maxDecel : STOP_RAMP_MAX_DECEL, currentTime);
+      break;
+
+    case STOP_MODE_BRAKE:
+    case STOP_MODE_BRAKE_RELEASE:
+      if (STOP_BRAKE_MAX_DECEL > 0 && state.currentSpeed > 0) {
+        startStopRamp(state, STOP_BRAKE_MAX_DECEL, currentTime);
+        seq.brakePending = true;
       } else {
-        motor1State.direction = newDir;
+        engageBrake(motorNum, currentTime);
       }
-    }
+      break;
   }
 }
 
-// controlMotor2
-void controlMotor2(const char* command, const char* speed, const char* direction, const char* rampTime) {
-  debugPrint("Motor2 CMD: " + String(command) + " Spd:" + String(speed) + " Dir:" + String(direction));
-
-  if (strcmp(command, "ON") == 0) {
-    motor2State.enabled = true;
-    digitalWrite(MOTOR2_ENABLE_PIN, HIGH);
-    
-    int targetSpd = atoi(speed);
-    char targetDir = direction[0];
-    unsigned long rampDuration = atol(rampTime);
-
-    // --- FIX: Detekcia zmeny smeru za behu ---
-    if (motor2State.currentSpeed > 0 && motor2State.direction != targetDir) {
-        debugPrint("Motor2 changing direction while running! Initiating smooth reversal.");
-        motor2State.pendingDirectionChange = true;
-        motor2State.newDirection = targetDir;
-        motor2State.savedSpeed = targetSpd;
-        motor2State.targetSpeed = 0;
-        motor2State.rampActive = false;
-        hardwareOff = false;
-        return; 
-    }
-    // -----------------------------------------
-
-    motor2State.direction = targetDir;
-    motor2State.speed = targetSpd;
-    motor2State.pendingDirectionChange = false;
-
-    if (rampDuration > 0) {
-      motor2State.rampActive = true;
-      motor2State.rampDurationMs = rampDuration;
-      motor2State.rampStartTime = millis();
-      motor2State.rampStartSpeed = motor2State.currentSpeed;
-      motor2State.targetSpeed = motor2State.speed;
-    } else {
-      motor2State.targetSpeed = motor2State.speed;
-      motor2State.rampActive = false;
+static void updateStopSequence(int motorNum, unsigned long currentTime) {
+  MotorState& state = getMotorState(motorNum);
+  StopSequence& seq = stopSequences[motorNum - 1];
+
+  if (seq.brakePending && state.currentSpeed == 0) {
+    engageBrake(motorNum, currentTime);
+  }
+
+  if (seq.braking && seq.mode == STOP_MODE_BRAKE_RELEASE &&
+      currentTime - seq.brakeStart >= BRAKE_RELEASE_MS) {
+    releaseToCoast(motorNum);
+    LOG_INFO(HW, "Motor" + String(motorNum) + " brake released");
+  }
+
+  if (seq.measuring) {
+    unsigned long elapsed = currentTime - seq.stopStart;
+    if (getMeasuredRpm(motorNum) < STANDSTILL_RPM) {
+      seq.measuring = false;
+      char payload[32];
+      snprintf(payload, sizeof(payload), "%s:%lu", stopModeName(seq.mode), elapsed);
+      publishMotorEvent(motorNum, "standstill", payload);
+      LOG_INFO(HW, "Motor" + String(motorNum) + " standstill after " + String(elapsed) + "ms");
+    } else if (elapsed >= STANDSTILL_TIMEOUT) {
+      seq.measuring = false;
+      LOG_WARN(HW, "Motor" + String(motorNum) + " standstill not reached within timeout");
     }
-    
+  }
+}
+
+const char* motionStateName(MotorMotionState motionState) {
+  switch (motionState) {
+    case MOTION_ACCELERATING: return "ACCELERATING";
+    case MOTION_DECELERATING: return "DECELERATING";
+    case MOTION_AT_SPEED:     return "AT_SPEED";
+    case MOTION_REVERSING:    return "REVERSING";
+    default:                  return "STOPPED";
+  }
+}
+
+// Derived from the commanded profile (for closed-loop motors: the setpoint)
+MotorMotionState getMotorMotionState(int motorNum) {
+  const MotorState& state = getMotorState(motorNum);
+
+  if (state.pendingDirectionChange) return MOTION_REVERSING;
+  if (state.currentSpeed < state.targetSpeed) return MOTION_ACCELERATING;
+  if (state.currentSpeed > state.targetSpeed) return MOTION_DECELERATING;
+  if (state.currentSpeed == 0) return MOTION_STOPPED;
+  return MOTION_AT_SPEED;
+}
+
+// Publishes only transitions: "<STATE>@<uptime ms>"
+static void trackMotionState(int motorNum, unsigned long currentTime) {
+  static MotorMotionState lastState[2] = {MOTION_STOPPED, MOTION_STOPPED};
+
+  MotorMotionState motionState = getMotorMotionState(motorNum);
+  if (motionState == lastState[motorNum - 1]) return;
+  lastState[motorNum - 1] = motionState;
+
+  char payload[32];
+  snprintf(payload, sizeof(payload), "%s@%lu", motionStateName(motionState), currentTime);
+  publishMotorEvent(motorNum, "state", payload);
+  LOGR_DEBUG(HW, "Motor%d state: %s@%lu", motorNum, motionStateName(motionState), currentTime);
+}
+
+// Function: Smooth motor update with custom ramp and direction change support
+void updateMotorSmoothly() {
+  unsigned long currentTime = millis();
+
+  updateSingleMotor(1, motor1State, currentTime);
+  updateSingleMotor(2, motor2State, currentTime);
+
+  updateStopSequence(1, currentTime);
+  updateStopSequence(2, currentTime);
+
+  trackMotionState(1, currentTime);
+  trackMotionState(2, currentTime);
+}
+
+// ON logic shared by percent and RPM commands
+void startMotor(int motorNum, int targetSpd, char targetDir, unsigned long rampDuration) {
+  MotorState& state = getMotorState(motorNum);
+  cancelStopSequence(motorNum);
+
+  state.enabled = true;
+  digitalWrite(enablePinFor(motorNum), HIGH);
+
+  // --- FIX: Detekcia zmeny smeru za behu ---
+  if (state.currentSpeed > 0 && state.direction != targetDir) {
+    LOG_INFO(HW, "Motor" + String(motorNum) + " changing direction while running! Initiating smooth reversal.");
+    state.pendingDirectionChange = true;
+    state.newDirection = targetDir;
+    state.savedSpeed = targetSpd;
+    state.targetSpeed = 0;
+    state.rampActive = false; // Vypneme rampu pre spomalenie
     hardwareOff = false;
+    return; // DÔLEŽITÉ: Nespustiť kód nižšie, kým sa motor neotočí
+  }
+  // -----------------------------------------
+
+  state.direction = targetDir;
+  state.speed = targetSpd;
+  state.pendingDirectionChange = false;
+
+  if (rampDuration > 0) {
+    state.rampActive = true;
+    state.rampDurationMs = rampDuration;
+    state.rampStartTime = millis();
+    state.rampStartSpeed = state.currentSpeed;
+    state.targetSpeed = state.speed;
+  } else {
+    state.targetSpeed = state.speed;
+    state.rampActive = false;
+  }
 
-  } else if (strcmp(command, "OFF") == 0) {
-    // --- FIX: PLYNULÉ ZASTAVENIE ---
-    if (motor2State.enabled) {
-        motor2State.targetSpeed = 0;
-        motor2State.speed = 0;
-        motor2State.rampActive = false;
-        debugPrint("Motor2 stopping smoothly (OFF command)");
-    }
+  hardwareOff = false;
+}
 
-  } else if (strcmp(command, "SPEED") == 0) {
-    if (motor2State.enabled) {
-      motor2State.speed = atoi(speed);
-      motor2State.targetSpeed = motor2State.speed;
-      motor2State.rampActive = false;
-    }
+void stopMotorNow(int motorNum) {
+  MotorState& state = getMotorState(motorNum);
+  cancelStopSequence(motorNum);
 
-  } else if (strcmp(command, "DIR") == 0) {
-    if (motor2State.enabled) {
-      char newDir = direction[0];
-      if (motor2State.direction == newDir) return;
-
-      if (motor2State.currentSpeed > 0) {
-        motor2State.savedSpeed = motor2State.speed;
-        motor2State.newDirection = newDir;
-        motor2State.pendingDirectionChange = true;
-        motor2State.targetSpeed = 0;
-        motor2State.rampActive = false;
-        debugPrint("Motor2 reversing direction via DIR command");
-      } else {
-        motor2State.direction = newDir;
-      }
-    }
+  state.speed = 0;
+  state.targetSpeed = 0;
+  state.currentSpeed = 0;
+  state.rampActive = false;
+  state.pendingDirectionChange = false;
+  state.lastUpdate = millis();
+
+  // Closed-loop motors also get 0 here; the control task then holds 0 for setpoint 0
+  writeMotorDuty(motorNum, 0, state.direction);
+}
+
+void setMotorOutputNow(int motorNum, int speed, char direction) {
+  MotorState& state = getMotorState(motorNum);
+  cancelStopSequence(motorNum);
+
+  if (!state.enabled) {
+    state.enabled = true;
+    digitalWrite(enablePinFor(motorNum), HIGH);
+  }
+
+  state.direction = direction;
+  state.speed = speed;
+  state.targetSpeed = speed;
+  state.currentSpeed = speed;
+  state.rampActive = false;
+  state.pendingDirectionChange = false;
+  state.lastUpdate = millis();
+  hardwareOff = false;
+
+  updateMotorPWM(motorNum, speed, direction);
+}
+
+void holdMotorProfile(int motorNum, bool held) {
+  profileHeld[motorNum - 1] = held;
+}
+
+void applyMotorProfile(int motorNum, int currentSpeed, int targetSpeed, char direction) {
+  MotorState& state = getMotorState(motorNum);
+  cancelStopSequence(motorNum);
+
+  bool outputChanged = !state.enabled || state.currentSpeed != currentSpeed || state.direction != direction;
+  if (!state.enabled) {
+    state.enabled = true;
+    digitalWrite(enablePinFor(motorNum), HIGH);
+  }
+
+  state.direction = direction;
+  state.speed = targetSpeed;
+  state.targetSpeed = targetSpeed;
+  state.currentSpeed = currentSpeed;
+  state.rampActive = false;
+  state.pendingDirectionChange = false;
+  state.lastUpdate = millis();
+  hardwareOff = false;
+
+  if (outputChanged) {
+    updateMotorPWM(motorNum, currentSpeed, direction);
+  }
+}
+
+void setMotorSpeed(int motorNum, int speed) {
+  MotorState& state = getMotorState(motorNum);
+  if (!state.enabled) return;
+
+  cancelStopSequence(motorNum);
+  state.speed = speed;
+  state.targetSpeed = state.speed;
+  state.rampActive = false;
+}
+
+void setMotorDirection(int motorNum, char newDir) {
+  MotorState& state = getMotorState(motorNum);
+  if (!state.enabled || state.direction == newDir) return;
+
+  if (state.currentSpeed > 0) {
+    state.savedSpeed = state.speed;
+    state.newDirection = newDir;
+    state.pendingDirectionChange = true;
+    state.targetSpeed = 0;
+    state.rampActive = false;
+    LOG_INFO(HW, "Motor" + String(motorNum) + " reversing direction via DIR command");
+  } else {
+    state.direction = newDir;
+  }
+}
+
+void offMotor(int motorNum) {
+  // --- FIX: PLYNULÉ ZASTAVENIE --- (režim podľa OFF_STOP_MODE, RAMP = pôvodné správanie)
+  if (getMotorState(motorNum).enabled) {
+    stopMotor(motorNum, OFF_STOP_MODE);
+    // Pri RAMP nechávame enabled = true, kým nedobehne, resp. kým sa nezavolá turnOffHardware
   }
 }
 
+bool controlMotorRpm(int motorNum, float rpm, char direction, unsigned long rampDuration) {
+  if (!isClosedLoop(motorNum)) {
+    LOG_INFO(HW, "Motor" + String(motorNum) + " RPM command rejected - no encoder configured");
+    return false;
+  }
+  if (rpm < 0.0f || rpm > MOTOR_MAX_RPM) {
+    LOG_INFO(HW, "Motor" + String(motorNum) + " RPM out of range: " + String(rpm));
+    return false;
+  }
+
+  // The ramp and direction logic work in percent of MOTOR_MAX_RPM
+  int percent = (int)(rpm * 100.0f / MOTOR_MAX_RPM + 0.5f);
+  LOG_INFO(HW, "Motor" + String(motorNum) + " RPM CMD: " + String(rpm) + " -> " + String(percent) + "%");
+  startMotor(motorNum, percent, direction, rampDuration);
+  return true;
+}
+
 void turnOffHardware() {
   digitalWrite(MOTOR1_ENABLE_PIN, LOW);
   digitalWrite(MOTOR2_ENABLE_PIN, LOW);
@@ -311,10 +512,30 @@ void turnOffHardware() {
   ledcWrite(MOTOR1_RIGHT_PIN, 0);
   ledcWrite(MOTOR2_LEFT_PIN, 0);
   ledcWrite(MOTOR2_RIGHT_PIN, 0);
+  motorDuty[0] = 0;
+  motorDuty[1] = 0;
 
   motor1State = {false, 0, 0, 0, 'S', 0, false, 0, 0, false, 0, 0, 0};
   motor2State = {false, 0, 0, 0, 'S', 0, false, 0, 0, false, 0, 0, 0};
 
-  debugPrint("All motors turned OFF (Hard Reset)");
+  // Coast: a pending standstill measurement keeps running
+  for (int i = 0; i < 2; i++) {
+    stopSequences[i].brakePending = false;
+    stopSequences[i].braking = false;
+  }
+
+  LOG_INFO(HW, "All motors turned OFF (Hard Reset)");
   hardwareOff = true;
-}
\ No newline at end of file
+}
+
+// Stage watchdog monitor task while loop() is stuck: disables both bridges
+// without touching the motor state (owned by loop(), reset by turnOffHardware()).
+// The speed task may still write duty, the disabled bridge ignores it.
+void forceOutputsOff() {
+  digitalWrite(MOTOR1_ENABLE_PIN, LOW);
+  digitalWrite(MOTOR2_ENABLE_PIN, LOW);
+  ledcWrite(MOTOR1_LEFT_PIN, 0);
+  ledcWrite(MOTOR1_RIGHT_PIN, 0);
+  ledcWrite(MOTOR2_LEFT_PIN, 0);
+  ledcWrite(MOTOR2_RIGHT_PIN, 0);
+}
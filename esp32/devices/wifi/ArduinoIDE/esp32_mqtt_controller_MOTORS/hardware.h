@@ -1,14 +1,50 @@
 #ifndef HARDWARE_H
 #define HARDWARE_H
 
+#include "config.h"
+
 // Hardware control functions
 void initializeHardware();
 
-// ZMENENÉ: Pridanie voliteľného rampTime parametra
-void controlMotor1(const char* command, const char* speed = "50", const char* direction = "L", const char* rampTime = "0");
-void controlMotor2(const char* command, const char* speed = "50", const char* direction = "L", const char* rampTime = "0");
+// Closed-loop start: speed given in RPM. Returns false if the motor has no
+// encoder or the RPM is outside 0..MOTOR_MAX_RPM.
+bool controlMotorRpm(int motorNum, float rpm, char direction, unsigned long rampDuration = 0);
+
+// Typed ON logic (ramp + smooth reversal), used by commands and motion modes
+void startMotor(int motorNum, int targetSpd, char targetDir, unsigned long rampDuration);
+
+// Typed OFF / SPEED / DIR of an enabled motor
+void offMotor(int motorNum);
+void setMotorSpeed(int motorNum, int speed);
+void setMotorDirection(int motorNum, char direction);
+
+// OFF / STOP with a selectable stop mode (see StopMode in config.h). maxDecel (%/s, > 0)
+// overrides STOP_RAMP_MAX_DECEL for a RAMP stop (current faults); brake modes are unaffected.
+void stopMotor(int motorNum, StopMode mode, int maxDecel = 0);
+bool parseStopMode(const char* name, size_t length, StopMode* mode);  // name need not be NUL-terminated
+
+// True while both bridge legs are held for a short brake – the speed task must not write
+bool isMotorBraking(int motorNum);
+
+// Immediate stop of one motor without ramp (position targets), bridge stays enabled
+void stopMotorNow(int motorNum);
+
+// Direct output for on-device profiles (trajectories): no ramp, no reversal handling
+void setMotorOutputNow(int motorNum, int speed, char direction);
+
+// Profile owned by an external generator (sync group): updateMotorSmoothly() leaves the
+// motor alone while held, applyMotorProfile() writes the ramp value it computed
+void holdMotorProfile(int motorNum, bool held);
+void applyMotorProfile(int motorNum, int currentSpeed, int targetSpeed, char direction);
 
 void turnOffHardware();
+void forceOutputsOff();   // Bridges only, callable from another task (stage watchdog)
+
+// Raw bridge output (duty 0..2^PWM_RESOLUTION-1) – used by the speed control task
+void writeMotorDuty(int motorNum, int duty, char direction);
+
+// Last duty written to the bridge in % (open- or closed-loop)
+float getMotorDutyPercent(int motorNum);
 
 // Hardware state
 extern bool hardwareOff;
@@ -21,7 +57,7 @@ struct MotorState {
   int targetSpeed;         // Cieľová rýchlosť
   char direction;          // Aktuálny smer ('L' alebo 'R')
   unsigned long lastUpdate;  // Čas posledného update
-  
+
   // NOVÉ polia pre zmenu smeru:
   bool pendingDirectionChange;  // Či čaká na zmenu smeru
   char newDirection;            // Nový smer na ktorý sa má zmeniť
@@ -37,7 +73,21 @@ struct MotorState {
 extern MotorState motor1State;
 extern MotorState motor2State;
 
+MotorState& getMotorState(int motorNum);
+
+// Motion state published on <prefix>motorN/state when updateMotorSmoothly() crosses it
+enum MotorMotionState {
+  MOTION_STOPPED,
+  MOTION_ACCELERATING,
+  MOTION_DECELERATING,
+  MOTION_AT_SPEED,
+  MOTION_REVERSING
+};
+
+MotorMotionState getMotorMotionState(int motorNum);
+const char* motionStateName(MotorMotionState motionState);
+
 // Smooth control function - volaj v main loop
 void updateMotorSmoothly();
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,228 @@
+#include "motion_control.h"
+#include "config.h"
+#include "debug.h"
+#include "encoder_manager.h"
+#include "hardware.h"
+#include "mqtt_manager.h"
+
+enum MotionMode {
+  MOTION_IDLE,
+  MOTION_MOVE,
+  MOTION_HOME
+};
+
+struct MotionState {
+  MotionMode mode;
+  float position;            // Counts or dead-reckoning ms at MOTION_SPEED
+  long target;
+  int moveSpeed;
+  bool homed;
+  const char* completeLabel; // "MOVE" or "HOME" – payload of motion/complete
+  unsigned long lastUpdate;
+  int32_t lastEncoderCount;
+  unsigned long homeStartTime;
+};
+
+static MotionState motions[2] = {};
+
+// Latched by the ISR so a short index pulse is not missed between loop passes
+static volatile bool homeTriggered[2] = {false, false};
+
+static void IRAM_ATTR onHome1() { homeTriggered[0] = true; }
+static void IRAM_ATTR onHome2() { homeTriggered[1] = true; }
+
+static int homePinFor(int motorNum) {
+  return (motorNum == 1) ? MOTOR1_HOME_PIN : MOTOR2_HOME_PIN;
+}
+
+// Level check as well: no edge comes if the carriage already sits on the end-stop
+static bool homeReached(int motorNum) {
+  int homePin = homePinFor(motorNum);
+  return homeTriggered[motorNum - 1] || (homePin >= 0 && digitalRead(homePin) == HOME_PIN_ACTIVE_LEVEL);
+}
+
+static int directionSign(char direction) {
+  if (direction == 'R') return 1;
+  if (direction == 'L') return -1;
+  return 0;
+}
+
+void initializeMotion() {
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    MotionState& motion = motions[motorNum - 1];
+    motion.mode = MOTION_IDLE;
+    motion.completeLabel = "MOVE";
+    motion.lastUpdate = millis();
+    motion.lastEncoderCount = readEncoderCount(motorNum);
+
+    int homePin = homePinFor(motorNum);
+    if (homePin >= 0) {
+      pinMode(homePin, INPUT_PULLUP);
+      attachInterrupt(digitalPinToInterrupt(homePin), (motorNum == 1) ? onHome1 : onHome2,
+                      HOME_PIN_ACTIVE_LEVEL == LOW ? FALLING : RISING);
+      LOG_INFO(MOTION, "Motor" + String(motorNum) + " home input on GPIO " + String(homePin));
+    }
+  }
+}
+
+// Keeps the position current in every mode, manual commands included
+static void integratePosition(int motorNum, MotionState& motion, unsigned long currentTime) {
+  const MotorState& state = getMotorState(motorNum);
+
+  if (hasEncoder(motorNum)) {
+    int32_t count = readEncoderCount(motorNum);
+    int32_t delta = count - motion.lastEncoderCount;
+    motion.lastEncoderCount = count;
+    // A tach line only counts up, the sign comes from the commanded direction
+    motion.position += isQuadratureEncoder(motorNum) ? delta : abs(delta) * directionSign(state.direction);
+  } else {
+    unsigned long dt = currentTime - motion.lastUpdate;
+    motion.position += (float)dt * state.currentSpeed / MOTION_SPEED * directionSign(state.direction);
+  }
+  motion.lastUpdate = currentTime;
+}
+
+static void finishMotion(int motorNum, MotionState& motion) {
+  stopMotorNow(motorNum);
+  motion.mode = MOTION_IDLE;
+
+  char payload[16];
+  snprintf(payload, sizeof(payload), "%ld", getMotorPosition(motorNum));
+  publishMotorEvent(motorNum, "position", payload);
+  publishMotorEvent(motorNum, "motion/complete", motion.completeLabel);
+  LOG_INFO(MOTION, "Motor" + String(motorNum) + " motion complete: " + String(motion.completeLabel) + " @ " + String(payload));
+}
+
+static void updateMove(int motorNum, MotionState& motion) {
+  MotorState& state = getMotorState(motorNum);
+
+  // Still braking for a reversal – direction is not the travel direction yet
+  if (state.pendingDirectionChange) return;
+
+  float remaining = (motion.target - motion.position) * directionSign(state.direction);
+  long tolerance = hasEncoder(motorNum) ? MOTION_TOLERANCE_COUNTS : 0;
+
+  // Reached or passed the target (remaining is measured along the travel direction)
+  if (remaining <= tolerance) {
+    finishMotion(motorNum, motion);
+    return;
+  }
+
+  long slowdownZone = hasEncoder(motorNum) ? MOTION_SLOWDOWN_COUNTS : MOTION_SLOWDOWN_MS;
+  if (remaining < slowdownZone && state.targetSpeed > MOTION_APPROACH_SPEED) {
+    state.speed = MOTION_APPROACH_SPEED;
+    state.targetSpeed = MOTION_APPROACH_SPEED;
+    state.rampActive = false;
+  }
+}
+
+static void completeHoming(int motorNum, MotionState& motion) {
+  motion.position = 0;
+  motion.lastEncoderCount = readEncoderCount(motorNum);
+  motion.homed = true;
+  finishMotion(motorNum, motion);
+}
+
+static void updateHome(int motorNum, MotionState& motion, unsigned long currentTime) {
+  // The level is the backstop for an edge the ISR missed
+  if (homeReached(motorNum)) {
+    completeHoming(motorNum, motion);
+    return;
+  }
+
+  if (currentTime - motion.homeStartTime > HOMING_TIMEOUT) {
+    stopMotorNow(motorNum);
+    motion.mode = MOTION_IDLE;
+    publishMotorEvent(motorNum, "motion/error", "HOME_TIMEOUT");
+    LOG_WARN(MOTION, "Motor" + String(motorNum) + " homing timeout - end-stop not reached");
+  }
+}
+
+void updateMotion() {
+  unsigned long currentTime = millis();
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    MotionState& motion = motions[motorNum - 1];
+    integratePosition(motorNum, motion, currentTime);
+
+    if (motion.mode == MOTION_IDLE) continue;
+
+    // STOP / turnOffHardware / safety shutdown aborts the motion without an event
+    if (!getMotorState(motorNum).enabled) {
+      motion.mode = MOTION_IDLE;
+      LOG_INFO(MOTION, "Motor" + String(motorNum) + " motion aborted (motor disabled)");
+      continue;
+    }
+
+    if (motion.mode == MOTION_MOVE) {
+      updateMove(motorNum, motion);
+    } else if (motion.mode == MOTION_HOME) {
+      updateHome(motorNum, motion, currentTime);
+    }
+  }
+}
+
+static bool beginMove(int motorNum, long target, int speed, const char* completeLabel) {
+  if (speed <= 0 || speed > 100) return false;
+
+  MotionState& motion = motions[motorNum - 1];
+  motion.completeLabel = completeLabel;
+  motion.target = target;
+  motion.moveSpeed = speed;
+  motion.mode = MOTION_MOVE;
+
+  float distance = target - motion.position;
+  LOG_INFO(MOTION, "Motor" + String(motorNum) + " MOVE " + String((long)motion.position) + " -> " + String(target));
+
+  long tolerance = hasEncoder(motorNum) ? MOTION_TOLERANCE_COUNTS : 0;
+  if (fabsf(distance) <= tolerance) {
+    finishMotion(motorNum, motion);
+    return true;
+  }
+
+  // Reversal while running goes through the normal smooth stop; updateMove
+  // only measures along the new direction once the flip is done
+  startMotor(motorNum, speed, distance > 0 ? 'R' : 'L', 0);
+  return true;
+}
+
+bool startMove(int motorNum, long target, int speed) {
+  return beginMove(motorNum, target, speed, "MOVE");
+}
+
+bool startHoming(int motorNum) {
+  if (homePinFor(motorNum) < 0) {
+    // Dead-reckoning fallback: return to the position the board booted / last homed at
+    LOG_INFO(MOTION, "Motor" + String(motorNum) + " HOME without end-stop -> dead-reckoning to 0");
+    return beginMove(motorNum, 0, MOTION_SPEED, "HOME");
+  }
+
+  MotionState& motion = motions[motorNum - 1];
+  motion.completeLabel = "HOME";
+  homeTriggered[motorNum - 1] = false;
+  motion.mode = MOTION_HOME;
+  motion.homeStartTime = millis();
+
+  // Already on the end-stop: homed without driving into it
+  if (homeReached(motorNum)) {
+    LOG_INFO(MOTION, "Motor" + String(motorNum) + " HOME: end-stop already active");
+    completeHoming(motorNum, motion);
+    return true;
+  }
+
+  startMotor(motorNum, HOMING_SPEED, HOMING_DIRECTION, 0);
+  LOG_INFO(MOTION, "Motor" + String(motorNum) + " HOME started");
+  return true;
+}
+
+void cancelMotion(int motorNum) {
+  MotionState& motion = motions[motorNum - 1];
+  if (motion.mode != MOTION_IDLE) {
+    LOG_INFO(MOTION, "Motor" + String(motorNum) + " motion cancelled by manual command");
+  }
+  motion.mode = MOTION_IDLE;
+}
+
+long getMotorPosition(int motorNum) {
+  return lroundf(motions[motorNum - 1].position);
+}
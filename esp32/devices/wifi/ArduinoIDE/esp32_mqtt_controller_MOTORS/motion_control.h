@@ -0,0 +1,23 @@
+#ifndef MOTION_CONTROL_H
+#define MOTION_CONTROL_H
+
+// Position / homing mode on top of the speed ramp logic.
+// Position unit: encoder counts if an encoder is wired, otherwise
+// dead-reckoning "ms at MOTION_SPEED" integrated from the commanded speed.
+void initializeMotion();
+
+// Call every loop() pass after updateMotorSmoothly()
+void updateMotion();
+
+// MOVE:<target>[:<speed>] – absolute target relative to the home position
+bool startMove(int motorNum, long target, int speed);
+
+// HOME – run to the end-stop / index input, or back to 0 by dead-reckoning
+bool startHoming(int motorNum);
+
+// Manual ON/OFF/SPEED/DIR/RPM take the motor back from the motion mode
+void cancelMotion(int motorNum);
+
+long getMotorPosition(int motorNum);
+
+#endif
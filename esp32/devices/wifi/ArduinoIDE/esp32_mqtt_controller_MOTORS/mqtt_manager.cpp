@@ -2,7 +2,17 @@
 #include "config.h"
 #include "debug.h"
 #include "hardware.h"
+#include "speed_control.h"
+#include "motion_control.h"
+#include "trajectory.h"
+#include "current_sense.h"
+#include "telemetry.h"
+#include "sync_control.h"
 #include "wifi_manager.h"
+#include <museum_command.h>
+#include <museum_metrics.h>
+#include <museum_log_crash.h>
+#include <museum_log_flight.h>
 
 // Global MQTT objects and state
 WiFiClient wifiClient;
@@ -12,55 +22,321 @@ unsigned long lastMqttAttempt = 0;
 unsigned long lastStatusPublish = 0;
 unsigned long lastCommandTime = 0;
 String STATUS_TOPIC = String("devices/") + CLIENT_ID + "/status";
+String LOG_TOPIC     = String("devices/") + CLIENT_ID + "/log";
+String LOG_SET_TOPIC = LOG_TOPIC + "/set";
+String TIMING_TOPIC    = String("devices/") + CLIENT_ID + "/timing";
+String DIAG_TOPIC      = String("devices/") + CLIENT_ID + "/diag";
+String DIAG_GET_TOPIC  = DIAG_TOPIC + "/get";
+String DIAG_WARN_TOPIC = DIAG_TOPIC + "/warn";
+String CRASH_TOPIC     = String("devices/") + CLIENT_ID + "/crash";
+String FLIGHT_TOPIC     = String("devices/") + CLIENT_ID + "/flight";
+String FLIGHT_GET_TOPIC = FLIGHT_TOPIC + "/get";
+String BENCH_TOPIC     = String("devices/") + CLIENT_ID + "/bench";
+String BENCH_SET_TOPIC = BENCH_TOPIC + "/set";
+
+// Flight recorder topic indices (devices/<id>/flight)
+static const char* const FLIGHT_TOPICS[] = {"motor1", "motor2", "motors/sync", "STOP"};
+static const uint8_t FLIGHT_TOPIC_COUNT = sizeof(FLIGHT_TOPICS) / sizeof(FLIGHT_TOPICS[0]);
+
+// Runs one parsed motor command. Returns false if the motor refused it (no encoder, homing failed...);
+// *parseError is set when the TRAJ sub-command, which has its own grammar, is malformed.
+static bool executeMotorCommand(int motorNum, const MotorCommand& cmd, CmdError* parseError) {
+  switch (cmd.type) {
+    case MOTOR_CMD_TRAJ: {
+      bool accepted = false;
+      *parseError = handleTrajectoryCommand(motorNum, cmd.arg, &accepted);
+      return accepted;
+    }
+
+    case MOTOR_CMD_TELEMETRY:
+      return setTelemetryInterval(motorNum, cmd.intervalMs);
+
+    case MOTOR_CMD_MOVE:
+      return startMove(motorNum, cmd.target, cmd.hasSpeed ? cmd.speed : MOTION_SPEED);
+
+    case MOTOR_CMD_HOME:
+      return startHoming(motorNum);
+
+    case MOTOR_CMD_ON:
+      LOGR_DEBUG(MQTT, "Motor%d CMD: ON Spd:%d Dir:%c", motorNum, (int)cmd.speed, cmd.direction);
+      startMotor(motorNum, cmd.speed, cmd.direction, cmd.rampMs);
+      return true;
+
+    case MOTOR_CMD_RPM:
+      return controlMotorRpm(motorNum, cmd.rpm, cmd.direction, cmd.rampMs);
+
+    case MOTOR_CMD_OFF: {
+      if (cmd.arg.len == 0) {
+        offMotor(motorNum);
+        return true;
+      }
+      StopMode mode;
+      if (!parseStopMode(cmd.arg.ptr, cmd.arg.len, &mode)) {
+        LOG_WARN(MQTT, "Unknown stop mode");
+        return false;
+      }
+      stopMotor(motorNum, mode);
+      return true;
+    }
+
+    case MOTOR_CMD_SPEED:
+      setMotorSpeed(motorNum, cmd.speed);
+      return true;
+
+    case MOTOR_CMD_DIR:
+      setMotorDirection(motorNum, cmd.direction);
+      return true;
+  }
+  return false;
+}
+
+static void publishFeedback(const char* feedbackTopic, const char* feedback) {
+  if (client.publish(feedbackTopic, feedback, false)) {
+    LOGF_DEBUG(MQTT, "Feedback: %s -> %s", feedback, feedbackTopic);
+  } else {
+    LOG_WARN(MQTT, "Failed to publish feedback");
+  }
+}
+
+// Remote log: batches from the MuseumLog stream, published only from mqttLoop()
+static bool publishLogBatch(const char* payload, size_t length) {
+  return client.publish(LOG_TOPIC.c_str(), (const uint8_t*)payload, length, false);
+}
+
+// devices/<id>/log/set = OFF | ON[:<ERROR|WARN|INFO|DEBUG>]
+static void handleLogCommand(const char* topic, const char* message, unsigned int length) {
+  char feedbackTopic[96];
+  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+
+  uint8_t level;
+  CmdError parseError = parseLogCommand(message, length, &level);
+  if (parseError != CMD_OK) {
+    char feedback[24];
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+    publishFeedback(feedbackTopic, feedback);
+    return;
+  }
+
+  logStreamSetLevel(level);
+  publishFeedback(feedbackTopic, "OK");
+  LOGF_INFO(MQTT, "Remote log: %s", level == LOG_LEVEL_NONE ? "OFF" : logLevelName(level));
+}
+
+// Task / heap diagnostics, published only from systemDiagLoop() in mqttLoop()
+static bool publishDiag(const char* payload) {
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_TOPIC.c_str(), payload, false);
+}
+
+static bool publishDiagWarning(const char* payload) {
+  LOGF_WARN(MQTT, "Diagnostics: %s", payload);
+  if (!isMqttConnected()) return false;
+  return client.publish(DIAG_WARN_TOPIC.c_str(), payload, false);
+}
+
+// Crash record of the previous boot (panic / WDT / brownout) - once, retained
+static void publishCrashRecord() {
+  static char payload[CRASH_PAYLOAD_MAX];
+  if (crashFormat(payload, sizeof(payload)) == 0) {
+    crashAcknowledge();
+    return;
+  }
+  if (client.publish(CRASH_TOPIC.c_str(), payload, true)) {
+    LOGF_WARN(MQTT, "Crash record sent: %s", payload);
+    crashAcknowledge();
+  }
+}
+
+static uint8_t flightTopicIndex(const char* deviceType) {
+  for (uint8_t i = 0; i < FLIGHT_TOPIC_COUNT; i++) {
+    if (strcmp(FLIGHT_TOPICS[i], deviceType) == 0) return i;
+  }
+  return FLIGHT_TOPIC_NONE;
+}
+
+static const char* flightTopicName(uint8_t topic) {
+  return topic < FLIGHT_TOPIC_COUNT ? FLIGHT_TOPICS[topic] : nullptr;
+}
+
+// Flight recorder dump on request (devices/<id>/flight/get), sent from mqttLoop()
+static bool flightDumpRequested = false;
+
+static void publishFlightDump() {
+  static char payload[FLIGHT_PAYLOAD_MAX];
+  flightDumpRequested = false;
+  if (flightFormat(payload, sizeof(payload)) == 0) {
+    LOG_WARN(MQTT, "Flight recorder: dump does not fit");
+    return;
+  }
+  client.publish(FLIGHT_TOPIC.c_str(), payload, false);
+}
+
+// Benchmark only with both bridges disabled - the synthetic OFF:COAST then changes nothing
+static bool motorsIdle() {
+  return !getMotorState(1).enabled && !getMotorState(2).enabled;
+}
+
+// devices/<id>/bench/set (or "bench ..." on Serial) = START[:<commands/s>[:<ms per step>]] | STOP
+static const char* handleBenchCommand(const char* message, unsigned int length) {
+  static char feedback[24];
+  BenchCommand command;
+  CmdError parseError = parseBenchCommand(message, length, &command);
+  if (parseError != CMD_OK) {
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+    return feedback;
+  }
+
+  if (!command.start) {
+    benchStop("stop");
+    return "OK";
+  }
+  if (benchRunning() || !motorsIdle()) {
+    LOG_WARN(MQTT, "Benchmark refused: already running or a motor is enabled");
+    return "ERROR";
+  }
+  benchStart(command.maxRate, command.stepMs);
+  LOGF_INFO(MQTT, "Benchmark: up to %u commands/s, %u ms per step", command.maxRate, command.stepMs);
+  return "OK";
+}
+
+// Benchmark report on devices/<id>/bench and on Serial
+static void publishBenchReport() {
+  static char payload[BENCH_PAYLOAD_MAX];
+  if (benchFormat(payload, sizeof(payload)) == 0) {
+    LOG_WARN(MQTT, "Benchmark: report does not fit");
+    return;
+  }
+  Serial.println(payload);
+  if (isMqttConnected()) client.publish(BENCH_TOPIC.c_str(), payload, false);
+}
+
+// Serial commands without blocking loop(): "bench START[:<commands/s>[:<ms>]]" | "bench STOP"
+static void pollSerialCommand() {
+  static char line[48];
+  static uint8_t used = 0;
+  static bool overflow = false;
+
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (used < sizeof(line) - 1) line[used++] = c;
+      else overflow = true;
+      continue;
+    }
+
+    line[used] = '\0';
+    if (!overflow && strncmp(line, "bench ", 6) == 0) {
+      Serial.printf("bench: %s\n", handleBenchCommand(line + 6, used - 6));
+    } else if (used > 0) {
+      Serial.println("Unknown command. Usage: bench START[:<commands/s>[:<ms>]] | bench STOP");
+    }
+    used = 0;
+    overflow = false;
+  }
+}
 
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
+  // The payload is parsed in place as a (pointer, length) view – no copy, no NUL terminator
+  const char* message = (const char*)payload;
+
+  // LOGF – no String, message is not NUL-terminated
+  LOGF_DEBUG(MQTT, "topic: %s, message: %.*s", topic, (int)length, message);
+
+  // --- Remote log switch (devices/<id>/log/set) ---
+  if (LOG_SET_TOPIC == topic) {
+    handleLogCommand(topic, message, length);
+    return;
+  }
 
-  // --- Guard: message size limit ---
-  if (length >= 64) {
-    debugPrint("MQTT: Payload too long, ignoring");
+  // --- On-demand diagnostics (devices/<id>/diag/get) ---
+  if (DIAG_GET_TOPIC == topic) {
+    systemDiagRequest();
     return;
   }
 
-  // Stack-allocated message buffer – no heap
-  char message[64];
-  memcpy(message, payload, length);
-  message[length] = '\0';
+  // --- On-demand flight recorder dump (devices/<id>/flight/get) ---
+  if (FLIGHT_GET_TOPIC == topic) {
+    flightDumpRequested = true;
+    return;
+  }
 
-  // Use Serial directly here – topic and message are already char*, no String needed
-  if (DEBUG) {
-    Serial.print("[DEBUG] "); Serial.print(millis()); Serial.print("ms - MQTT topic: ");   Serial.println(topic);
-    Serial.print("[DEBUG] "); Serial.print(millis()); Serial.print("ms - MQTT message: "); Serial.println(message);
+  // --- Synthetic load benchmark (devices/<id>/bench/set) ---
+  if (BENCH_SET_TOPIC == topic) {
+    char feedbackTopic[96];
+    snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+    publishFeedback(feedbackTopic, handleBenchCommand(message, length));
+    return;
   }
 
   // --- Ignore feedback / status topics to prevent loops ---
   if (strstr(topic, "/feedback") != nullptr || strstr(topic, "/status") != nullptr) {
-    debugPrint("Ignoring feedback/status topic");
+    LOG_DEBUG(MQTT, "Ignoring feedback/status topic");
     return;
   }
 
   // --- Verify topic starts with BASE_TOPIC_PREFIX ---
   size_t prefixLen = strlen(BASE_TOPIC_PREFIX);
   if (strncmp(topic, BASE_TOPIC_PREFIX, prefixLen) != 0) {
-    debugPrint("Ignoring out-of-prefix topic");
+    LOG_DEBUG(MQTT, "Ignoring out-of-prefix topic");
     return;
   }
 
-  // feedbackTopic = topic + "/feedback" – stack only
+  // A real command ends a running benchmark - the measurement would no longer hold
+  bool synthetic = benchInjecting();
+  if (!synthetic && benchRunning()) benchStop("command");
+
+  // Last commands in RTC memory - part of the crash record after a reset. Flight recorder:
+  // received here, result and apply time once executed (flightComplete). Synthetic benchmark
+  // commands would overwrite the real command history - without flightReceive() the
+  // flightComplete() calls are no-ops.
+  if (!synthetic) {
+    crashNoteCommand(topic + prefixLen, message, length);
+    flightReceive(flightTopicIndex(topic + prefixLen), message, length);
+  }
+
+  // feedbackTopic = topic + "/feedback" – stack only; synthetic commands stay off the backend's feedback
   char feedbackTopic[128];
-  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", topic);
+  snprintf(feedbackTopic, sizeof(feedbackTopic), "%s/feedback", synthetic ? BENCH_TOPIC.c_str() : topic);
 
   // deviceType = everything after the prefix  e.g. "motor1", "STOP"
   const char* deviceType = topic + prefixLen;
 
   bool commandSuccessful = false;
+  CmdError parseError = CMD_OK;
 
   // -------------------------------------------------------------------------
   // STOP
   // -------------------------------------------------------------------------
   if (strcmp(deviceType, "STOP") == 0) {
-    turnOffHardware();
+    cancelSync();
+    cancelTrajectory(1);
+    cancelTrajectory(2);
+
+    // Payload may name a stop mode, anything else ("STOP") uses STOP_TOPIC_MODE
+    StopMode mode = STOP_TOPIC_MODE;
+    parseStopMode(message, length, &mode);
+    stopMotor(1, mode);
+    stopMotor(2, mode);
+    if (mode == STOP_MODE_COAST) {
+      turnOffHardware();
+    }
     commandSuccessful = true;
-    debugPrint("STOP command executed");
+    LOG_INFO(MQTT, "STOP command executed");
+  }
+
+  // -------------------------------------------------------------------------
+  // motors/sync – both motors in lock-step
+  // -------------------------------------------------------------------------
+  else if (strcmp(deviceType, "motors/sync") == 0) {
+    SyncCommand cmd;
+    parseError = parseSyncCommand(message, length, &cmd);
+    if (parseError == CMD_OK) {
+      commandSuccessful = handleSyncCommand(cmd);
+    }
+    if (!commandSuccessful) {
+      LOG_WARN(MQTT, "Invalid sync command");
+    }
   }
 
   // -------------------------------------------------------------------------
@@ -69,74 +345,21 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
   else if (strcmp(deviceType, "motor1") == 0 || strcmp(deviceType, "motor2") == 0) {
 
     int motorNum = (strcmp(deviceType, "motor1") == 0) ? 1 : 2;
+    MotorCommand cmd;
+    parseError = parseMotorCommand(message, length, &cmd);
 
-    // --- ON:<speed>:<direction>[:<rampTime>] ---
-    if (strncmp(message, "ON:", 3) == 0) {
-      char speed[8]     = "50";
-      char direction[4] = "L";
-      char rampTime[16] = "0";
-
-      // p points to first digit of speed
-      char* p = message + 3;
-      char* col1 = strchr(p, ':');
-
-      if (col1 != nullptr) {
-        // Extract speed
-        size_t speedLen = col1 - p;
-        if (speedLen > 0 && speedLen < sizeof(speed)) {
-          memcpy(speed, p, speedLen);
-          speed[speedLen] = '\0';
-        }
-
-        char* col2 = strchr(col1 + 1, ':');
-        if (col2 != nullptr) {
-          // Format with rampTime: ON:<speed>:<dir>:<ramp>
-          size_t dirLen = col2 - col1 - 1;
-          if (dirLen > 0 && dirLen < sizeof(direction)) {
-            memcpy(direction, col1 + 1, dirLen);
-            direction[dirLen] = '\0';
-          }
-          strncpy(rampTime, col2 + 1, sizeof(rampTime) - 1);
-          rampTime[sizeof(rampTime) - 1] = '\0';
-        } else {
-          // Format without rampTime: ON:<speed>:<dir>
-          strncpy(direction, col1 + 1, sizeof(direction) - 1);
-          direction[sizeof(direction) - 1] = '\0';
-        }
-
-        if (motorNum == 1) controlMotor1("ON", speed, direction, rampTime);
-        else               controlMotor2("ON", speed, direction, rampTime);
-        commandSuccessful = true;
-      } else {
-        debugPrint("ERROR: Malformed ON command – missing speed/direction");
-      }
-    }
-
-    // --- OFF ---
-    else if (strcmp(message, "OFF") == 0) {
-      if (motorNum == 1) controlMotor1("OFF", "0", "S", "0");
-      else               controlMotor2("OFF", "0", "S", "0");
-      commandSuccessful = true;
-    }
-
-    // --- SPEED:<value> ---
-    else if (strncmp(message, "SPEED:", 6) == 0) {
-      const char* speedVal = message + 6;
-      if (motorNum == 1) controlMotor1("SPEED", speedVal, "", "0");
-      else               controlMotor2("SPEED", speedVal, "", "0");
-      commandSuccessful = true;
-    }
-
-    // --- DIR:<value> ---
-    else if (strncmp(message, "DIR:", 4) == 0) {
-      const char* dirVal = message + 4;
-      if (motorNum == 1) controlMotor1("DIR", "", dirVal, "0");
-      else               controlMotor2("DIR", "", dirVal, "0");
-      commandSuccessful = true;
+    if (parseError == CMD_OK) {
+      commandSuccessful = executeMotorCommand(motorNum, cmd, &parseError);
+    } else {
+      LOGF_WARN(MQTT, "Invalid motor command (%s)", cmdErrorName(parseError));
     }
 
-    else {
-      debugPrint("ERROR: Unknown motor command");
+    // Every other valid motor command is manual control and ends a running MOVE/HOME,
+    // trajectory or sync group (TRAJ:START cancels those itself); TELEMETRY does not touch motion
+    if (commandSuccessful && cmd.type != MOTOR_CMD_TRAJ && cmd.type != MOTOR_CMD_TELEMETRY) {
+      cancelSync();
+      cancelTrajectory(motorNum);
+      if (cmd.type != MOTOR_CMD_MOVE && cmd.type != MOTOR_CMD_HOME) cancelMotion(motorNum);
     }
   }
 
@@ -144,28 +367,46 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
   // Unknown device – silently ignore, no feedback
   // -------------------------------------------------------------------------
   else {
-    debugPrint("Ignoring non-motor command");
+    LOG_DEBUG(MQTT, "Ignoring non-motor command");
+    flightComplete(FLIGHT_IGNORED);
     return;
   }
 
-  // --- Publish feedback (stack string, no heap) ---
-  const char* feedback = commandSuccessful ? "OK" : "ERROR";
+  // --- Publish feedback (stack string, no heap): OK, ERROR:<code> for a rejected payload, ERROR if refused ---
   if (commandSuccessful) {
-    lastCommandTime = millis();
-  }
-  if (client.publish(feedbackTopic, feedback, false)) {
-    debugPrint("Feedback: " + String(feedback) + " -> " + String(feedbackTopic));
+    flightComplete(FLIGHT_OK);
+    if (!synthetic) lastCommandTime = millis();
+    publishFeedback(feedbackTopic, "OK");
+  } else if (parseError != CMD_OK) {
+    flightComplete(parseError);
+    char feedback[24];
+    snprintf(feedback, sizeof(feedback), "ERROR:%s", cmdErrorName(parseError));
+    publishFeedback(feedbackTopic, feedback);
   } else {
-    debugPrint("Failed to publish feedback");
+    flightComplete(FLIGHT_REFUSED);
+    publishFeedback(feedbackTopic, "ERROR");
   }
 }
 
 
+// Synthetic benchmark command: OFF:COAST to the motors in turn, through mqttCallback() like a real one
+static void benchInject(uint32_t sequence) {
+  char topic[64];
+  snprintf(topic, sizeof(topic), "%smotor%lu", BASE_TOPIC_PREFIX, (unsigned long)(sequence % 2 + 1));
+  char payload[] = "OFF:COAST";
+  mqttCallback(topic, (byte*)payload, sizeof(payload) - 1);
+}
+
 void initializeMqtt() {
   client.setServer(MQTT_SERVER, MQTT_PORT);
   client.setKeepAlive(MQTT_KEEP_ALIVE);
   client.setCallback(mqttCallback);
-  debugPrint("MQTT configured");
+  client.setBufferSize(LOG_STREAM_BATCH_MAX + 128);   // Remote log batches (default is 256 B)
+
+  SystemThresholds limits = {DIAG_MIN_FREE_HEAP, DIAG_MAX_FRAGMENTATION, DIAG_MIN_STACK_FREE, DIAG_MAX_TASK_CPU};
+  systemDiagBegin(limits, DIAG_CHECK_INTERVAL, DIAG_REPORT_INTERVAL);
+  flightBegin(flightTopicName, FLIGHT_TOPIC_COUNT);
+  LOG_INFO(MQTT, "MQTT configured");
 }
 
 void connectToMqtt() {
@@ -176,11 +417,11 @@ void connectToMqtt() {
   static unsigned long mqttRetryInterval = MQTT_RETRY_INTERVAL;
 
   if (!client.connected() && (currentTime - lastMqttAttempt >= mqttRetryInterval)) {
-    debugPrint("MQTT connecting...");
+    LOG_INFO(MQTT, "MQTT connecting...");
     String willTopic = "devices/" + String(CLIENT_ID) + "/status";
 
     if (client.connect(CLIENT_ID, willTopic.c_str(), 0, true, "offline")) {
-      debugPrint("MQTT connected successfully");
+      LOG_INFO(MQTT, "MQTT connected successfully");
       mqttConnected = true;
       mqttAttempts = 0;
       mqttRetryInterval = MQTT_RETRY_INTERVAL;
@@ -189,18 +430,26 @@ void connectToMqtt() {
       client.subscribe((basePrefix + "motor1").c_str(), 0);
       client.subscribe((basePrefix + "motor2").c_str(), 0);
       client.subscribe((basePrefix + "STOP").c_str(), 0);
-      debugPrint("Subscribed to motor topics");
+      client.subscribe((basePrefix + "motors/sync").c_str(), 0);
+      client.subscribe(LOG_SET_TOPIC.c_str(), 0);
+      client.subscribe(DIAG_GET_TOPIC.c_str(), 0);
+      client.subscribe(FLIGHT_GET_TOPIC.c_str(), 0);
+      client.subscribe(BENCH_SET_TOPIC.c_str(), 0);
+      LOG_INFO(MQTT, "Subscribed to motor topics");
 
       publishStatusImmediate();
       lastStatusPublish = 0; // Reset so next heartbeat interval starts fresh
       lastCommandTime = currentTime;
 
+      // A benchmark cut by the outage would mostly measure the reconnect
+      benchStop("mqtt");
+
     } else {
       mqttAttempts++;
-      debugPrint("MQTT connection failed. Attempt: " + String(mqttAttempts));
+      LOG_WARN(MQTT, "MQTT connection failed. Attempt: " + String(mqttAttempts));
 
       if (mqttAttempts >= MAX_MQTT_ATTEMPTS) {
-        debugPrint("Max MQTT attempts reached. Restarting...");
+        LOGR_ERROR(MQTT, "Max MQTT attempts reached. Restarting...");
         ESP.restart();
       } else {
         mqttRetryInterval = min(mqttRetryInterval * 2, MAX_RETRY_INTERVAL);
@@ -216,6 +465,12 @@ void mqttLoop() {
 
   client.loop();
 
+  // Synthetic load: at most one command per pass, like one packet per client.loop()
+  pollSerialCommand();
+  if (!client.connected()) benchStop("mqtt");
+  benchLoop(benchInject);
+  if (benchReportReady()) publishBenchReport();
+
   static unsigned long lastStatusTime = 0;
   unsigned long currentTime = millis();
 
@@ -223,6 +478,46 @@ void mqttLoop() {
     publishStatus();
     lastStatusTime = currentTime;
   }
+
+  publishMotorSpeeds();
+  publishMotorCurrents();
+  publishMotorTiming();
+
+  // At most one remote log batch per LOG_STREAM_INTERVAL
+  if (isMqttConnected()) logStreamLoop(publishLogBatch);
+
+  // Threshold check every DIAG_CHECK_INTERVAL, full report every DIAG_REPORT_INTERVAL / on request
+  systemDiagLoop(publishDiag, publishDiagWarning);
+
+  if (crashPending() && isMqttConnected()) publishCrashRecord();
+  if (flightDumpRequested && isMqttConnected()) publishFlightDump();
+}
+
+bool publishMotorEvent(int motorNum, const char* subtopic, const char* payload) {
+  if (!isMqttConnected()) return false;
+
+  char eventTopic[64];
+  snprintf(eventTopic, sizeof(eventTopic), "%smotor%d/%s", BASE_TOPIC_PREFIX, motorNum, subtopic);
+  return client.publish(eventTopic, payload, false);
+}
+
+void publishMotorSpeeds() {
+  if (SPEED_PUBLISH_INTERVAL == 0) return;
+
+  static unsigned long lastSpeedPublish = 0;
+  unsigned long currentTime = millis();
+  if (currentTime - lastSpeedPublish < SPEED_PUBLISH_INTERVAL) return;
+  lastSpeedPublish = currentTime;
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    if (!isClosedLoop(motorNum)) continue;
+
+    char speedTopic[64];
+    snprintf(speedTopic, sizeof(speedTopic), "%smotor%d/speed", BASE_TOPIC_PREFIX, motorNum);
+    char payload[16];
+    snprintf(payload, sizeof(payload), "%.1f", getMeasuredRpm(motorNum));
+    client.publish(speedTopic, payload, false);
+  }
 }
 
 void publishStatus() {
@@ -232,22 +527,61 @@ void publishStatus() {
   if (currentTime - lastStatusPublish < STATUS_PUBLISH_INTERVAL) return;
 
   if (client.publish(STATUS_TOPIC.c_str(), "online", true)) {
-    debugPrint("Status published: online");
+    LOG_DEBUG(MQTT, "Status published: online");
     lastStatusPublish = currentTime;
   } else {
-    debugPrint("Failed to publish status");
+    LOG_WARN(MQTT, "Failed to publish status");
   }
 }
 
 void publishStatusImmediate() {
   if (client.publish(STATUS_TOPIC.c_str(), "online", true)) {
-    debugPrint("Immediate status published: online");
+    LOG_INFO(MQTT, "Immediate status published: online");
     lastStatusPublish = millis();
   } else {
-    debugPrint("Failed to publish immediate status");
+    LOG_WARN(MQTT, "Failed to publish immediate status");
   }
 }
 
 bool isMqttConnected() {
   return mqttConnected && client.connected();
-}
\ No newline at end of file
+}
+
+void publishMotorCurrents() {
+  if (CURRENT_PUBLISH_INTERVAL == 0) return;
+
+  static unsigned long lastCurrentPublish = 0;
+  unsigned long currentTime = millis();
+  if (currentTime - lastCurrentPublish < CURRENT_PUBLISH_INTERVAL) return;
+  lastCurrentPublish = currentTime;
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    CurrentWindow window;
+    if (!hasCurrentSense(motorNum) || !takeCurrentWindow(motorNum, &window)) continue;
+
+    char payload[32];
+    snprintf(payload, sizeof(payload), "%.2f/%.2f/%.2f", window.minAmps, window.avgAmps, window.maxAmps);
+    publishMotorEvent(motorNum, "current", payload);
+  }
+}
+
+// loop() stage over its budget (stage watchdog) - same channel as the diag limits
+void publishStageStall(const StageStall& stall) {
+  char payload[96];
+  if (formatStageStall(stall, payload, sizeof(payload)) > 0) publishDiagWarning(payload);
+}
+
+void publishMotorTiming() {
+  if (TIMING_PUBLISH_INTERVAL == 0) return;
+
+  static unsigned long lastTimingPublish = 0;
+  unsigned long currentTime = millis();
+  if (currentTime - lastTimingPublish < TIMING_PUBLISH_INTERVAL) return;
+  lastTimingPublish = currentTime;
+
+  // Window is reset by latenessFormat() even if the publish fails
+  static char payload[LATENESS_PAYLOAD_MAX];
+  if (latenessFormat(payload, sizeof(payload)) > 0 && isMqttConnected()) {
+    client.publish(TIMING_TOPIC.c_str(), payload, false);
+  }
+}
@@ -3,12 +3,18 @@
 
 #include <PubSubClient.h>
 #include <WiFi.h>
+#include "wdt_manager.h"
 
 // MQTT management functions
 void initializeMqtt();
 void connectToMqtt();
 void publishStatus();
 void publishStatusImmediate();  // NOVÁ: Okamžité publikovanie
+void publishMotorSpeeds();      // Measured RPM of closed-loop motors
+void publishMotorCurrents();    // Current min/avg/max per window (current sense only)
+void publishMotorTiming();      // Ramp step lateness per motor on devices/<id>/timing
+void publishStageStall(const StageStall& stall);  // loop() stage over budget -> diag/warn
+bool publishMotorEvent(int motorNum, const char* subtopic, const char* payload); // <prefix>motorN/<subtopic>
 void mqttCallback(char* topic, byte* payload, unsigned int length);
 bool isMqttConnected();
 void mqttLoop();
@@ -0,0 +1,116 @@
+#include "speed_control.h"
+#include "config.h"
+#include "debug.h"
+#include "encoder_manager.h"
+#include "hardware.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Above the Arduino loop task (priority 1) on the same core, WiFi stays on core 0
+static const UBaseType_t SPEED_TASK_PRIORITY = 5;
+static const BaseType_t SPEED_TASK_CORE = 1;
+static const uint32_t SPEED_TASK_STACK = 3072;
+
+struct SpeedLoopState {
+  float measuredRpm;   // Written only by the control task
+  float integral;
+  float lastError;
+  int32_t lastCount;
+};
+
+static SpeedLoopState speedLoops[2] = {};
+static TaskHandle_t speedTaskHandle = nullptr;
+
+static void resetSpeedLoop(SpeedLoopState& loop) {
+  loop.integral = 0.0f;
+  loop.lastError = 0.0f;
+}
+
+// One PID step. Setpoint is the ramped currentSpeed (percent of MOTOR_MAX_RPM),
+// which is also used as feed-forward so the loop only corrects load/supply error.
+static void runSpeedLoop(int motorNum, float dtSeconds) {
+  SpeedLoopState& loop = speedLoops[motorNum - 1];
+  const MotorState& state = getMotorState(motorNum);
+
+  int32_t count = readEncoderCount(motorNum);
+  int32_t delta = count - loop.lastCount;
+  loop.lastCount = count;
+
+  float rawRpm = fabsf((float)delta) * 60.0f / (ENCODER_COUNTS_PER_REV * dtSeconds);
+  loop.measuredRpm += SPEED_FILTER_ALPHA * (rawRpm - loop.measuredRpm);
+
+  // Short brake holds both legs – measure only (same core as loop(), so no torn brake write)
+  if (isMotorBraking(motorNum)) {
+    resetSpeedLoop(loop);
+    return;
+  }
+
+  int setpointPercent = state.currentSpeed;
+  char direction = state.direction;
+
+  if (!state.enabled || setpointPercent == 0) {
+    resetSpeedLoop(loop);
+    writeMotorDuty(motorNum, 0, direction);
+    return;
+  }
+
+  float setpointRpm = setpointPercent * MOTOR_MAX_RPM / 100.0f;
+  float error = setpointRpm - loop.measuredRpm;
+  float derivative = (error - loop.lastError) / dtSeconds;
+  loop.lastError = error;
+
+  float output = setpointPercent + SPEED_KP * error + loop.integral + SPEED_KD * derivative;
+
+  // Anti-windup: stop integrating while the output is saturated in the error direction
+  bool saturatedHigh = output >= 100.0f && error > 0.0f;
+  bool saturatedLow = output <= 0.0f && error < 0.0f;
+  if (!saturatedHigh && !saturatedLow) {
+    loop.integral += SPEED_KI * error * dtSeconds;
+  }
+
+  output = constrain(output, 0.0f, 100.0f);
+  const int maxDuty = (1 << PWM_RESOLUTION) - 1;
+  writeMotorDuty(motorNum, (int)(output * maxDuty / 100.0f + 0.5f), direction);
+}
+
+static void speedControlTask(void* parameter) {
+  const TickType_t period = pdMS_TO_TICKS(SPEED_LOOP_INTERVAL_MS);
+  const float dtSeconds = SPEED_LOOP_INTERVAL_MS / 1000.0f;
+  TickType_t lastWake = xTaskGetTickCount();
+
+  for (;;) {
+    vTaskDelayUntil(&lastWake, period);
+
+    for (int motorNum = 1; motorNum <= 2; motorNum++) {
+      if (hasEncoder(motorNum)) {
+        runSpeedLoop(motorNum, dtSeconds);
+      }
+    }
+  }
+}
+
+void initializeSpeedControl() {
+  initializeEncoders();
+
+  if (!hasEncoder(1) && !hasEncoder(2)) {
+    LOG_INFO(SPEED, "no encoders configured, motors run open-loop");
+    return;
+  }
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    speedLoops[motorNum - 1].lastCount = readEncoderCount(motorNum);
+  }
+
+  xTaskCreatePinnedToCore(speedControlTask, "speed_ctrl", SPEED_TASK_STACK, nullptr,
+                          SPEED_TASK_PRIORITY, &speedTaskHandle, SPEED_TASK_CORE);
+  LOG_INFO(SPEED, "Speed control task started (" + String(SPEED_LOOP_INTERVAL_MS) + "ms loop)");
+}
+
+bool isClosedLoop(int motorNum) {
+  return hasEncoder(motorNum);
+}
+
+float getMeasuredRpm(int motorNum) {
+  if (!hasEncoder(motorNum)) return 0.0f;
+  return speedLoops[motorNum - 1].measuredRpm;
+}
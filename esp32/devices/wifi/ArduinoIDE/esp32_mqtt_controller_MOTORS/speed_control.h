@@ -0,0 +1,14 @@
+#ifndef SPEED_CONTROL_H
+#define SPEED_CONTROL_H
+
+// Closed-loop speed control (PID) for motors with an encoder.
+// Runs in its own FreeRTOS task so WiFi/MQTT work in loop() cannot delay it.
+void initializeSpeedControl();
+
+// True if the motor is regulated by the speed control task
+bool isClosedLoop(int motorNum);
+
+// Filtered measured speed in RPM (0 if the motor has no encoder)
+float getMeasuredRpm(int motorNum);
+
+#endif
@@ -0,0 +1,269 @@
+#include "sync_control.h"
+#include "config.h"
+#include "debug.h"
+#include "hardware.h"
+#include "motion_control.h"
+#include "trajectory.h"
+
+struct SyncGroup {
+  bool active;
+  float ratio;                 // motor2 = motor1 * ratio, negative = opposite direction
+  char direction;              // motor1 direction
+
+  // Shared ramp of the motor1 ("master") speed; the ratio moves over the same ramp
+  int startSpeed;
+  int targetSpeed;
+  int currentSpeed;
+  float startRatio;
+  float targetRatio;
+  unsigned long rampStart;
+  unsigned long rampDuration;
+
+  // Reversal: ramp to 0 first, then continue with the queued ramp
+  bool reversing;
+  char nextDirection;
+  float nextRatio;
+  int nextTarget;
+  unsigned long nextRampDuration;
+
+  bool releaseAtZero;          // OFF: leave sync mode once the ramp reached 0
+
+  // Entry with motor1 at rest and motor2 running: motor2 runs down alone first,
+  // then the queued ramp (next*) starts both from 0
+  bool aligning;
+  int slaveStartSpeed;
+  char slaveDirection;
+};
+
+static SyncGroup group = {};
+
+static char oppositeDirection(char direction) {
+  return (direction == 'L') ? 'R' : 'L';
+}
+
+static char motor2Direction(char direction, float ratio) {
+  return (ratio < 0.0f) ? oppositeDirection(direction) : direction;
+}
+
+static int motor2Speed(int masterSpeed, float ratio) {
+  int speed = (int)(fabsf(masterSpeed * ratio) + 0.5f);
+  return constrain(speed, 0, 100);
+}
+
+// Ramp time used when a command gives none: the same rate as the SMOOTH_STEP ramp
+static unsigned long defaultRampMs(int fromSpeed, int toSpeed) {
+  return (unsigned long)abs(toSpeed - fromSpeed) * SMOOTH_DELAY / SMOOTH_STEP;
+}
+
+static void beginRamp(int targetSpeed, float targetRatio, unsigned long rampDuration, unsigned long now) {
+  group.startSpeed = group.currentSpeed;
+  group.targetSpeed = targetSpeed;
+  group.startRatio = group.ratio;
+  group.targetRatio = targetRatio;
+  group.rampStart = now;
+  group.rampDuration = rampDuration;
+}
+
+static void writeBothMotors() {
+  int speed1 = group.currentSpeed;
+  int speed2 = motor2Speed(speed1, group.ratio);
+
+  // Same pass, same value: both LEDC channels pick up the new duty on the same PWM period
+  applyMotorProfile(1, speed1, group.targetSpeed, group.direction);
+  applyMotorProfile(2, speed2, motor2Speed(group.targetSpeed, group.targetRatio),
+                    motor2Direction(group.direction, group.ratio));
+}
+
+static void releaseMotors() {
+  holdMotorProfile(1, false);
+  holdMotorProfile(2, false);
+  group.active = false;
+}
+
+void initializeSync() {
+  group = {};
+}
+
+bool isSyncActive() {
+  return group.active;
+}
+
+void cancelSync() {
+  if (!group.active) return;
+  releaseMotors();
+  LOG_INFO(SYNC, "Sync group released");
+}
+
+// ON:<speed>:<dir>[:<rampTime>[:<ratio>]]
+static bool startSync(const SyncCommand& cmd) {
+  int speed = cmd.speed;
+  char direction = cmd.direction;
+  float ratio = cmd.ratio;
+  bool rampGiven = cmd.hasRamp;
+  unsigned long rampTime = cmd.rampMs;
+
+  unsigned long now = millis();
+
+  if (!group.active) {
+    // Enter the group from whatever motor1 is doing, both motors are taken over this pass
+    cancelTrajectory(1);
+    cancelTrajectory(2);
+    cancelMotion(1);
+    cancelMotion(2);
+
+    // Start from motor1's actual state and the ratio the pair is running at; the requested
+    // speed and ratio are then reached over the ramp, so neither motor jumps.
+    // With motor1 at rest the group starts at 0 and a running motor2 first ramps down to 0
+    // (aligning), so it is never cut or reversed at speed.
+    const MotorState& master = getMotorState(1);
+    const MotorState& slave = getMotorState(2);
+    group.currentSpeed = master.currentSpeed;
+    group.direction = direction;
+    group.ratio = ratio;
+    group.aligning = false;
+    if (master.currentSpeed == 0 && slave.currentSpeed > 0) {
+      group.aligning = true;
+      group.slaveStartSpeed = slave.currentSpeed;
+      group.slaveDirection = slave.direction;
+      group.rampStart = now;
+      group.rampDuration = defaultRampMs(slave.currentSpeed, 0);
+    } else if (master.currentSpeed > 0) {
+      group.direction = master.direction;
+      float entryRatio = (float)slave.currentSpeed / master.currentSpeed;
+      if (slave.currentSpeed > 0 && slave.direction != master.direction) entryRatio = -entryRatio;
+      group.ratio = constrain(entryRatio, -CMD_MAX_SYNC_RATIO, CMD_MAX_SYNC_RATIO);
+    }
+    holdMotorProfile(1, true);
+    holdMotorProfile(2, true);
+    group.active = true;
+  }
+
+  group.releaseAtZero = false;
+  group.reversing = false;
+
+  if (group.aligning) {
+    // Starts once motor2 reached 0
+    group.nextDirection = direction;
+    group.nextRatio = ratio;
+    group.nextTarget = speed;
+    group.nextRampDuration = rampGiven ? rampTime : defaultRampMs(0, speed);
+    LOG_INFO(SYNC, "Sync ON: " + String(speed) + "% " + String(direction) + " ratio " + String(ratio, 2) +
+               " (motor2 ramping down first)");
+    return true;
+  }
+
+  // A stopped motor2 may start in either direction
+  bool slaveRunning = motor2Speed(group.currentSpeed, group.ratio) > 0;
+  bool directionChange = direction != group.direction ||
+                         (slaveRunning && motor2Direction(direction, ratio) != motor2Direction(group.direction, group.ratio));
+
+  if (directionChange && group.currentSpeed > 0) {
+    // Both motors run down together, flip on the same tick, then ramp up together
+    group.reversing = true;
+    group.nextDirection = direction;
+    group.nextRatio = ratio;
+    group.nextTarget = speed;
+    group.nextRampDuration = rampGiven ? rampTime : defaultRampMs(0, speed);
+    beginRamp(0, group.ratio, defaultRampMs(group.currentSpeed, 0), now);
+  } else {
+    // Without a ramp time the slower of the two speed changes sets the pace
+    if (!rampGiven) {
+      unsigned long slaveRamp = defaultRampMs(motor2Speed(group.currentSpeed, group.ratio), motor2Speed(speed, ratio));
+      rampTime = max(defaultRampMs(group.currentSpeed, speed), slaveRamp);
+    }
+    group.direction = direction;
+    beginRamp(speed, ratio, rampTime, now);
+  }
+
+  LOG_INFO(SYNC, "Sync ON: " + String(speed) + "% " + String(direction) + " ratio " + String(ratio, 2) +
+             (group.reversing ? " (reversing first)" : ""));
+  return true;
+}
+
+// SPEED:<speed>[:<rampTime>] / OFF[:<rampTime>]
+static bool rampSync(const SyncCommand& cmd) {
+  bool off = (cmd.type == SYNC_CMD_OFF);
+  if (!group.active) return off;  // OFF of an idle group is a no-op
+
+  int speed = off ? 0 : cmd.speed;
+  unsigned long rampTime = cmd.hasRamp ? cmd.rampMs : defaultRampMs(group.currentSpeed, speed);
+
+  if (group.reversing || group.aligning) {
+    // Keep running down, only the speed after the flip / alignment changes
+    group.nextTarget = speed;
+    group.nextRampDuration = rampTime;
+    group.releaseAtZero = off;
+    return true;
+  }
+
+  group.releaseAtZero = off;
+  beginRamp(speed, group.targetRatio, rampTime, millis());
+  return true;
+}
+
+bool handleSyncCommand(const SyncCommand& cmd) {
+  if (cmd.type == SYNC_CMD_ON) return startSync(cmd);
+  return rampSync(cmd);
+}
+
+// motor2 alone down to 0 with motor1 held at rest; true once the group ramp can take over
+static bool updateAlignment(unsigned long now) {
+  unsigned long elapsed = now - group.rampStart;
+  int speed2 = 0;
+  if (elapsed < group.rampDuration) {
+    speed2 = group.slaveStartSpeed - (int)((long)group.slaveStartSpeed * (long)elapsed / (long)group.rampDuration);
+  }
+
+  applyMotorProfile(1, 0, 0, group.direction);
+  applyMotorProfile(2, speed2, 0, group.slaveDirection);
+  if (speed2 > 0) return false;
+
+  group.aligning = false;
+  group.currentSpeed = 0;
+  group.direction = group.nextDirection;
+  group.ratio = group.nextRatio;
+  beginRamp(group.releaseAtZero ? 0 : group.nextTarget, group.nextRatio, group.nextRampDuration, now);
+  LOG_INFO(SYNC, "Sync motor2 reached 0, group ramp starts");
+  return true;
+}
+
+void updateSync() {
+  if (!group.active) return;
+
+  // STOP / safety shutdown disabled the bridges
+  if (!getMotorState(1).enabled && !getMotorState(2).enabled) {
+    releaseMotors();
+    LOG_INFO(SYNC, "Sync group aborted (motors disabled)");
+    return;
+  }
+
+  // One time base, one ramp evaluation for both motors
+  unsigned long now = millis();
+  if (group.aligning && !updateAlignment(now)) return;
+
+  unsigned long elapsed = now - group.rampStart;
+
+  if (elapsed >= group.rampDuration) {
+    group.currentSpeed = group.targetSpeed;
+    group.ratio = group.targetRatio;
+  } else {
+    long delta = group.targetSpeed - group.startSpeed;
+    group.currentSpeed = group.startSpeed + (int)(delta * (long)elapsed / (long)group.rampDuration);
+    group.ratio = group.startRatio + (group.targetRatio - group.startRatio) * elapsed / group.rampDuration;
+  }
+
+  if (group.reversing && group.currentSpeed == 0) {
+    group.reversing = false;
+    group.direction = group.nextDirection;
+    group.ratio = group.nextRatio;
+    beginRamp(group.releaseAtZero ? 0 : group.nextTarget, group.nextRatio, group.nextRampDuration, now);
+    LOG_INFO(SYNC, "Sync reached 0, direction " + String(group.direction));
+  }
+
+  writeBothMotors();
+
+  if (group.releaseAtZero && !group.reversing && group.currentSpeed == 0) {
+    releaseMotors();
+    LOG_INFO(SYNC, "Sync OFF complete");
+  }
+}
@@ -0,0 +1,22 @@
+#ifndef SYNC_CONTROL_H
+#define SYNC_CONTROL_H
+
+#include <museum_command.h>
+
+// Lock-step dual-motor mode (<prefix>motors/sync).
+// One ramp is evaluated per loop() pass from one millis() value and written to
+// both motors back to back, motor2 optionally scaled by a speed ratio.
+void initializeSync();
+
+// Call every loop() pass after updateMotorSmoothly()
+void updateSync();
+
+// Payload of <prefix>motors/sync, already validated by parseSyncCommand()
+bool handleSyncCommand(const SyncCommand& cmd);
+
+// Individual motor commands, STOP and faults take both motors back from the group
+void cancelSync();
+
+bool isSyncActive();
+
+#endif
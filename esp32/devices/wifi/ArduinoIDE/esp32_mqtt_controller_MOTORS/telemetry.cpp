@@ -0,0 +1,139 @@
+#include "telemetry.h"
+#include "config.h"
+#include "debug.h"
+#include "hardware.h"
+#include "mqtt_manager.h"
+#include "speed_control.h"
+#include "current_sense.h"
+
+struct Aggregate {
+  float minValue;
+  float maxValue;
+  float sum;
+  uint32_t count;
+};
+
+struct TelemetryStream {
+  unsigned long intervalMs;      // Requested window, 0 = off
+  int backoff;                   // Window multiplier 1, 2, 4 ... TELEMETRY_MAX_BACKOFF
+  int fastPublishes;             // Consecutive good publishes since the last backoff step
+  unsigned long windowStart;
+  Aggregate duty;
+  Aggregate rpm;
+  Aggregate amps;
+};
+
+static TelemetryStream streams[2] = {};
+static unsigned long lastSample = 0;
+
+static void resetAggregate(Aggregate& agg) {
+  agg.count = 0;
+  agg.sum = 0.0f;
+}
+
+static void addSample(Aggregate& agg, float value) {
+  if (agg.count == 0 || value < agg.minValue) agg.minValue = value;
+  if (agg.count == 0 || value > agg.maxValue) agg.maxValue = value;
+  agg.sum += value;
+  agg.count++;
+}
+
+// Appends ,"<key>":[min,avg,max] – nothing if the window has no samples
+static int appendAggregate(char* out, size_t size, const char* key, const Aggregate& agg, int decimals) {
+  if (agg.count == 0 || size == 0) return 0;
+  int written = snprintf(out, size, ",\"%s\":[%.*f,%.*f,%.*f]", key,
+                         decimals, agg.minValue, decimals, agg.sum / agg.count, decimals, agg.maxValue);
+  return (written < 0 || (size_t)written >= size) ? 0 : written;
+}
+
+static void resetWindow(TelemetryStream& stream, unsigned long currentTime) {
+  resetAggregate(stream.duty);
+  resetAggregate(stream.rpm);
+  resetAggregate(stream.amps);
+  stream.windowStart = currentTime;
+}
+
+void initializeTelemetry() {
+  unsigned long currentTime = millis();
+  for (int i = 0; i < 2; i++) {
+    streams[i].intervalMs = TELEMETRY_INTERVAL;
+    streams[i].backoff = 1;
+    streams[i].fastPublishes = 0;
+    resetWindow(streams[i], currentTime);
+  }
+}
+
+bool setTelemetryInterval(int motorNum, unsigned long intervalMs) {
+  if (intervalMs != 0 && intervalMs < TELEMETRY_SAMPLE_INTERVAL) return false;
+
+  TelemetryStream& stream = streams[motorNum - 1];
+  stream.intervalMs = intervalMs;
+  stream.backoff = 1;
+  stream.fastPublishes = 0;
+  resetWindow(stream, millis());
+  LOG_INFO(TELEMETRY, "Motor" + String(motorNum) + " telemetry interval: " + String(intervalMs) + "ms");
+  return true;
+}
+
+static void sampleMotor(int motorNum) {
+  TelemetryStream& stream = streams[motorNum - 1];
+
+  addSample(stream.duty, getMotorDutyPercent(motorNum));
+  if (isClosedLoop(motorNum)) addSample(stream.rpm, getMeasuredRpm(motorNum));
+  if (hasCurrentSense(motorNum)) addSample(stream.amps, getMotorCurrent(motorNum));
+}
+
+// Publish result drives the backoff: PubSubClient writes synchronously, so a full
+// TCP send buffer shows up as a failed or slow publish()
+static void adjustBackoff(int motorNum, TelemetryStream& stream, bool published, unsigned long publishMs) {
+  if (!published || publishMs > TELEMETRY_SLOW_PUBLISH_MS) {
+    stream.fastPublishes = 0;
+    if (stream.backoff < TELEMETRY_MAX_BACKOFF) {
+      stream.backoff *= 2;
+      LOG_INFO(TELEMETRY, "Motor" + String(motorNum) + " telemetry backing off x" + String(stream.backoff));
+    }
+  } else if (stream.backoff > 1 && ++stream.fastPublishes >= TELEMETRY_RECOVER_COUNT) {
+    stream.backoff /= 2;
+    stream.fastPublishes = 0;
+  }
+}
+
+static void publishWindow(int motorNum, TelemetryStream& stream, unsigned long currentTime) {
+  const MotorState& state = getMotorState(motorNum);
+  const char* phase = isMotorBraking(motorNum) ? "BRAKING" : motionStateName(getMotorMotionState(motorNum));
+
+  char payload[200];
+  int len = snprintf(payload, sizeof(payload),
+                     "{\"t\":%lu,\"win\":%lu,\"n\":%lu,\"cmd\":%d,\"sp\":%d,\"dir\":\"%c\",\"phase\":\"%s\"",
+                     currentTime, currentTime - stream.windowStart, (unsigned long)stream.duty.count,
+                     state.speed, state.currentSpeed, state.direction, phase);
+  len += appendAggregate(payload + len, sizeof(payload) - len, "duty", stream.duty, 1);
+  len += appendAggregate(payload + len, sizeof(payload) - len, "rpm", stream.rpm, 1);
+  len += appendAggregate(payload + len, sizeof(payload) - len, "a", stream.amps, 2);
+  snprintf(payload + len, sizeof(payload) - len, "}");
+
+  unsigned long publishStart = millis();
+  bool published = publishMotorEvent(motorNum, "telemetry", payload);
+  adjustBackoff(motorNum, stream, published, millis() - publishStart);
+}
+
+void updateTelemetry() {
+  unsigned long currentTime = millis();
+  if (currentTime - lastSample < TELEMETRY_SAMPLE_INTERVAL) return;
+  lastSample = currentTime;
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    TelemetryStream& stream = streams[motorNum - 1];
+    if (stream.intervalMs == 0) continue;
+
+    sampleMotor(motorNum);
+
+    if (currentTime - stream.windowStart < stream.intervalMs * stream.backoff) continue;
+
+    // Offline: keep the window running, it is published after the reconnect
+    if (!isMqttConnected()) continue;
+
+    publishWindow(motorNum, stream, currentTime);
+    resetWindow(stream, currentTime);
+  }
+}
@@ -0,0 +1,15 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Per-motor telemetry stream on <prefix>motorN/telemetry.
+// Samples every TELEMETRY_SAMPLE_INTERVAL ms, publishes min/avg/max per window
+// and stretches the window while publishing is failing or slow.
+void initializeTelemetry();
+
+// Call every loop() pass
+void updateTelemetry();
+
+// TELEMETRY:<ms> – window length at runtime, 0 = off
+bool setTelemetryInterval(int motorNum, unsigned long intervalMs);
+
+#endif
@@ -0,0 +1,329 @@
+#include "trajectory.h"
+#include "trajectory_config.h"
+#include "config.h"
+#include "debug.h"
+#include "hardware.h"
+#include "motion_control.h"
+#include "mqtt_manager.h"
+#include "sync_control.h"
+#include <sys/time.h>
+
+enum TrajectoryPhase {
+  TRAJ_IDLE,
+  TRAJ_SCHEDULED,
+  TRAJ_RUNNING
+};
+
+struct TrajectoryRun {
+  TrajectorySegment segments[MAX_TRAJECTORY_SEGMENTS];
+  int segmentCount;
+  TrajectoryPhase phase;
+  unsigned long startTime;         // millis() of the scheduled start
+  int segmentIndex;
+  unsigned long segmentStartTime;
+  float segmentStartVelocity;      // Signed: + = 'R', - = 'L'
+};
+
+static TrajectoryRun trajectories[2] = {};
+
+// Unix time below this means SNTP has not synced yet
+static const time_t MIN_VALID_EPOCH = 1600000000;
+
+// Parser limits, far below the 2^31 ms where the signed millis() compares wrap
+static const unsigned long MAX_SEGMENT_MS = 3600000UL;        // 1 h
+static const unsigned long MAX_START_DELAY_MS = 86400000UL;   // 24 h
+
+static float signedVelocity(int speed, char direction) {
+  return (direction == 'L') ? -speed : speed;
+}
+
+// A STEP into the opposite direction would slam the H-bridge – use LIN/EASE through 0
+static bool stepReverses(const TrajectorySegment& segment, float fromVelocity) {
+  if (segment.shape != SHAPE_STEP || segment.speed == 0 || fromVelocity == 0.0f) return false;
+  return (fromVelocity > 0.0f) != (segment.direction == 'R');
+}
+
+static void publishProgress(int motorNum, const TrajectoryRun& run) {
+  char payload[16];
+  snprintf(payload, sizeof(payload), "%d/%d", run.segmentIndex + 1, run.segmentCount);
+  publishMotorEvent(motorNum, "trajectory/progress", payload);
+}
+
+void initializeTrajectories() {
+  for (int i = 0; i < 2; i++) {
+    trajectories[i].segmentCount = 0;
+    trajectories[i].phase = TRAJ_IDLE;
+  }
+
+  // Wall clock only needed for TRAJ:START:@<unixMs>
+  if (strlen(NTP_SERVER) > 0) {
+    configTime(0, 0, NTP_SERVER);
+    LOG_INFO(TRAJ, "SNTP time sync via " + String(NTP_SERVER));
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Upload / load
+// ---------------------------------------------------------------------------
+
+static bool parseShape(CmdToken token, TrajectoryShape* shape) {
+  if (cmdTokenEquals(token, "STEP")) { *shape = SHAPE_STEP;   return true; }
+  if (cmdTokenEquals(token, "LIN"))  { *shape = SHAPE_LINEAR; return true; }
+  if (cmdTokenEquals(token, "EASE")) { *shape = SHAPE_EASE;   return true; }
+  return false;
+}
+
+// "<durationMs>,<speed>,<dir>,<shape>"
+static CmdError parseSegment(CmdToken text, TrajectorySegment* segment) {
+  CmdTokens fields;
+  CmdError error = cmdTokenize(text.ptr, text.len, ',', &fields);
+  if (error != CMD_OK) return error;
+  if (fields.count < 4) return CMD_ERR_MISSING_ARG;
+  if (fields.count > 4) return CMD_ERR_EXTRA_ARG;
+
+  unsigned long duration = 0;
+  long speed = 0;
+  if ((error = cmdParseULong(fields.items[0], MAX_SEGMENT_MS, &duration)) != CMD_OK) return error;
+  if (duration == 0) return CMD_ERR_RANGE;
+  if ((error = cmdParseLong(fields.items[1], 0, CMD_MAX_SPEED, &speed)) != CMD_OK) return error;
+  if ((error = cmdParseDirection(fields.items[2], &segment->direction)) != CMD_OK) return error;
+  if (!parseShape(fields.items[3], &segment->shape)) return CMD_ERR_UNKNOWN;
+
+  segment->durationMs = duration;
+  segment->speed = (int)speed;
+  return CMD_OK;
+}
+
+// ADD:<offset>:<seg>[;<seg>...] – offset must match the segments already
+// received, so a lost or repeated chunk is rejected instead of shifting the show
+static CmdError addSegments(int motorNum, TrajectoryRun& run, const CmdTokens& tokens, bool* accepted) {
+  if (tokens.count < 3) return CMD_ERR_MISSING_ARG;
+  if (tokens.count > 3) return CMD_ERR_EXTRA_ARG;
+
+  long offset = 0;
+  CmdError error = cmdParseLong(tokens.items[1], 0, MAX_TRAJECTORY_SEGMENTS, &offset);
+  if (error != CMD_OK) return error;
+
+  // Parse the whole chunk past the committed segments first
+  CmdToken list = tokens.items[2];
+  int added = 0;
+  uint16_t partStart = 0;
+  for (uint16_t i = 0; i <= list.len; i++) {
+    if (i < list.len && list.ptr[i] != ';') continue;
+    if (run.segmentCount + added >= MAX_TRAJECTORY_SEGMENTS) return CMD_ERR_TOO_LONG;
+
+    CmdToken part = {list.ptr + partStart, (uint16_t)(i - partStart)};
+    error = parseSegment(part, &run.segments[run.segmentCount + added]);
+    if (error != CMD_OK) return error;
+    added++;
+    partStart = i + 1;
+  }
+
+  if (run.phase != TRAJ_IDLE) return CMD_OK;
+  if (offset != run.segmentCount) {
+    LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + ": chunk offset " + String(offset) + " != " + String(run.segmentCount));
+    return CMD_OK;
+  }
+
+  // Segment 0 is checked against the motor's actual velocity at START
+  for (int index = max(run.segmentCount, 1); index < run.segmentCount + added; index++) {
+    const TrajectorySegment& previous = run.segments[index - 1];
+    if (stepReverses(run.segments[index], signedVelocity(previous.speed, previous.direction))) return CMD_OK;
+  }
+
+  // Commit the whole chunk only when every segment parsed
+  run.segmentCount += added;
+  *accepted = true;
+  return CMD_OK;
+}
+
+static bool loadStored(int motorNum, TrajectoryRun& run, CmdToken name) {
+  for (int i = 0; i < STORED_TRAJECTORY_COUNT; i++) {
+    if (!cmdTokenEquals(name, STORED_TRAJECTORIES[i].name) || strlen(STORED_TRAJECTORIES[i].name) != name.len) continue;
+
+    const StoredTrajectory& stored = STORED_TRAJECTORIES[i];
+    if (stored.segmentCount > MAX_TRAJECTORY_SEGMENTS) return false;
+    for (int index = 1; index < stored.segmentCount; index++) {
+      const TrajectorySegment& previous = stored.segments[index - 1];
+      if (stepReverses(stored.segments[index], signedVelocity(previous.speed, previous.direction))) {
+        LOG_WARN(TRAJ, "Trajectory" + String(motorNum) + ": '" + String(stored.name) + "' has a STEP reversal at segment " + String(index));
+        return false;
+      }
+    }
+    memcpy(run.segments, stored.segments, stored.segmentCount * sizeof(TrajectorySegment));
+    run.segmentCount = stored.segmentCount;
+    LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + ": loaded '" + String(stored.name) + "' from flash");
+    return true;
+  }
+  LOGF_WARN(TRAJ, "Trajectory%d: unknown stored trajectory %.*s", motorNum, (int)name.len, name.ptr);
+  return false;
+}
+
+// ---------------------------------------------------------------------------
+// Start / stop
+// ---------------------------------------------------------------------------
+
+// START, START:<delayMs> or START:@<unixMs> (needs SNTP); the delay is capped
+// at MAX_START_DELAY_MS so the scheduled-start compare in updateTrajectories() cannot wrap
+static CmdError scheduleStart(int motorNum, TrajectoryRun& run, const CmdTokens& tokens, bool* accepted) {
+  if (tokens.count > 2) return CMD_ERR_EXTRA_ARG;
+
+  unsigned long delayMs = 0;
+  if (tokens.count == 2) {
+    CmdToken when = tokens.items[1];
+    if (when.len > 0 && when.ptr[0] == '@') {
+      unsigned long long startMs = 0;
+      CmdError error = cmdParseULongLong(CmdToken{when.ptr + 1, (uint16_t)(when.len - 1)}, ~0ULL, &startMs);
+      if (error != CMD_OK) return error;
+
+      struct timeval now;
+      gettimeofday(&now, nullptr);
+      if (now.tv_sec < MIN_VALID_EPOCH) {
+        LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + ": scheduled start rejected - clock not synced");
+        return CMD_OK;
+      }
+      unsigned long long nowMs = (unsigned long long)now.tv_sec * 1000ULL + now.tv_usec / 1000;
+      if (startMs > nowMs + MAX_START_DELAY_MS) return CMD_ERR_RANGE;
+      delayMs = (startMs > nowMs) ? (unsigned long)(startMs - nowMs) : 0;
+    } else {
+      CmdError error = cmdParseULong(when, MAX_START_DELAY_MS, &delayMs);
+      if (error != CMD_OK) return error;
+    }
+  }
+
+  if (run.segmentCount == 0) return CMD_OK;
+
+  const MotorState& state = getMotorState(motorNum);
+  float startVelocity = signedVelocity(state.currentSpeed, state.direction);
+  if (stepReverses(run.segments[0], startVelocity)) {
+    LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + ": start rejected - first STEP reverses the running motor");
+    return CMD_OK;
+  }
+
+  cancelMotion(motorNum);
+  cancelSync();
+
+  run.segmentStartVelocity = signedVelocity(state.currentSpeed, state.direction);
+  run.segmentIndex = 0;
+  run.startTime = millis() + delayMs;
+  run.segmentStartTime = run.startTime;
+  run.phase = TRAJ_SCHEDULED;
+
+  LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + ": " + String(run.segmentCount) + " segments, start in " + String(delayMs) + "ms");
+  *accepted = true;
+  return CMD_OK;
+}
+
+static void stopTrajectory(int motorNum, TrajectoryRun& run, const char* reason) {
+  if (run.phase == TRAJ_IDLE) return;
+  run.phase = TRAJ_IDLE;
+  publishMotorEvent(motorNum, "trajectory/error", reason);
+  LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + " aborted: " + String(reason));
+}
+
+CmdError handleTrajectoryCommand(int motorNum, CmdToken args, bool* accepted) {
+  TrajectoryRun& run = trajectories[motorNum - 1];
+  *accepted = false;
+
+  // ':' splits the sub-command, ADD segments are split further inside addSegments()
+  CmdTokens tokens;
+  CmdError error = cmdTokenize(args.ptr, args.len, ':', &tokens);
+  if (error != CMD_OK) return error;
+  CmdToken word = tokens.items[0];
+
+  if (cmdTokenEquals(word, "CLEAR") || cmdTokenEquals(word, "STOP")) {
+    if (tokens.count > 1) return CMD_ERR_EXTRA_ARG;
+    stopTrajectory(motorNum, run, "ABORTED");
+    if (cmdTokenEquals(word, "CLEAR")) {
+      run.segmentCount = 0;
+    } else {
+      stopMotorNow(motorNum);
+    }
+    *accepted = true;
+    return CMD_OK;
+  }
+  if (cmdTokenEquals(word, "ADD")) {
+    return addSegments(motorNum, run, tokens, accepted);
+  }
+  if (cmdTokenEquals(word, "LOAD")) {
+    if (tokens.count < 2 || tokens.items[1].len == 0) return CMD_ERR_MISSING_ARG;
+    if (tokens.count > 2) return CMD_ERR_EXTRA_ARG;
+    *accepted = run.phase == TRAJ_IDLE && loadStored(motorNum, run, tokens.items[1]);
+    return CMD_OK;
+  }
+  if (cmdTokenEquals(word, "START")) {
+    return scheduleStart(motorNum, run, tokens, accepted);
+  }
+  return CMD_ERR_UNKNOWN;
+}
+
+void cancelTrajectory(int motorNum) {
+  TrajectoryRun& run = trajectories[motorNum - 1];
+  if (run.phase != TRAJ_IDLE) {
+    stopTrajectory(motorNum, run, "CANCELLED");
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+static float evaluateSegment(const TrajectorySegment& segment, float startVelocity, unsigned long elapsed) {
+  float endVelocity = signedVelocity(segment.speed, segment.direction);
+  if (segment.shape == SHAPE_STEP) return endVelocity;
+
+  float t = (float)elapsed / segment.durationMs;
+  if (t > 1.0f) t = 1.0f;
+  if (segment.shape == SHAPE_EASE) t = t * t * (3.0f - 2.0f * t);
+  return startVelocity + (endVelocity - startVelocity) * t;
+}
+
+static void runTrajectory(int motorNum, TrajectoryRun& run, unsigned long currentTime) {
+  // Segment boundaries advance on the schedule, not on when loop() got here
+  while (run.segmentIndex < run.segmentCount &&
+         currentTime - run.segmentStartTime >= run.segments[run.segmentIndex].durationMs) {
+    const TrajectorySegment& done = run.segments[run.segmentIndex];
+    run.segmentStartVelocity = signedVelocity(done.speed, done.direction);
+    run.segmentStartTime += done.durationMs;
+    run.segmentIndex++;
+    if (run.segmentIndex < run.segmentCount) publishProgress(motorNum, run);
+  }
+
+  if (run.segmentIndex >= run.segmentCount) {
+    // Final segment end speed is held – end a show with speed 0 to stop
+    const TrajectorySegment& last = run.segments[run.segmentCount - 1];
+    setMotorOutputNow(motorNum, last.speed, last.direction);
+    run.phase = TRAJ_IDLE;
+    publishMotorEvent(motorNum, "trajectory/complete", "DONE");
+    LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + " complete");
+    return;
+  }
+
+  const TrajectorySegment& segment = run.segments[run.segmentIndex];
+  float velocity = evaluateSegment(segment, run.segmentStartVelocity, currentTime - run.segmentStartTime);
+  int speed = (int)(fabsf(velocity) + 0.5f);
+  char direction = (velocity > 0.0f) ? 'R' : (velocity < 0.0f) ? 'L' : getMotorState(motorNum).direction;
+  setMotorOutputNow(motorNum, speed, direction);
+}
+
+void updateTrajectories() {
+  unsigned long currentTime = millis();
+
+  for (int motorNum = 1; motorNum <= 2; motorNum++) {
+    TrajectoryRun& run = trajectories[motorNum - 1];
+    if (run.phase == TRAJ_IDLE) continue;
+
+    if (run.phase == TRAJ_SCHEDULED) {
+      if ((long)(currentTime - run.startTime) < 0) continue;
+      run.phase = TRAJ_RUNNING;
+      publishProgress(motorNum, run);
+    } else if (!getMotorState(motorNum).enabled) {
+      // STOP / safety shutdown turned the bridge off under us
+      run.phase = TRAJ_IDLE;
+      LOG_INFO(TRAJ, "Trajectory" + String(motorNum) + " aborted (motor disabled)");
+      continue;
+    }
+
+    runTrajectory(motorNum, run, currentTime);
+  }
+}
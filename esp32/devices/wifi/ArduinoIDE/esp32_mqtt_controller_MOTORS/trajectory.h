@@ -0,0 +1,22 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <museum_command.h>
+
+// On-device execution of multi-segment speed trajectories.
+// Segments are timed from one start instant with millis(), so broker and
+// WiFi latency only affect the start command, not the individual steps.
+void initializeTrajectories();
+
+// Call every loop() pass after updateMotorSmoothly()
+void updateTrajectories();
+
+// Handles the payload after "TRAJ:" (CLEAR / ADD / LOAD / START / STOP).
+// Returns the grammar error of a malformed payload; *accepted is false when a
+// well-formed command was refused (offset mismatch, no segments, clock not synced...)
+CmdError handleTrajectoryCommand(int motorNum, CmdToken args, bool* accepted);
+
+// Manual commands and MOVE/HOME take the motor back from a trajectory
+void cancelTrajectory(int motorNum);
+
+#endif
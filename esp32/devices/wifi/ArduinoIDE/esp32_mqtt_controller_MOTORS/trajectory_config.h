@@ -0,0 +1,61 @@
+#ifndef TRAJECTORY_CONFIG_H
+#define TRAJECTORY_CONFIG_H
+
+#include <Arduino.h>
+
+// Maximálny počet segmentov jednej trajektórie (MQTT upload aj flash)
+#define MAX_TRAJECTORY_SEGMENTS 32
+
+// Tvar segmentu: ako sa rýchlosť dostane z konca predošlého segmentu na cieľ
+enum TrajectoryShape {
+  SHAPE_STEP,   // Okamžite cieľová rýchlosť, drží ju celý segment
+  SHAPE_LINEAR, // Lineárna rampa počas segmentu
+  SHAPE_EASE    // S-krivka (smoothstep) – mäkký rozbeh aj dobeh
+};
+
+struct TrajectorySegment {
+  unsigned long durationMs;
+  int speed;                 // 0-100
+  char direction;            // 'L' / 'R' – rampa medzi smermi prechádza nulou
+  TrajectoryShape shape;
+};
+
+struct StoredTrajectory {
+  const char* name;          // Názov pre TRAJ:LOAD:<name>
+  const TrajectorySegment* segments;
+  int segmentCount;
+};
+
+// =============================================================================
+// TRAJEKTÓRIE VO FLASH
+// =============================================================================
+
+// Pomalé otočenie hodín tam a späť
+const TrajectorySegment TRAJ_CLOCK_SWING[] = {
+  {3000, 40, 'R', SHAPE_EASE},
+  {5000, 40, 'R', SHAPE_STEP},
+  {6000, 40, 'L', SHAPE_LINEAR},   // Cez nulu do opačného smeru
+  {5000, 40, 'L', SHAPE_STEP},
+  {3000,  0, 'L', SHAPE_EASE}
+};
+
+// Pulzovanie v takte 120 BPM (500 ms)
+const TrajectorySegment TRAJ_PULSE_120BPM[] = {
+  {250, 70, 'L', SHAPE_LINEAR},
+  {250, 30, 'L', SHAPE_LINEAR},
+  {250, 70, 'L', SHAPE_LINEAR},
+  {250, 30, 'L', SHAPE_LINEAR},
+  {250, 70, 'L', SHAPE_LINEAR},
+  {250, 30, 'L', SHAPE_LINEAR},
+  {250, 70, 'L', SHAPE_LINEAR},
+  {250,  0, 'L', SHAPE_LINEAR}
+};
+
+const StoredTrajectory STORED_TRAJECTORIES[] = {
+  {"clock_swing",  TRAJ_CLOCK_SWING,  sizeof(TRAJ_CLOCK_SWING) / sizeof(TrajectorySegment)},
+  {"pulse_120bpm", TRAJ_PULSE_120BPM, sizeof(TRAJ_PULSE_120BPM) / sizeof(TrajectorySegment)}
+};
+
+const int STORED_TRAJECTORY_COUNT = sizeof(STORED_TRAJECTORIES) / sizeof(StoredTrajectory);
+
+#endif
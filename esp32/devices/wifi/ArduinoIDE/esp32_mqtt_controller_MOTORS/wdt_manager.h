@@ -1,7 +1,29 @@
 #ifndef WDT_MANAGER_H
 #define WDT_MANAGER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 void initializeWatchdog();
 void resetWatchdog();
 
-#endif
\ No newline at end of file
+// Softverovy watchdog faz loop(): kazda faza ma rozpocet v ms, monitor task ho
+// kontroluje kazdych STAGE_WDT_CHECK_MS. Pri prekroceni hned vypne vystupy
+// (safeOutputs z monitor tasku) - hardverovy WDT (WDT_TIMEOUT) je az posledna zachrana.
+struct StageStall {
+  uint8_t stage;
+  uint32_t elapsedMs;   // Cely beh zaseknutej fazy
+  uint16_t budgetMs;
+};
+
+// budgetsMs[i] = 0 -> faza sa nekontroluje (iba sa zaznamena pre crash zaznam)
+void initializeStageWatchdog(const char* const* names, const uint16_t* budgetsMs, uint8_t count,
+                             void (*safeOutputs)());
+void stageEnter(uint8_t stage);
+void stageExit();
+
+// Zaseknuta faza uz skoncila: vrati ju raz, loop() potom zosuladi stav a posle hlasenie
+bool takeStageStall(StageStall* out);
+size_t formatStageStall(const StageStall& stall, char* out, size_t size);
+
+#endif
@@ -7,7 +7,7 @@ bool wifiConnected = false;
 unsigned long lastWifiAttempt = 0;
 
 bool initializeWiFi() {
-  debugPrint("Connecting to WiFi: " + String(WIFI_SSID));
+  LOG_INFO(WIFI, "Connecting to WiFi: " + String(WIFI_SSID));
   WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
@@ -20,14 +20,14 @@ bool initializeWiFi() {
   if (WiFi.status() == WL_CONNECTED) {
     Serial.print("WiFi connected - IP: ");
     Serial.println(WiFi.localIP());
-    debugPrint("WiFi connected: " + WiFi.localIP().toString());
+    LOG_INFO(WIFI, "WiFi connected: " + WiFi.localIP().toString());
     wifiConnected = true;
     lastWifiAttempt = 0;
     return true;
   }
 
   wifiConnected = false;
-  debugPrint("WiFi connection failed");
+  LOG_WARN(WIFI, "WiFi connection failed");
   return false;
 }
 
@@ -37,7 +37,7 @@ void reconnectWiFi() {
   static unsigned long wifiRetryInterval = WIFI_RETRY_INTERVAL;
 
   if (WiFi.status() != WL_CONNECTED && (currentTime - lastWifiAttempt >= wifiRetryInterval)) {
-    debugPrint("WiFi reconnect attempt " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
+    LOG_INFO(WIFI, "WiFi reconnect attempt " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
     lastWifiAttempt = currentTime;
     wifiAttempts++;
 
@@ -46,15 +46,15 @@ void reconnectWiFi() {
 
     if (initializeWiFi()) {
       Serial.println("WiFi reconnected");
-      debugPrint("WiFi reconnected successfully");
+      LOG_INFO(WIFI, "WiFi reconnected successfully");
       wifiAttempts = 0;
       wifiRetryInterval = WIFI_RETRY_INTERVAL;
     } else {
       wifiRetryInterval = min(wifiRetryInterval * 2, MAX_RETRY_INTERVAL);
-      debugPrint("WiFi failed - retry in " + String(wifiRetryInterval) + "ms");
+      LOG_WARN(WIFI, "WiFi failed - retry in " + String(wifiRetryInterval) + "ms");
 
       if (wifiAttempts >= MAX_WIFI_ATTEMPTS) {
-        debugPrint("Max WiFi attempts - restarting");
+        LOGR_ERROR(WIFI, "Max WiFi attempts - restarting");
         ESP.restart();
       }
     }
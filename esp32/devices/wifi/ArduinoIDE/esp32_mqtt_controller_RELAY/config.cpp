@@ -39,9 +39,6 @@ const int DEVICE_COUNT = sizeof(DEVICES) / sizeof(Device);
 // OSTATNA KONFIGURACIA
 // =============================================================================
 
-// Debug
-bool DEBUG = false;
-
 // WiFi Nastavenia
 
 // 1. Domáca WiFi (Majo)
@@ -72,8 +69,22 @@ int MQTT_KEEP_ALIVE = 10;
 // Timeout pre necinnost
 unsigned long NO_COMMAND_TIMEOUT = 180000;
 
+// Histogramy faz loop() (devices/<id>/metrics) a meskania efektov (devices/<id>/timing), 0 = vypnute
+unsigned long METRICS_INTERVAL = 60000;
+// Meskanie efektov / auto-off nad touto hranicou sa pocita ako miss (devices/<id>/timing), us
+unsigned long TIMING_MISS_US = 5000;
+
+// Diagnostika taskov a heapu na devices/<id>/diag, limity pre devices/<id>/diag/warn (0 = bez kontroly)
+unsigned long DIAG_CHECK_INTERVAL = 10000;
+unsigned long DIAG_REPORT_INTERVAL = 300000;  // 0 = len na poziadanie (diag/get)
+uint32_t DIAG_MIN_FREE_HEAP = 20000;          // B
+uint8_t DIAG_MAX_FRAGMENTATION = 70;          // %
+uint32_t DIAG_MIN_STACK_FREE = 512;           // B na task
+uint8_t DIAG_MAX_TASK_CPU = 80;               // % jadra, okrem IDLE
+
 // Watchdog Timer
 unsigned long WDT_TIMEOUT = 30;
+unsigned long STAGE_WDT_CHECK_MS = 100;       // Kontrola rozpoctov faz loop() (rozpocty v .ino)
 
 // OTA Konfiguracia
 const char* OTA_HOSTNAME = "ESP32-RelayModule-Room1";
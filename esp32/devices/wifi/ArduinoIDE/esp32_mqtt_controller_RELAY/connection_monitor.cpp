@@ -17,20 +17,20 @@ void monitorConnections() {
     String wifiStatus = WiFi.status() == WL_CONNECTED ? "OK" : "FAIL";
     String mqttStatus = client.connected() ? "OK" : "FAIL";
     
-    debugPrint("📊 Status - WiFi: " + wifiStatus + ", MQTT: " + mqttStatus);
+    LOG_DEBUG(CONN, "📊 Status - WiFi: " + wifiStatus + ", MQTT: " + mqttStatus);
 
     // Detekcia straty WiFi spojenia
     if (WiFi.status() != WL_CONNECTED && wifiConnected) {
       wifiConnected = false;
       mqttConnected = false;
       Serial.println("⚠️  WiFi spojenie stratené");
-      debugPrint("WiFi spojenie stratené");
+      LOG_WARN(CONN, "WiFi spojenie stratené");
     } 
     // Detekcia obnovy WiFi spojenia
     else if (WiFi.status() == WL_CONNECTED && !wifiConnected) {
       wifiConnected = true;
       Serial.println("✅ WiFi spojenie obnovené");
-      debugPrint("WiFi spojenie obnovené");
+      LOG_INFO(CONN, "WiFi spojenie obnovené");
     }
   }
 }
\ No newline at end of file
@@ -1,4 +1,3 @@
-#include <esp_task_wdt.h>
 #include "config.h"
 #include "debug.h"
 #include "hardware.h"
@@ -8,25 +7,57 @@
 #include "ota_manager.h"
 #include "status_led.h"
 #include "effects_manager.h"
+#include "wdt_manager.h"
+#include <museum_metrics.h>
+#include <museum_log_crash.h>
+
+// Fazy loop() pre profiler (devices/<id>/metrics) a crash zaznam (devices/<id>/crash), "loop" = cely priechod
+enum LoopStage : uint8_t {
+  STAGE_OTA,
+  STAGE_LED,
+  STAGE_MQTT,
+  STAGE_EFFECTS,
+  STAGE_AUTO_OFF,
+  STAGE_NET,
+  STAGE_COUNT
+};
+static const char* const LOOP_STAGE_NAMES[STAGE_COUNT] = {"ota", "led", "mqtt", "effects", "auto_off", "net"};
+
+// Rozpocet fazy pre softverovy watchdog v ms, 0 = bez kontroly (OTA upload blokuje dlhsie -
+// pokryva ho iba hardverovy WDT). Blokujuci reconnect WiFi / MQTT v "net" trva az sekundy:
+// po 300 ms monitor vypne rele, nic by ich pocas neho neriadilo (bez MQTT by sa aj tak vypli).
+static const uint16_t LOOP_STAGE_BUDGET_MS[STAGE_COUNT] = {0, 50, 1000, 100, 300, 300};
+
+// Zaseknuta faza skoncila: monitor uz vypol vystupy, tu sa zosuladi stav a posle hlasenie
+static void handleStageStall() {
+  StageStall stall;
+  if (!takeStageStall(&stall)) return;
+  turnOffAllDevices();
+  stopAllEffects();
+  publishStageStall(stall);
+}
+
+// Faza v RTC pamati (prezije WDT / panic), kontrola rozpoctu + meranie profilerom
+#define LOOP_STAGE(stage, ...)                 \
+  do {                                         \
+    stageEnter(stage);                         \
+    PROFILE_STAGE(stage, __VA_ARGS__);         \
+    stageExit();                               \
+    handleStageStall();                        \
+  } while (0)
 
 void setup() {
   Serial.begin(115200);
   delay(100);
+  logRingBegin(); // Binarny log (LOGR_*) - zaznamy spred WDT resetu sa vypisu v loop()
+  crashBegin(LOOP_STAGE_NAMES, STAGE_COUNT); // Dovod resetu, faza a prikazy pred padom -> devices/<id>/crash
   Serial.println("\n------------------------------------------");
   Serial.println(" ESP32 MQTT Relay Controller v2.3 + Effects");
   Serial.println("------------------------------------------");
-  debugPrint("=== System startuje ===");
+  LOG_INFO(MAIN, "=== System startuje ===");
   
   // Watchdog konfiguracia
-  esp_task_wdt_deinit();
-  esp_task_wdt_config_t wdt_config = {
-    .timeout_ms = WDT_TIMEOUT * 1000,
-    .idle_core_mask = 0,
-    .trigger_panic = true
-  };
-  esp_task_wdt_init(&wdt_config);
-  esp_task_wdt_add(NULL);
-  debugPrint("Watchdog Timer inicializovany (" + String(WDT_TIMEOUT) + "s)");
+  initializeWatchdog();
   
   Serial.println("\n--- Inicializacia hardwaru ---");
   initializeHardware();
@@ -49,6 +80,9 @@ void setup() {
   Serial.println("\n--- MQTT konfiguracia ---");
   initializeMqtt();
   lastCommandTime = millis();
+
+  profilerBegin(LOOP_STAGE_NAMES, STAGE_COUNT);
+  initializeStageWatchdog(LOOP_STAGE_NAMES, LOOP_STAGE_BUDGET_MS, STAGE_COUNT, forceOutputsOff);
   
   Serial.println("\n------------------------------------------");
   Serial.println(" Setup dokonceny");
@@ -56,9 +90,11 @@ void setup() {
 }
 
 void loop() {
+  profilerLoopStart();
+
   // 1. OTA Handle (musi byt prve)
   if (wifiConnected) {
-    handleOTA();
+    LOOP_STAGE(STAGE_OTA, handleOTA());
     if (isOTAInProgress()) {
       delay(10);
       return; // Ak bezi update, prerusime loop
@@ -66,26 +102,28 @@ void loop() {
   }
 
   // 2. Obsluha Status LED
-  handleStatusLed(isWiFiConnected(), isMqttConnected());
+  LOOP_STAGE(STAGE_LED, handleStatusLed(isWiFiConnected(), isMqttConnected()));
 
   // 3. Reset Watchdog
-  esp_task_wdt_reset();
+  resetWatchdog();
 
   // 4. MQTT Logika
   if (isMqttConnected()) {
-    mqttLoop();
+    LOOP_STAGE(STAGE_MQTT, mqttLoop());
   }
 
-  handleEffects();
+  LOOP_STAGE(STAGE_EFFECTS, handleEffects());
 
   // 6. Kontrola casovacov (auto-off pre bežné zariadenia)
-  handleAutoOff();
+  LOOP_STAGE(STAGE_AUTO_OFF, handleAutoOff());
 
   // 7. Rychla kontrola spojenia
   static unsigned long lastQuickCheck = 0;
   unsigned long currentTime = millis();
 
   if (currentTime - lastQuickCheck >= 100) {
+    ProfileScope netStage(STAGE_NET);
+    stageEnter(STAGE_NET);
     lastQuickCheck = currentTime;
     if (!isWiFiConnected()) {
       reconnectWiFi();
@@ -99,26 +137,47 @@ void loop() {
     }
   }
 
+  stageExit();
+  handleStageStall();
+
   // 8. Detailna kontrola a logovanie
   static unsigned long lastDetailedCheck = 0;
   if (currentTime - lastDetailedCheck >= 10000) {
     lastDetailedCheck = currentTime;
     monitorConnections();
+    logStatusLedStats();
   }
 
   // 9. Bezpecnostne ochrany
   if (!isMqttConnected() && !allDevicesOff) {
-    debugPrint("Strata MQTT spojenia -> Vypinam zariadenia");
+    LOGR_WARN(MAIN, "Strata MQTT spojenia -> Vypinam zariadenia");
     turnOffAllDevices();
     stopAllEffects();
   }
   
   if (!allDevicesOff && (currentTime - lastCommandTime > NO_COMMAND_TIMEOUT)) {
-     debugPrint("TIMEOUT: Vypinam zariadenia z dovodu necinnosti");
+     LOGR_WARN(MAIN, "TIMEOUT: Vypinam zariadenia z dovodu necinnosti");
      turnOffAllDevices();
      stopAllEffects();
      lastCommandTime = currentTime;
   }
 
+  // 10. Metriky faz loop() a meskanie efektov - okna sa po odoslani nuluju
+  static unsigned long lastMetrics = 0;
+  if (METRICS_INTERVAL > 0 && currentTime - lastMetrics >= METRICS_INTERVAL) {
+    lastMetrics = currentTime;
+    static char metrics[PROFILER_PAYLOAD_MAX];
+    if (profilerFormat(metrics, sizeof(metrics)) > 0) {
+      publishMetrics(metrics);
+    }
+    if (latenessFormat(metrics, sizeof(metrics)) > 0) {
+      publishTiming(metrics);
+    }
+  }
+
+  // 11. Vypis binarneho logu (iba ak ma UART volne miesto)
+  logRingDrain(Serial);
+
+  profilerLoopEnd();
   delay(1);
 }
\ No newline at end of file
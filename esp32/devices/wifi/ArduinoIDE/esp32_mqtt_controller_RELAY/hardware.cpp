@@ -3,6 +3,7 @@
 #include "debug.h"
 #include "status_led.h"
 #include <Wire.h>
+#include <museum_metrics.h>
 
 // Global device states
 bool deviceStates[20]          = {false};
@@ -25,7 +26,7 @@ void writeExpander(byte data) {
   byte error = Wire.endTransmission();
 
   if (error != 0) {
-    debugPrint("CHYBA I2C komunikacie: " + String(error));
+    LOGF_ERROR(HW, "CHYBA I2C komunikacie: %d", (int)error);
   }
 }
 
@@ -33,12 +34,12 @@ void writeExpander(byte data) {
 // initializeHardware
 // ---------------------------------------------------------------------------
 void initializeHardware() {
-  debugPrint("Inicializujem " + String(DEVICE_COUNT) + " zariadeni...");
+  LOG_INFO(HW, "Inicializujem " + String(DEVICE_COUNT) + " zariadeni...");
 
   initializeStatusLed();
 
   if (USE_RELAY_MODULE) {
-    debugPrint("Rezim: Waveshare Relay Module (I2C)");
+    LOG_INFO(HW, "Rezim: Waveshare Relay Module (I2C)");
     Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
 
     // Set I2C timeout – prevents bus hang from blocking the main loop
@@ -51,7 +52,7 @@ void initializeHardware() {
     if (Wire.endTransmission() != 0) {
       Serial.println("CHYBA: I2C Expander nenajdeny!");
     } else {
-      debugPrint("I2C Expander inicializovany OK");
+      LOG_INFO(HW, "I2C Expander inicializovany OK");
     }
 
     // Set initial expander state – handle inverted channels
@@ -64,7 +65,7 @@ void initializeHardware() {
     writeExpander(expanderState);
 
   } else {
-    debugPrint("Rezim: Direct GPIO Control");
+    LOG_INFO(HW, "Rezim: Direct GPIO Control");
     for (int i = 0; i < DEVICE_COUNT; i++) {
       pinMode(DEVICES[i].pin, OUTPUT);
       digitalWrite(DEVICES[i].pin, DEVICES[i].inverted ? HIGH : LOW);
@@ -79,7 +80,7 @@ void initializeHardware() {
   }
 
   allDevicesOff = true;
-  debugPrint("Hardware inicializovane - vsetky zariadenia OFF");
+  LOG_INFO(HW, "Hardware inicializovane - vsetky zariadenia OFF");
 }
 
 // ---------------------------------------------------------------------------
@@ -87,7 +88,7 @@ void initializeHardware() {
 // ---------------------------------------------------------------------------
 void setDevice(int deviceIndex, bool state) {
   if (deviceIndex < 0 || deviceIndex >= DEVICE_COUNT) {
-    debugPrint("ERROR: Neplatny index zariadenia: " + String(deviceIndex));
+    LOGR_ERROR(HW, "Neplatny index zariadenia: %d", deviceIndex);
     return;
   }
 
@@ -105,6 +106,7 @@ void setDevice(int deviceIndex, bool state) {
     allDevicesOff = !anyOn;
   }
 
+  uint32_t applyStart = micros();
   if (USE_RELAY_MODULE) {
     bool physicalBit = device.inverted ? !state : state;
     if (physicalBit) expanderState |=  (1 << device.pin);
@@ -114,8 +116,9 @@ void setDevice(int deviceIndex, bool state) {
     bool outputState = device.inverted ? !state : state;
     digitalWrite(device.pin, outputState ? HIGH : LOW);
   }
+  benchRecordApply(micros() - applyStart);   // Iba pocas syntetickeho prikazu (I2C zapis)
 
-  debugPrint(String(device.name) + " -> " + (state ? "ON" : "OFF"));
+  LOGR_DEBUG(HW, "%s -> %s", device.name, state ? "ON" : "OFF");
 }
 void handleAutoOff() {
   unsigned long currentTime = millis();
@@ -128,8 +131,9 @@ void handleAutoOff() {
     if (effectControlled[i]) continue;
 
     if (currentTime - deviceStartTimes[i] >= DEVICES[i].autoOffMs) {
-      debugPrint("AUTO-OFF: " + String(DEVICES[i].name) + " -> Vypinam.");
+      LOGR_INFO(HW, "AUTO-OFF: %s -> Vypinam.", DEVICES[i].name);
       setDevice(i, false);
+      latenessRecordMs(TIMING_AUTO_OFF, deviceStartTimes[i] + DEVICES[i].autoOffMs);
     }
   }
 }
@@ -138,7 +142,7 @@ void handleAutoOff() {
 // turnOffAllDevices
 // ---------------------------------------------------------------------------
 void turnOffAllDevices() {
-  debugPrint("Vypinam vsetky zariadenia");
+  LOG_INFO(HW, "Vypinam vsetky zariadenia");
 
   if (USE_RELAY_MODULE) {
     expanderState = 0x00;
@@ -162,6 +166,27 @@ void turnOffAllDevices() {
   allDevicesOff = true;
 }
 
+// ---------------------------------------------------------------------------
+// forceOutputsOff – monitor task softveroveho watchdogu pocas zaseku loop()
+// Nemeni deviceStates ani expanderState (patria loop()), tie zosuladi turnOffAllDevices()
+// ---------------------------------------------------------------------------
+void forceOutputsOff() {
+  if (USE_RELAY_MODULE) {
+    // Wire ma vlastny zamok - ak zasek drzi zbernicu, zapis pocka na jej timeout
+    byte offState = 0x00;
+    for (int i = 0; i < DEVICE_COUNT; i++) {
+      if (DEVICES[i].inverted) {
+        offState |= (1 << DEVICES[i].pin);
+      }
+    }
+    writeExpander(offState);
+  } else {
+    for (int i = 0; i < DEVICE_COUNT; i++) {
+      digitalWrite(DEVICES[i].pin, DEVICES[i].inverted ? HIGH : LOW);
+    }
+  }
+}
+
 // ---------------------------------------------------------------------------
 // getDeviceStatus
 // ---------------------------------------------------------------------------
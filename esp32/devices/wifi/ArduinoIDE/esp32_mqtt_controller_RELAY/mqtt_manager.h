@@ -3,6 +3,7 @@
 
 #include <PubSubClient.h>
 #include <WiFi.h>
+#include "wdt_manager.h"
 
 extern WiFiClient wifiClient;
 extern PubSubClient client;
@@ -13,6 +14,9 @@ void initializeMqtt();
 void connectToMqtt();
 void mqttLoop();
 void publishStatus();
+bool publishMetrics(const char* payload);
+bool publishTiming(const char* payload);
+void publishStageStall(const StageStall& stall);
 bool isMqttConnected();
 
 #endif
\ No newline at end of file
@@ -13,7 +13,7 @@ bool otaInitialized = false;
 
 void initializeOTA() {
   if (!wifiConnected || !isWiFiConnected()) {
-    debugPrint("OTA: WiFi not connected, skipping setup");
+    LOG_WARN(OTA, "WiFi not connected, skipping setup");
     return;
   }
 
@@ -86,7 +86,7 @@ void initializeOTA() {
   ArduinoOTA.begin();
   otaInitialized = true;
 
-  debugPrint("OTA: Initialized successfully");
+  LOG_INFO(OTA, "Initialized successfully");
   Serial.println("OTA READY: " + String(OTA_HOSTNAME));
 }
 
@@ -4,7 +4,10 @@
 #include <Arduino.h>
 
 void initializeStatusLed();
+// Volať v každom prechode loop(); do LED (RMT) zapisuje iba pri zmene farby
 void handleStatusLed(bool wifiOk, bool mqttOk);
+// Čas strávený v handleStatusLed() a počet zápisov od posledného volania (debug log)
+void logStatusLedStats();
 void setOtaLedState(bool active);
 
 #endif
\ No newline at end of file
@@ -2,6 +2,31 @@
 #include "config.h"
 #include "debug.h"
 #include <esp_task_wdt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <museum_log_crash.h>
+
+// Na jadre 0 - bezi, aj ked loop() na jadre 1 nepusti procesor
+static const UBaseType_t STAGE_MONITOR_PRIORITY = 3;
+static const BaseType_t STAGE_MONITOR_CORE = 0;
+static const uint32_t STAGE_MONITOR_STACK = 3072;
+
+static const char* const* stageNames = nullptr;
+static const uint16_t* stageBudgets = nullptr;
+static uint8_t stageCount = 0;
+static void (*stageSafeOutputs)() = nullptr;
+
+// Zapisuje iba loop(): seq je neparne pocas fazy, monitor cita stage/start medzi dvoma citaniami seq
+static volatile uint32_t stageSeq = 0;
+static volatile uint8_t currentStage = CRASH_STAGE_NONE;
+static volatile uint32_t stageStartMs = 0;
+
+// Zapisuje iba monitor task
+static volatile uint32_t trippedSeq = 0;
+
+// Zasek ukonceny v stageExit() - cita takeStageStall()
+static volatile bool stallPending = false;
+static StageStall lastStall = {};
 
 void initializeWatchdog() {
   // 1. Deinicializacia povodneho (fix pre Arduino 3.0+)
@@ -19,9 +44,81 @@ void initializeWatchdog() {
   esp_task_wdt_init(&wdt_config);
   esp_task_wdt_add(NULL);
   
-  debugPrint("✅ Watchdog Timer aktivny (" + String(WDT_TIMEOUT) + "s)");
+  LOG_INFO(WDT, "✅ Watchdog Timer aktivny (" + String(WDT_TIMEOUT) + "s)");
 }
 
 void resetWatchdog() {
   esp_task_wdt_reset();
-}
\ No newline at end of file
+}
+
+static void stageMonitorTask(void* parameter) {
+  TickType_t lastWake = xTaskGetTickCount();
+
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(STAGE_WDT_CHECK_MS));
+
+    uint32_t seq = __atomic_load_n(&stageSeq, __ATOMIC_ACQUIRE);
+    if ((seq & 1) == 0 || seq == trippedSeq) continue;
+    uint8_t stage = currentStage;
+    uint32_t start = stageStartMs;
+    if (__atomic_load_n(&stageSeq, __ATOMIC_ACQUIRE) != seq || stage >= stageCount) continue;
+
+    uint16_t budget = stageBudgets[stage];
+    uint32_t elapsed = millis() - start;
+    if (budget == 0 || elapsed <= budget) continue;
+
+    // Raz za beh fazy: vystupy hned vypnut, stav zosuladi loop() po zotaveni
+    trippedSeq = seq;
+    if (stageSafeOutputs != nullptr) stageSafeOutputs();
+    LOGR_ERROR(WDT, "Zasek fazy %s: %lu ms (rozpocet %u ms) -> vystupy vypnute", stageNames[stage],
+               (unsigned long)elapsed, (unsigned)budget);
+  }
+}
+
+void initializeStageWatchdog(const char* const* names, const uint16_t* budgetsMs, uint8_t count,
+                             void (*safeOutputs)()) {
+  stageNames = names;
+  stageBudgets = budgetsMs;
+  stageCount = count;
+  stageSafeOutputs = safeOutputs;
+
+  xTaskCreatePinnedToCore(stageMonitorTask, "stage_wdt", STAGE_MONITOR_STACK, nullptr,
+                          STAGE_MONITOR_PRIORITY, nullptr, STAGE_MONITOR_CORE);
+  LOG_INFO(WDT, "Softverovy watchdog faz aktivny (kontrola " + String(STAGE_WDT_CHECK_MS) + " ms)");
+}
+
+void stageEnter(uint8_t stage) {
+  crashMarkStage(stage);
+  currentStage = stage;
+  stageStartMs = millis();
+  __atomic_store_n(&stageSeq, stageSeq + 1, __ATOMIC_RELEASE);   // Neparne = faza bezi
+}
+
+void stageExit() {
+  uint32_t seq = stageSeq;
+  if ((seq & 1) == 0) return;
+  __atomic_store_n(&stageSeq, seq + 1, __ATOMIC_RELEASE);
+  crashMarkStage(CRASH_STAGE_NONE);
+
+  if (__atomic_load_n(&trippedSeq, __ATOMIC_ACQUIRE) == seq && !stallPending) {
+    lastStall.stage = currentStage;
+    lastStall.elapsedMs = millis() - stageStartMs;
+    lastStall.budgetMs = stageBudgets[currentStage];
+    stallPending = true;
+  }
+}
+
+bool takeStageStall(StageStall* out) {
+  if (!stallPending) return false;
+  *out = lastStall;
+  stallPending = false;
+  return true;
+}
+
+// Rovnaky tvar ako ostatne varovania na devices/<id>/diag/warn
+size_t formatStageStall(const StageStall& stall, char* out, size_t size) {
+  const char* name = stall.stage < stageCount ? stageNames[stall.stage] : "?";
+  int written = snprintf(out, size, "{\"warn\":\"stall\",\"stage\":\"%s\",\"value\":%lu,\"limit\":%u}", name,
+                         (unsigned long)stall.elapsedMs, (unsigned)stall.budgetMs);
+  return written > 0 && (size_t)written < size ? written : 0;
+}
@@ -7,7 +7,7 @@ bool wifiConnected = false;
 unsigned long lastWifiAttempt = 0;
 
 bool initializeWiFi() {
-  debugPrint("Pripájam sa na WiFi: " + String(WIFI_SSID));
+  LOG_INFO(WIFI, "Pripájam sa na WiFi: " + String(WIFI_SSID));
   WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
@@ -22,7 +22,7 @@ bool initializeWiFi() {
   if (WiFi.status() == WL_CONNECTED) {
     Serial.print("✅ WiFi pripojené - IP: ");
     Serial.println(WiFi.localIP());
-    debugPrint("WiFi pripojené: " + WiFi.localIP().toString());
+    LOG_INFO(WIFI, "WiFi pripojené: " + WiFi.localIP().toString());
     wifiConnected = true;
     lastWifiAttempt = 0;
     return true;
@@ -30,7 +30,7 @@ bool initializeWiFi() {
 
   Serial.println("❌ WiFi zlyhalo");
   wifiConnected = false;
-  debugPrint("WiFi pripojenie zlyhalo");
+  LOG_WARN(WIFI, "WiFi pripojenie zlyhalo");
   return false;
 }
 
@@ -40,7 +40,7 @@ void reconnectWiFi() {
   static unsigned long wifiRetryInterval = WIFI_RETRY_INTERVAL;
 
   if (WiFi.status() != WL_CONNECTED && (currentTime - lastWifiAttempt >= wifiRetryInterval)) {
-    debugPrint("WiFi reconnect pokus " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
+    LOG_INFO(WIFI, "WiFi reconnect pokus " + String(wifiAttempts + 1) + "/" + String(MAX_WIFI_ATTEMPTS));
     lastWifiAttempt = currentTime;
     wifiAttempts++;
 
@@ -49,15 +49,15 @@ void reconnectWiFi() {
 
     if (initializeWiFi()) {
       Serial.println("✅ WiFi znovu pripojené");
-      debugPrint("WiFi znovu pripojené");
+      LOG_INFO(WIFI, "WiFi znovu pripojené");
       wifiAttempts = 0;
       wifiRetryInterval = WIFI_RETRY_INTERVAL;
     } else {
       wifiRetryInterval = min(wifiRetryInterval * 2, MAX_RETRY_INTERVAL);
-      debugPrint("WiFi zlyhalo - skúsim znovu za " + String(wifiRetryInterval) + "ms");
+      LOG_WARN(WIFI, "WiFi zlyhalo - skúsim znovu za " + String(wifiRetryInterval) + "ms");
 
       if (wifiAttempts >= MAX_WIFI_ATTEMPTS) {
-        debugPrint("Max WiFi pokusov dosiahnutý - reštartujem ESP32");
+        LOG_ERROR(WIFI, "Max WiFi pokusov dosiahnutý - reštartujem ESP32");
         Serial.println("🔄 Reštartujem ESP32...");
         delay(1000);
         ESP.restart();
@@ -0,0 +1,64 @@
+// Throughput microbenchmark of the shared parser on representative payloads.
+//   ./bench_command [iterations]
+
+#include "museum_command.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct BenchCase {
+  const char* name;
+  const char* payload;
+  int grammar;   // 0 = switch, 1 = motor, 2 = sync
+};
+
+static const BenchCase CASES[] = {
+  {"relay ON",          "ON",                          0},
+  {"relay off",         "off",                         0},
+  {"motor ON+ramp",     "ON:80:L:4000",                1},
+  {"motor RPM",         "RPM:12.5:R:3000",             1},
+  {"motor MOVE",        "MOVE:-1200:40",               1},
+  {"motor TRAJ",        "TRAJ:ADD:0:2000,40,R,EASE",   1},
+  {"motor invalid",     "ON:120:L",                    1},
+  {"sync ON+ratio",     "ON:60:L:4000:-0.5",           2},
+};
+
+static volatile uint32_t sink = 0;   // Keeps the optimizer from dropping the parse
+
+static uint32_t parseOnce(const BenchCase& c, size_t length) {
+  switch (c.grammar) {
+    case 0: {
+      SwitchAction action;
+      return parseSwitchCommand(c.payload, length, true, &action) + action;
+    }
+    case 1: {
+      MotorCommand cmd;
+      return parseMotorCommand(c.payload, length, &cmd) + cmd.speed;
+    }
+    default: {
+      SyncCommand cmd;
+      return parseSyncCommand(c.payload, length, &cmd) + cmd.speed;
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  long iterations = (argc > 1) ? atol(argv[1]) : 2000000;
+
+  printf("%-16s %12s %10s\n", "case", "Mparse/s", "ns/parse");
+  for (const BenchCase& c : CASES) {
+    size_t length = strlen(c.payload);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+      sink += parseOnce(c, length);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-16s %12.2f %10.1f\n", c.name, iterations / seconds / 1e6, seconds * 1e9 / iterations);
+  }
+  return 0;
+}
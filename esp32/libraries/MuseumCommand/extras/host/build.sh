@@ -0,0 +1,39 @@
+#!/bin/bash
+# Builds the host harness of the shared command parser (Linux).
+#   ./build.sh        build into ./build
+#   ./build.sh run    build, fuzz (60 s with libFuzzer, 1M runs without) and benchmark
+set -e
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+SRC="$HERE/../../src"
+OUT="$HERE/build"
+mkdir -p "$OUT"
+
+CXXFLAGS="-std=c++11 -g -Wall -Wextra -I$SRC"
+
+if command -v clang++ >/dev/null 2>&1; then
+  clang++ $CXXFLAGS -O1 -fsanitize=fuzzer,address,undefined \
+    "$SRC/museum_command.cpp" "$HERE/fuzz_command.cpp" -o "$OUT/fuzz_command"
+  FUZZ="$OUT/fuzz_command"
+else
+  echo "clang++ not found - building the standalone fuzz driver with g++ (no coverage guidance)"
+  g++ $CXXFLAGS -O1 -fsanitize=address,undefined \
+    "$SRC/museum_command.cpp" "$HERE/fuzz_command.cpp" "$HERE/fuzz_standalone_main.cpp" \
+    -o "$OUT/fuzz_command_standalone"
+  FUZZ="$OUT/fuzz_command_standalone"
+fi
+
+CXX_BENCH="$(command -v clang++ || command -v g++)"
+"$CXX_BENCH" $CXXFLAGS -O2 "$SRC/museum_command.cpp" "$HERE/bench_command.cpp" -o "$OUT/bench_command"
+
+echo "Built: $FUZZ, $OUT/bench_command"
+
+if [ "$1" = "run" ]; then
+  if [ "$(basename "$FUZZ")" = "fuzz_command" ]; then
+    mkdir -p "$OUT/corpus"
+    "$FUZZ" "$OUT/corpus" "$HERE/corpus" -max_total_time=60 -max_len=160
+  else
+    "$FUZZ" "$HERE"/corpus/* -runs=1000000
+  fi
+  "$OUT/bench_command"
+fi
@@ -0,0 +1,85 @@
+// libFuzzer target for the shared command grammar.
+// Every parser runs on the raw input; on CMD_OK the typed result must respect
+// the documented ranges and every view must stay inside the input buffer.
+
+#include "museum_command.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void check(bool condition, const char* what) {
+  if (!condition) {
+    fprintf(stderr, "invariant violated: %s\n", what);
+    abort();
+  }
+}
+
+static bool inside(CmdToken token, const char* data, size_t size) {
+  return token.ptr >= data && token.ptr + token.len <= data + size;
+}
+
+static bool validDirection(char direction) {
+  return direction == 'L' || direction == 'R';
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  const char* payload = reinterpret_cast<const char*>(data);
+
+  CmdTokens tokens;
+  if (cmdTokenize(payload, size, ':', &tokens) == CMD_OK) {
+    check(tokens.count >= 1 && tokens.count <= CMD_MAX_TOKENS, "token count");
+    for (uint8_t i = 0; i < tokens.count; i++) {
+      check(inside(tokens.items[i], payload, size), "token inside payload");
+    }
+  }
+
+  unsigned long long wide;
+  if (cmdParseULongLong(CmdToken{payload, (uint16_t)(size > CMD_MAX_PAYLOAD ? CMD_MAX_PAYLOAD : size)},
+                        9999999999999ULL, &wide) == CMD_OK) {
+    check(wide <= 9999999999999ULL, "wide number");
+  }
+
+  SwitchAction action;
+  if (parseSwitchCommand(payload, size, true, &action) == CMD_OK) {
+    check(action == SWITCH_ON || action == SWITCH_OFF, "switch action");
+  }
+
+  MotorCommand motor;
+  if (parseMotorCommand(payload, size, &motor) == CMD_OK) {
+    check(motor.speed >= 0 && motor.speed <= CMD_MAX_SPEED, "motor speed");
+    check(validDirection(motor.direction), "motor direction");
+    check(motor.rampMs <= CMD_MAX_RAMP_MS, "motor ramp");
+    check(motor.rpm >= 0.0f && motor.rpm <= CMD_MAX_RPM, "motor rpm");
+    check(motor.target >= -CMD_MAX_POSITION && motor.target <= CMD_MAX_POSITION, "motor target");
+    check(motor.intervalMs <= CMD_MAX_TELEMETRY_MS, "telemetry interval");
+    check(motor.arg.len == 0 || inside(motor.arg, payload, size), "motor arg inside payload");
+  }
+
+  SyncCommand sync;
+  if (parseSyncCommand(payload, size, &sync) == CMD_OK) {
+    check(sync.speed >= 0 && sync.speed <= CMD_MAX_SPEED, "sync speed");
+    check(validDirection(sync.direction), "sync direction");
+    check(sync.rampMs <= CMD_MAX_RAMP_MS, "sync ramp");
+    check(sync.ratio >= -CMD_MAX_SYNC_RATIO && sync.ratio <= CMD_MAX_SYNC_RATIO, "sync ratio");
+  }
+
+  uint32_t seq;
+  if (parseAckCommand(payload, size, &seq) != CMD_OK) {
+    check(seq == 0, "ack seq cleared on error");
+  }
+
+  uint8_t level;
+  if (parseLogCommand(payload, size, &level) == CMD_OK) {
+    check(level <= 4, "log level");
+  } else {
+    check(level == 0, "log level cleared on error");
+  }
+
+  BenchCommand bench;
+  if (parseBenchCommand(payload, size, &bench) == CMD_OK && bench.start) {
+    check(bench.maxRate >= CMD_BENCH_RATE_MIN && bench.maxRate <= CMD_BENCH_RATE_MAX, "bench rate");
+    check(bench.stepMs >= CMD_BENCH_STEP_MIN && bench.stepMs <= CMD_BENCH_STEP_MAX, "bench step");
+  }
+
+  return 0;
+}
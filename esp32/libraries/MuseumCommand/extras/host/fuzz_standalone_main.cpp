@@ -0,0 +1,76 @@
+// Driver for compilers without libFuzzer (g++): replays the corpus files given
+// on the command line, then runs random mutations of them for a fixed count.
+//   ./fuzz_command_standalone corpus/* [-runs=N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static uint32_t rngState = 0x12345678u;
+
+static uint32_t nextRandom() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+static const char ALPHABET[] = "0123456789:LRlr-+.;,@ONOFFSPEEDRPMDIRMOVEHOMETRAJ\xff";
+
+static void mutate(std::vector<uint8_t>& input) {
+  switch (nextRandom() % 4) {
+    case 0:  // Replace a byte
+      if (!input.empty()) input[nextRandom() % input.size()] = ALPHABET[nextRandom() % (sizeof(ALPHABET) - 1)];
+      break;
+    case 1:  // Insert a byte
+      if (input.size() < 200) input.insert(input.begin() + (input.empty() ? 0 : nextRandom() % input.size()),
+                                            ALPHABET[nextRandom() % (sizeof(ALPHABET) - 1)]);
+      break;
+    case 2:  // Drop a byte
+      if (!input.empty()) input.erase(input.begin() + nextRandom() % input.size());
+      break;
+    default: // Random raw byte
+      if (!input.empty()) input[nextRandom() % input.size()] = (uint8_t)nextRandom();
+      break;
+  }
+}
+
+int main(int argc, char** argv) {
+  long runs = 1000000;
+  std::vector<std::vector<uint8_t>> corpus;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-runs=", 6) == 0) {
+      runs = atol(argv[i] + 6);
+      continue;
+    }
+    FILE* file = fopen(argv[i], "rb");
+    if (file == nullptr) continue;
+    std::vector<uint8_t> data;
+    int c;
+    while ((c = fgetc(file)) != EOF) data.push_back((uint8_t)c);
+    fclose(file);
+    corpus.push_back(data);
+  }
+  if (corpus.empty()) corpus.push_back(std::vector<uint8_t>());
+
+  for (const std::vector<uint8_t>& input : corpus) {
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+
+  for (long run = 0; run < runs; run++) {
+    std::vector<uint8_t> input = corpus[nextRandom() % corpus.size()];
+    int mutations = 1 + nextRandom() % 8;
+    for (int m = 0; m < mutations; m++) mutate(input);
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+
+  printf("fuzz_command_standalone: %zu corpus inputs, %ld mutated runs, no invariant violated\n",
+         corpus.size(), runs);
+  return 0;
+}
@@ -0,0 +1,422 @@
+#include "museum_command.h"
+
+static const uint8_t MAX_NUMBER_DIGITS = 10;   // Fits every range above without overflow checks per step
+static const uint8_t MAX_WIDE_DIGITS = 19;     // Still below 2^64 - Unix time in ms needs 13
+
+const char* cmdErrorName(CmdError error) {
+  switch (error) {
+    case CMD_OK:              return "OK";
+    case CMD_ERR_EMPTY:       return "EMPTY";
+    case CMD_ERR_TOO_LONG:    return "TOO_LONG";
+    case CMD_ERR_UNKNOWN:     return "UNKNOWN";
+    case CMD_ERR_MISSING_ARG: return "MISSING_ARG";
+    case CMD_ERR_EXTRA_ARG:   return "EXTRA_ARG";
+    case CMD_ERR_NOT_NUMBER:  return "NOT_NUMBER";
+    case CMD_ERR_RANGE:       return "RANGE";
+    case CMD_ERR_DIRECTION:   return "DIRECTION";
+  }
+  return "UNKNOWN";
+}
+
+// ---------------------------------------------------------------------------
+// Primitives
+// ---------------------------------------------------------------------------
+
+CmdError cmdTokenize(const char* payload, size_t length, char separator, CmdTokens* out) {
+  out->count = 0;
+  if (payload == nullptr || length == 0) return CMD_ERR_EMPTY;
+  if (length > CMD_MAX_PAYLOAD) return CMD_ERR_TOO_LONG;
+
+  size_t start = 0;
+  for (size_t i = 0; i <= length; i++) {
+    if (i < length && payload[i] != separator) continue;
+    if (out->count >= CMD_MAX_TOKENS) return CMD_ERR_TOO_LONG;
+
+    out->items[out->count].ptr = payload + start;
+    out->items[out->count].len = (uint16_t)(i - start);
+    out->count++;
+    start = i + 1;
+  }
+  return CMD_OK;
+}
+
+static char asciiUpper(char c) {
+  return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+bool cmdTokenEquals(CmdToken token, const char* keyword) {
+  uint16_t i = 0;
+  for (; i < token.len; i++) {
+    if (keyword[i] == '\0' || asciiUpper(token.ptr[i]) != asciiUpper(keyword[i])) return false;
+  }
+  return keyword[i] == '\0';
+}
+
+CmdToken cmdRemainder(const char* payload, size_t length, char separator, uint8_t count) {
+  size_t i = 0;
+  for (uint8_t found = 0; found < count; i++) {
+    if (i >= length) return CmdToken{payload + length, 0};
+    if (payload[i] == separator) found++;
+  }
+  return CmdToken{payload + i, (uint16_t)(length - i)};
+}
+
+// Unsigned digits only; up to maxDigits so the accumulator cannot overflow
+static CmdError parseDigits(const char* p, uint16_t len, uint8_t maxDigits, unsigned long long* out) {
+  if (len == 0) return CMD_ERR_MISSING_ARG;
+  if (len > maxDigits) return CMD_ERR_RANGE;
+
+  unsigned long long value = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    if (p[i] < '0' || p[i] > '9') return CMD_ERR_NOT_NUMBER;
+    value = value * 10 + (unsigned long long)(p[i] - '0');
+  }
+  *out = value;
+  return CMD_OK;
+}
+
+CmdError cmdParseLong(CmdToken token, long minValue, long maxValue, long* out) {
+  if (token.len == 0) return CMD_ERR_MISSING_ARG;
+
+  bool negative = token.ptr[0] == '-';
+  uint16_t skip = (negative || token.ptr[0] == '+') ? 1 : 0;
+  if (skip == token.len) return CMD_ERR_NOT_NUMBER;
+
+  unsigned long long magnitude = 0;
+  CmdError error = parseDigits(token.ptr + skip, token.len - skip, MAX_NUMBER_DIGITS, &magnitude);
+  if (error != CMD_OK) return error;
+
+  long long value = negative ? -(long long)magnitude : (long long)magnitude;
+  if (value < minValue || value > maxValue) return CMD_ERR_RANGE;
+  *out = (long)value;
+  return CMD_OK;
+}
+
+CmdError cmdParseULong(CmdToken token, unsigned long maxValue, unsigned long* out) {
+  unsigned long long value = 0;
+  CmdError error = parseDigits(token.ptr, token.len, MAX_NUMBER_DIGITS, &value);
+  if (error != CMD_OK) return error;
+  if (value > maxValue) return CMD_ERR_RANGE;
+  *out = (unsigned long)value;
+  return CMD_OK;
+}
+
+CmdError cmdParseULongLong(CmdToken token, unsigned long long maxValue, unsigned long long* out) {
+  unsigned long long value = 0;
+  CmdError error = parseDigits(token.ptr, token.len, MAX_WIDE_DIGITS, &value);
+  if (error != CMD_OK) return error;
+  if (value > maxValue) return CMD_ERR_RANGE;
+  *out = value;
+  return CMD_OK;
+}
+
+// [-+]digits[.digits] - no exponent, no inf/nan, so the result is always finite
+CmdError cmdParseFloat(CmdToken token, float minValue, float maxValue, float* out) {
+  if (token.len == 0) return CMD_ERR_MISSING_ARG;
+
+  uint16_t i = 0;
+  bool negative = false;
+  if (token.ptr[0] == '-' || token.ptr[0] == '+') {
+    negative = token.ptr[0] == '-';
+    i = 1;
+  }
+
+  uint16_t intStart = i;
+  while (i < token.len && token.ptr[i] >= '0' && token.ptr[i] <= '9') i++;
+  uint16_t intLen = i - intStart;
+
+  uint16_t fracStart = i;
+  uint16_t fracLen = 0;
+  if (i < token.len && token.ptr[i] == '.') {
+    fracStart = ++i;
+    while (i < token.len && token.ptr[i] >= '0' && token.ptr[i] <= '9') i++;
+    fracLen = i - fracStart;
+  }
+
+  if (i != token.len || (intLen == 0 && fracLen == 0)) return CMD_ERR_NOT_NUMBER;
+  if (intLen > MAX_NUMBER_DIGITS) return CMD_ERR_RANGE;
+
+  unsigned long long whole = 0;
+  if (intLen > 0) parseDigits(token.ptr + intStart, intLen, MAX_NUMBER_DIGITS, &whole);
+
+  float value = (float)whole;
+  float scale = 0.1f;
+  for (uint16_t f = 0; f < fracLen && f < 6; f++) {
+    value += (token.ptr[fracStart + f] - '0') * scale;
+    scale *= 0.1f;
+  }
+  if (negative) value = -value;
+
+  if (value < minValue || value > maxValue) return CMD_ERR_RANGE;
+  *out = value;
+  return CMD_OK;
+}
+
+CmdError cmdParseDirection(CmdToken token, char* out) {
+  if (token.len == 0) return CMD_ERR_MISSING_ARG;
+  if (token.len != 1) return CMD_ERR_DIRECTION;
+
+  char direction = asciiUpper(token.ptr[0]);
+  if (direction != 'L' && direction != 'R') return CMD_ERR_DIRECTION;
+  *out = direction;
+  return CMD_OK;
+}
+
+// Field count check: at least minCount, at most maxCount tokens
+static CmdError expectTokens(const CmdTokens& tokens, uint8_t minCount, uint8_t maxCount) {
+  if (tokens.count < minCount) return CMD_ERR_MISSING_ARG;
+  if (tokens.count > maxCount) return CMD_ERR_EXTRA_ARG;
+  return CMD_OK;
+}
+
+#define CMD_TRY(expr) do { CmdError _e = (expr); if (_e != CMD_OK) return _e; } while (0)
+
+// ---------------------------------------------------------------------------
+// Relay / effects
+// ---------------------------------------------------------------------------
+
+CmdError parseSwitchCommand(const char* payload, size_t length, bool allowStartStop, SwitchAction* action) {
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  CMD_TRY(expectTokens(tokens, 1, 1));
+
+  CmdToken word = tokens.items[0];
+  if (cmdTokenEquals(word, "ON") || cmdTokenEquals(word, "1") ||
+      (allowStartStop && cmdTokenEquals(word, "START"))) {
+    *action = SWITCH_ON;
+    return CMD_OK;
+  }
+  if (cmdTokenEquals(word, "OFF") || cmdTokenEquals(word, "0") ||
+      (allowStartStop && cmdTokenEquals(word, "STOP"))) {
+    *action = SWITCH_OFF;
+    return CMD_OK;
+  }
+  return CMD_ERR_UNKNOWN;
+}
+
+// ---------------------------------------------------------------------------
+// Motor
+// ---------------------------------------------------------------------------
+
+static CmdError parseSpeed(CmdToken token, int* out) {
+  long value = 0;
+  CMD_TRY(cmdParseLong(token, 0, CMD_MAX_SPEED, &value));
+  *out = (int)value;
+  return CMD_OK;
+}
+
+// <value>:<L|R>[:<rampMs>] shared by ON and RPM
+static CmdError parseDriveArgs(const CmdTokens& tokens, MotorCommand* cmd) {
+  CMD_TRY(expectTokens(tokens, 3, 4));
+  CMD_TRY(cmdParseDirection(tokens.items[2], &cmd->direction));
+  if (tokens.count == 4) {
+    CMD_TRY(cmdParseULong(tokens.items[3], CMD_MAX_RAMP_MS, &cmd->rampMs));
+  }
+  return CMD_OK;
+}
+
+CmdError parseMotorCommand(const char* payload, size_t length, MotorCommand* cmd) {
+  *cmd = MotorCommand{};
+  cmd->direction = 'L';
+
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  CmdToken word = tokens.items[0];
+
+  if (cmdTokenEquals(word, "ON")) {
+    cmd->type = MOTOR_CMD_ON;
+    CMD_TRY(parseDriveArgs(tokens, cmd));
+    return parseSpeed(tokens.items[1], &cmd->speed);
+  }
+
+  if (cmdTokenEquals(word, "RPM")) {
+    cmd->type = MOTOR_CMD_RPM;
+    CMD_TRY(parseDriveArgs(tokens, cmd));
+    return cmdParseFloat(tokens.items[1], 0.0f, CMD_MAX_RPM, &cmd->rpm);
+  }
+
+  if (cmdTokenEquals(word, "OFF")) {
+    cmd->type = MOTOR_CMD_OFF;
+    CMD_TRY(expectTokens(tokens, 1, 2));
+    if (tokens.count == 2) {
+      if (tokens.items[1].len == 0) return CMD_ERR_MISSING_ARG;
+      cmd->arg = tokens.items[1];
+    }
+    return CMD_OK;
+  }
+
+  if (cmdTokenEquals(word, "SPEED")) {
+    cmd->type = MOTOR_CMD_SPEED;
+    CMD_TRY(expectTokens(tokens, 2, 2));
+    return parseSpeed(tokens.items[1], &cmd->speed);
+  }
+
+  if (cmdTokenEquals(word, "DIR")) {
+    cmd->type = MOTOR_CMD_DIR;
+    CMD_TRY(expectTokens(tokens, 2, 2));
+    return cmdParseDirection(tokens.items[1], &cmd->direction);
+  }
+
+  if (cmdTokenEquals(word, "MOVE")) {
+    cmd->type = MOTOR_CMD_MOVE;
+    CMD_TRY(expectTokens(tokens, 2, 3));
+    CMD_TRY(cmdParseLong(tokens.items[1], -CMD_MAX_POSITION, CMD_MAX_POSITION, &cmd->target));
+    if (tokens.count == 3) {
+      cmd->hasSpeed = true;
+      CMD_TRY(parseSpeed(tokens.items[2], &cmd->speed));
+    }
+    return CMD_OK;
+  }
+
+  if (cmdTokenEquals(word, "HOME")) {
+    cmd->type = MOTOR_CMD_HOME;
+    return expectTokens(tokens, 1, 1);
+  }
+
+  if (cmdTokenEquals(word, "TRAJ")) {
+    cmd->type = MOTOR_CMD_TRAJ;
+    cmd->arg = cmdRemainder(payload, length, ':', 1);
+    return (cmd->arg.len == 0) ? CMD_ERR_MISSING_ARG : CMD_OK;
+  }
+
+  if (cmdTokenEquals(word, "TELEMETRY")) {
+    cmd->type = MOTOR_CMD_TELEMETRY;
+    CMD_TRY(expectTokens(tokens, 2, 2));
+    return cmdParseULong(tokens.items[1], CMD_MAX_TELEMETRY_MS, &cmd->intervalMs);
+  }
+
+  return CMD_ERR_UNKNOWN;
+}
+
+// ---------------------------------------------------------------------------
+// Sync group
+// ---------------------------------------------------------------------------
+
+CmdError parseSyncCommand(const char* payload, size_t length, SyncCommand* cmd) {
+  *cmd = SyncCommand{};
+  cmd->direction = 'L';
+  cmd->ratio = 1.0f;
+
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  CmdToken word = tokens.items[0];
+
+  if (cmdTokenEquals(word, "ON")) {
+    cmd->type = SYNC_CMD_ON;
+    CMD_TRY(expectTokens(tokens, 3, 5));
+    CMD_TRY(parseSpeed(tokens.items[1], &cmd->speed));
+    CMD_TRY(cmdParseDirection(tokens.items[2], &cmd->direction));
+    if (tokens.count >= 4) {
+      cmd->hasRamp = true;
+      CMD_TRY(cmdParseULong(tokens.items[3], CMD_MAX_RAMP_MS, &cmd->rampMs));
+    }
+    if (tokens.count == 5) {
+      CMD_TRY(cmdParseFloat(tokens.items[4], -CMD_MAX_SYNC_RATIO, CMD_MAX_SYNC_RATIO, &cmd->ratio));
+    }
+    return CMD_OK;
+  }
+
+  if (cmdTokenEquals(word, "SPEED")) {
+    cmd->type = SYNC_CMD_SPEED;
+    CMD_TRY(expectTokens(tokens, 2, 3));
+    CMD_TRY(parseSpeed(tokens.items[1], &cmd->speed));
+    if (tokens.count == 3) {
+      cmd->hasRamp = true;
+      CMD_TRY(cmdParseULong(tokens.items[2], CMD_MAX_RAMP_MS, &cmd->rampMs));
+    }
+    return CMD_OK;
+  }
+
+  if (cmdTokenEquals(word, "OFF")) {
+    cmd->type = SYNC_CMD_OFF;
+    CMD_TRY(expectTokens(tokens, 1, 2));
+    if (tokens.count == 2) {
+      cmd->hasRamp = true;
+      CMD_TRY(cmdParseULong(tokens.items[1], CMD_MAX_RAMP_MS, &cmd->rampMs));
+    }
+    return CMD_OK;
+  }
+
+  return CMD_ERR_UNKNOWN;
+}
+
+CmdError parseAckCommand(const char* payload, size_t length, uint32_t* seq) {
+  *seq = 0;
+
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  if (!cmdTokenEquals(tokens.items[0], "ACK")) return CMD_ERR_UNKNOWN;
+  CMD_TRY(expectTokens(tokens, 2, 2));
+
+  unsigned long value;
+  CMD_TRY(cmdParseULong(tokens.items[1], 0xFFFFFFFFUL, &value));
+  *seq = (uint32_t)value;
+  return CMD_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Log stream
+// ---------------------------------------------------------------------------
+
+CmdError parseLogCommand(const char* payload, size_t length, uint8_t* level) {
+  static const char* const LEVEL_NAMES[] = {"ERROR", "WARN", "INFO", "DEBUG"};
+  *level = 0;
+
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  CmdToken word = tokens.items[0];
+
+  if (cmdTokenEquals(word, "OFF")) {
+    return expectTokens(tokens, 1, 1);
+  }
+
+  if (!cmdTokenEquals(word, "ON")) return CMD_ERR_UNKNOWN;
+  CMD_TRY(expectTokens(tokens, 1, 2));
+  if (tokens.count == 1) {
+    *level = CMD_LOG_LEVEL_DEFAULT;
+    return CMD_OK;
+  }
+
+  for (uint8_t i = 0; i < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]); i++) {
+    if (cmdTokenEquals(tokens.items[1], LEVEL_NAMES[i])) {
+      *level = i + 1;
+      return CMD_OK;
+    }
+  }
+  return CMD_ERR_RANGE;
+}
+
+// ---------------------------------------------------------------------------
+// Load benchmark
+// ---------------------------------------------------------------------------
+
+CmdError parseBenchCommand(const char* payload, size_t length, BenchCommand* cmd) {
+  cmd->start = false;
+  cmd->maxRate = CMD_BENCH_RATE_DEFAULT;
+  cmd->stepMs = CMD_BENCH_STEP_DEFAULT;
+
+  CmdTokens tokens;
+  CMD_TRY(cmdTokenize(payload, length, ':', &tokens));
+  CmdToken word = tokens.items[0];
+
+  if (cmdTokenEquals(word, "STOP")) {
+    return expectTokens(tokens, 1, 1);
+  }
+
+  if (!cmdTokenEquals(word, "START")) return CMD_ERR_UNKNOWN;
+  CMD_TRY(expectTokens(tokens, 1, 3));
+
+  unsigned long value;
+  if (tokens.count >= 2) {
+    CMD_TRY(cmdParseULong(tokens.items[1], CMD_BENCH_RATE_MAX, &value));
+    if (value < CMD_BENCH_RATE_MIN) return CMD_ERR_RANGE;
+    cmd->maxRate = (uint16_t)value;
+  }
+  if (tokens.count == 3) {
+    CMD_TRY(cmdParseULong(tokens.items[2], CMD_BENCH_STEP_MAX, &value));
+    if (value < CMD_BENCH_STEP_MIN) return CMD_ERR_RANGE;
+    cmd->stepMs = (uint16_t)value;
+  }
+  cmd->start = true;
+  return CMD_OK;
+}
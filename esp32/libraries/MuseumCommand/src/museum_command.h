@@ -0,0 +1,167 @@
+#ifndef MUSEUM_COMMAND_H
+#define MUSEUM_COMMAND_H
+
+// Shared MQTT command grammar for the relay, motor and button firmwares.
+//
+// Everything works on (pointer, length) views into the received payload:
+// no copy, no NUL termination, no writes - PubSubClient's payload buffer
+// can be parsed as-is. No Arduino dependency, so the same code is built
+// by the host fuzz target and benchmark in extras/host.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CMD_MAX_TOKENS 8
+#define CMD_MAX_PAYLOAD 127
+
+// Range limits shared by firmware and validator
+#define CMD_MAX_SPEED 100
+#define CMD_MAX_RAMP_MS 600000UL          // 10 min
+#define CMD_MAX_TELEMETRY_MS 3600000UL    // 1 h
+#define CMD_MAX_POSITION 1000000000L
+#define CMD_MAX_RPM 10000.0f
+#define CMD_MAX_SYNC_RATIO 4.0f
+
+enum CmdError : uint8_t {
+  CMD_OK = 0,
+  CMD_ERR_EMPTY,          // Empty payload
+  CMD_ERR_TOO_LONG,       // Payload over CMD_MAX_PAYLOAD or more than CMD_MAX_TOKENS fields
+  CMD_ERR_UNKNOWN,        // Unknown command keyword
+  CMD_ERR_MISSING_ARG,
+  CMD_ERR_EXTRA_ARG,
+  CMD_ERR_NOT_NUMBER,
+  CMD_ERR_RANGE,          // Number outside the allowed range
+  CMD_ERR_DIRECTION       // Direction other than L / R
+};
+
+// Short name for feedback payloads ("ERROR:RANGE")
+const char* cmdErrorName(CmdError error);
+
+// View into the payload
+struct CmdToken {
+  const char* ptr;
+  uint16_t len;
+};
+
+struct CmdTokens {
+  CmdToken items[CMD_MAX_TOKENS];
+  uint8_t count;
+};
+
+// ---------------------------------------------------------------------------
+// Primitives
+// ---------------------------------------------------------------------------
+
+// Splits the payload on separator; tokens point into the payload
+CmdError cmdTokenize(const char* payload, size_t length, char separator, CmdTokens* out);
+
+// ASCII case-insensitive keyword compare
+bool cmdTokenEquals(CmdToken token, const char* keyword);
+
+// Everything after the first `count` separators as one view (TRAJ:..., OFF:<mode>)
+CmdToken cmdRemainder(const char* payload, size_t length, char separator, uint8_t count);
+
+CmdError cmdParseLong(CmdToken token, long minValue, long maxValue, long* out);
+CmdError cmdParseULong(CmdToken token, unsigned long maxValue, unsigned long* out);
+// Up to 19 digits - Unix time in ms (TRAJ:START:@<unixMs>)
+CmdError cmdParseULongLong(CmdToken token, unsigned long long maxValue, unsigned long long* out);
+CmdError cmdParseFloat(CmdToken token, float minValue, float maxValue, float* out);
+CmdError cmdParseDirection(CmdToken token, char* out);
+
+// ---------------------------------------------------------------------------
+// Relay / effects: ON | 1 | OFF | 0 (effects also START | STOP)
+// ---------------------------------------------------------------------------
+
+enum SwitchAction : uint8_t {
+  SWITCH_ON,
+  SWITCH_OFF
+};
+
+CmdError parseSwitchCommand(const char* payload, size_t length, bool allowStartStop, SwitchAction* action);
+
+// ---------------------------------------------------------------------------
+// Motor: room1/motorN
+// ---------------------------------------------------------------------------
+
+enum MotorCommandType : uint8_t {
+  MOTOR_CMD_ON,           // ON:<speed>:<L|R>[:<rampMs>]
+  MOTOR_CMD_RPM,          // RPM:<rpm>:<L|R>[:<rampMs>]
+  MOTOR_CMD_OFF,          // OFF[:<mode>]
+  MOTOR_CMD_SPEED,        // SPEED:<speed>
+  MOTOR_CMD_DIR,          // DIR:<L|R>
+  MOTOR_CMD_MOVE,         // MOVE:<target>[:<speed>]
+  MOTOR_CMD_HOME,         // HOME
+  MOTOR_CMD_TRAJ,         // TRAJ:<sub-command> (own grammar, passed through in arg)
+  MOTOR_CMD_TELEMETRY     // TELEMETRY:<ms>
+};
+
+struct MotorCommand {
+  MotorCommandType type;
+  int speed;
+  bool hasSpeed;          // MOVE: speed given
+  float rpm;
+  char direction;
+  unsigned long rampMs;
+  long target;
+  unsigned long intervalMs;
+  CmdToken arg;           // OFF mode / TRAJ sub-command, len 0 = none
+};
+
+CmdError parseMotorCommand(const char* payload, size_t length, MotorCommand* cmd);
+
+// ---------------------------------------------------------------------------
+// Motor sync group: room1/motors/sync
+// ---------------------------------------------------------------------------
+
+enum SyncCommandType : uint8_t {
+  SYNC_CMD_ON,            // ON:<speed>:<L|R>[:<rampMs>[:<ratio>]]
+  SYNC_CMD_SPEED,         // SPEED:<speed>[:<rampMs>]
+  SYNC_CMD_OFF            // OFF[:<rampMs>]
+};
+
+struct SyncCommand {
+  SyncCommandType type;
+  int speed;
+  char direction;
+  bool hasRamp;
+  unsigned long rampMs;
+  float ratio;
+};
+
+CmdError parseSyncCommand(const char* payload, size_t length, SyncCommand* cmd);
+
+// ---------------------------------------------------------------------------
+// Button trigger ack: roomX/scene/ack = ACK:<seq>
+// ---------------------------------------------------------------------------
+
+CmdError parseAckCommand(const char* payload, size_t length, uint32_t* seq);
+
+// ---------------------------------------------------------------------------
+// Remote log stream: devices/<id>/log/set = OFF | ON[:<ERROR|WARN|INFO|DEBUG>]
+// ---------------------------------------------------------------------------
+
+// Level numbering matches MuseumLog (0 = off ... 4 = DEBUG), plain ON = INFO
+#define CMD_LOG_LEVEL_DEFAULT 3
+
+CmdError parseLogCommand(const char* payload, size_t length, uint8_t* level);
+
+// ---------------------------------------------------------------------------
+// Load benchmark: devices/<id>/bench/set = START[:<maxRate>[:<stepMs>]] | STOP
+// ---------------------------------------------------------------------------
+
+#define CMD_BENCH_RATE_DEFAULT 1000     // Commands per second at the last step
+#define CMD_BENCH_RATE_MIN 10
+#define CMD_BENCH_RATE_MAX 5000
+#define CMD_BENCH_STEP_DEFAULT 2000     // ms per rate step
+#define CMD_BENCH_STEP_MIN 200
+#define CMD_BENCH_STEP_MAX 10000
+
+struct BenchCommand {
+  bool start;             // false = STOP
+  uint16_t maxRate;
+  uint16_t stepMs;
+};
+
+CmdError parseBenchCommand(const char* payload, size_t length, BenchCommand* cmd);
+
+#endif
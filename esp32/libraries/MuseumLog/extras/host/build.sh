@@ -0,0 +1,42 @@
+#!/bin/bash
+# Builds the host tests of the deferred log ring, the remote stream, the crash record and the
+# command flight recorder (Linux).
+#   ./build.sh        build into ./build
+#   ./build.sh run    build, run the tests and check the decoders (log / crash / flight) on their output
+set -e
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+SRC="$HERE/../../src"
+OUT="$HERE/build"
+mkdir -p "$OUT"
+
+# -no-pie: records keep 32-bit string / code addresses, the decoders resolve them in the ELF
+CXXFLAGS="-std=c++17 -g -O1 -Wall -Wextra -no-pie -pthread -fsanitize=address,undefined -I$SRC"
+CXX="$(command -v clang++ || command -v g++)"
+
+"$CXX" $CXXFLAGS "$SRC/museum_log_ring.cpp" "$SRC/museum_log_stream.cpp" "$HERE/test_ring.cpp" -o "$OUT/test_ring"
+"$CXX" $CXXFLAGS "$SRC/museum_log_stream.cpp" "$HERE/test_stream.cpp" -o "$OUT/test_stream"
+"$CXX" $CXXFLAGS "$SRC/museum_log_crash.cpp" "$HERE/test_crash.cpp" -o "$OUT/test_crash"
+"$CXX" $CXXFLAGS "$SRC/museum_log_flight.cpp" "$HERE/test_flight.cpp" -o "$OUT/test_flight"
+echo "Built: $OUT/test_ring, $OUT/test_stream, $OUT/test_crash, $OUT/test_flight"
+
+if [ "$1" = "run" ]; then
+  "$OUT/test_ring" "$OUT/ring.dump" "$OUT/ring.expected"
+  python3 "$HERE/log_decode.py" --elf "$OUT/test_ring" "$OUT/ring.dump" > "$OUT/ring.decoded"
+  diff -u "$OUT/ring.expected" "$OUT/ring.decoded"
+  echo "log_decode.py: OK"
+  "$OUT/test_stream"
+  "$OUT/test_crash" "$OUT/crash.json"
+  python3 "$HERE/crash_decode.py" --elf "$OUT/test_crash" "$OUT/crash.json" > "$OUT/crash.decoded"
+  grep -q "pc 0x[0-9a-f]*  crashSiteHandler+0x4" "$OUT/crash.decoded"
+  grep -q "#1 0x[0-9a-f]*  crashSiteCaller+0x8" "$OUT/crash.decoded"
+  echo "crash_decode.py: OK"
+  "$OUT/test_flight" "$OUT/flight.txt"
+  TZ=UTC python3 "$HERE/flight_decode.py" "$OUT/flight.txt" > "$OUT/flight.decoded"
+  grep -q "^1 boot(s) earlier:" "$OUT/flight.decoded"
+  grep -q "^ *[0-9]* ms  light/4 *OFF *pending *-$" "$OUT/flight.decoded"
+  grep -q "^ *2025-10-16 [0-9:.]* *[0-9]* ms  effects *group1 is \\.\\.\\. *ERROR:EMPTY" "$OUT/flight.decoded"
+  grep -q " ms  ? *ON *ignored " "$OUT/flight.decoded"
+  grep -q " ms  light/1 *ON *ERROR " "$OUT/flight.decoded"
+  echo "flight_decode.py: OK"
+fi
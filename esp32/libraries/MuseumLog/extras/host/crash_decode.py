@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Decode a MuseumLog crash record (devices/<id>/crash) using the firmware ELF.
+
+The device publishes the record once after a panic, watchdog or brownout reset
+(museum_log_crash.h). It holds the crashed task's PC and backtrace as raw
+addresses; this tool looks them up in the ELF symbol table.
+
+    mosquitto_sub -h <broker> -t devices/Room1_Relays_Ctrl/crash -C 1 > crash.json
+    python3 crash_decode.py --elf build/esp32_mqtt_controller_RELAY.ino.elf crash.json
+
+Anything before the first "{" is skipped, so "topic payload" lines work too.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from log_decode import Elf  # noqa: E402
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+class SymbolElf(Elf):
+    """Elf plus the function symbols of .symtab."""
+
+    def __init__(self, path):
+        super().__init__(path)
+        is64 = self.data[4] == 2
+        if is64:
+            shoff = struct.unpack_from("<Q", self.data, 0x28)[0]
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            header, symbol = "<IIQQQQII", struct.Struct("<IBBHQQ")
+        else:
+            shoff = struct.unpack_from("<I", self.data, 0x20)[0]
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            header, symbol = "<IIIIIIII", struct.Struct("<IIIBBH")
+
+        sections = [struct.unpack_from(header, self.data, shoff + i * shentsize) for i in range(shnum)]
+        self.functions = []
+        for _, kind, _, _, offset, size, link, _ in sections:
+            if kind != SHT_SYMTAB:
+                continue
+            strings = sections[link][4]
+            for start in range(offset, offset + size, symbol.size):
+                if is64:
+                    name, info, _, _, value, length = symbol.unpack_from(self.data, start)
+                else:
+                    name, value, length, info, _, _ = symbol.unpack_from(self.data, start)
+                if info & 0xF != STT_FUNC or value == 0:
+                    continue
+                end = self.data.find(b"\0", strings + name)
+                self.functions.append((value, max(length, 1), self.data[strings + name:end].decode()))
+        self.functions.sort()
+
+    def function(self, address):
+        for start, length, name in self.functions:
+            if start <= address < start + length:
+                return name, address - start
+            if start > address:
+                break
+        return None, 0
+
+
+def demangle(names):
+    tool = shutil.which("c++filt")
+    if not tool or not names:
+        return dict((name, name) for name in names)
+    result = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True, check=False)
+    lines = result.stdout.splitlines()
+    if len(lines) != len(names):
+        return dict((name, name) for name in names)
+    return dict(zip(names, lines))
+
+
+def decode(elf, record, out):
+    build = record.get("build", "")
+    if build not in ("", "00000000") and not elf.sha256.startswith(build):
+        print(f"warning: record is from build {build}, ELF is {elf.sha256[:8]} - symbols may be wrong",
+              file=sys.stderr)
+
+    print(f"boot {record.get('boot')}: {record.get('reason')}", file=out)
+    stage = record.get("stage")
+    if stage is not None:
+        print(f"stage: {stage} (entered at {record.get('stage_at_ms')} ms)", file=out)
+    else:
+        print("stage: none", file=out)
+    resets = record.get("resets", {})
+    print("resets: " + " ".join(f"{name}={count}" for name, count in resets.items()), file=out)
+
+    commands = record.get("cmds", [])
+    if commands:
+        print("last commands:", file=out)
+        for time_ms, text in commands:
+            print(f"  {time_ms:>10} ms  {text}", file=out)
+
+    core = record.get("core")
+    if core is None:
+        return
+    addresses = [("pc", int(core["pc"], 16))] + [(f"#{i}", int(a, 16)) for i, a in enumerate(core.get("bt", []))]
+    found = [(label, address) + elf.function(address) for label, address in addresses]
+    names = demangle(sorted(set(name for _, _, name, _ in found if name)))
+
+    print(f"core: task {core.get('task')}" + (" (backtrace corrupted)" if core.get("corrupted") else ""), file=out)
+    for label, address, name, offset in found:
+        where = f"{names[name]}+0x{offset:x}" if name else "?"
+        print(f"  {label:>3} 0x{address:08x}  {where}", file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--elf", required=True, help="ELF of the firmware that crashed")
+    parser.add_argument("record", nargs="?", help="crash record (default: stdin)")
+    options = parser.parse_args()
+
+    if options.record:
+        with open(options.record, encoding="utf-8", errors="replace") as handle:
+            text = handle.read()
+    else:
+        text = sys.stdin.read()
+    start = text.find("{")
+    if start < 0:
+        sys.exit("no crash record in the input")
+    record, _ = json.JSONDecoder().raw_decode(text[start:])
+
+    decode(SymbolElf(options.elf), record, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
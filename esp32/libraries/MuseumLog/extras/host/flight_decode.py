@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Decode a MuseumLog command flight recorder dump (devices/<id>/flight).
+
+The device answers devices/<id>/flight/get with its ring of the last commands
+(museum_log_flight.h): receive time in ms since boot, topic index, start of the
+payload, result and apply time. This tool expands the packed records and, for
+the current boot, converts the receive times to wall-clock time so they can be
+compared with the backend logs.
+
+    mosquitto_sub -h <broker> -t devices/Room1_Relays_Ctrl/flight -F '%U %t %p' -C 1 > flight.txt &
+    mosquitto_pub -h <broker> -t devices/Room1_Relays_Ctrl/flight/get -m ?
+    python3 flight_decode.py flight.txt
+
+The wall-clock reference is the receive time mosquitto_sub puts in front of the
+line (-F '%U ...'), or --received; without either only uptimes are printed.
+Records of earlier boots never get a wall-clock time.
+"""
+
+import argparse
+import base64
+import datetime
+import json
+import struct
+import sys
+
+# Packed record in flightFormat(): ms, apply us, topic, result, boot, length, text
+RECORD = struct.Struct("<IHBBBB10s")
+TOPIC_NONE = 0xFF
+APPLY_SATURATED = 0xFFFF
+LENGTH_SATURATED = 0xFF
+
+# FlightResult; 1..0x7F are CmdError codes of MuseumCommand (museum_command.h)
+RESULTS = {0x00: "ok", 0xFC: "ignored", 0xFD: "ERROR", 0xFE: "pending"}
+CMD_ERRORS = ["OK", "EMPTY", "TOO_LONG", "UNKNOWN", "MISSING_ARG", "EXTRA_ARG", "NOT_NUMBER", "RANGE", "DIRECTION"]
+
+
+def result_name(code):
+    if code in RESULTS:
+        return RESULTS[code]
+    if 0 < code < len(CMD_ERRORS):
+        return "ERROR:" + CMD_ERRORS[code]
+    return f"ERROR:{code}"
+
+
+def payload_text(length, text):
+    shown = text[:min(length, len(text))].decode("ascii", "replace")
+    shown = "".join(c if " " <= c <= "~" else "?" for c in shown)
+    return shown + ("..." if length > len(text) else "")
+
+
+def wall_clock(received, now_ms, time_ms):
+    stamp = received - (now_ms - time_ms) / 1000.0
+    return datetime.datetime.fromtimestamp(stamp).strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
+
+
+def decode(record, received, out):
+    boot = record.get("boot", 0)
+    now_ms = record.get("now_ms", 0)
+    topics = record.get("topics", [])
+    data = base64.b64decode(record.get("rec", ""))
+    if len(data) % RECORD.size:
+        sys.exit(f"dump holds {len(data)} bytes, not a multiple of {RECORD.size}")
+
+    header = f"boot {boot}, dump at {now_ms} ms, build {record.get('build', '?')}"
+    if received is not None:
+        header += f", received {wall_clock(received, 0, 0)}"
+    print(header, file=out)
+
+    current_boot = None
+    for offset in range(0, len(data), RECORD.size):
+        time_ms, apply_us, topic, result, record_boot, length, text = RECORD.unpack_from(data, offset)
+
+        # Only the low byte of the boot number is stored
+        boots_ago = (boot - record_boot) & 0xFF
+        if boots_ago != current_boot:
+            current_boot = boots_ago
+            print("current boot:" if boots_ago == 0 else f"{boots_ago} boot(s) earlier:", file=out)
+
+        when = wall_clock(received, now_ms, time_ms) if received is not None and boots_ago == 0 else ""
+        name = topics[topic] if topic < len(topics) else ("?" if topic == TOPIC_NONE else f"#{topic}")
+        if result == 0xFE:
+            apply = "-"
+        elif apply_us == APPLY_SATURATED:
+            apply = ">65535 us"
+        else:
+            apply = f"{apply_us} us"
+        shown = payload_text(length if length != LENGTH_SATURATED else len(text) + 1, text)
+        print(f"  {when:>23} {time_ms:>10} ms  {name:<16} {shown:<14} {result_name(result):<18} {apply}",
+              file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", nargs="?", help="flight dump (default: stdin)")
+    parser.add_argument("--received", type=float,
+                        help="unix time the dump was received (overrides the time in front of the line)")
+    options = parser.parse_args()
+
+    if options.dump:
+        with open(options.dump, encoding="utf-8", errors="replace") as handle:
+            text = handle.read()
+    else:
+        text = sys.stdin.read()
+    start = text.find("{")
+    if start < 0:
+        sys.exit("no flight dump in the input")
+    record, _ = json.JSONDecoder().raw_decode(text[start:])
+
+    received = options.received
+    if received is None:
+        prefix = text[:start].split()
+        try:
+            received = float(prefix[0]) if prefix else None
+        except ValueError:
+            received = None
+
+    decode(record, received, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Decode MuseumLog ring dumps back to text using the firmware ELF.
+
+The device prints the ring as "#LOGRING ...", "#LR <hex>" ... "#END" lines
+(logRingDump(), or automatically at boot after an OTA). Each record holds the
+*addresses* of the module name and the format string; this tool reads those
+strings out of the ELF and applies the stored arguments.
+
+    python3 log_decode.py --elf build/esp32_mqtt_button.ino.elf serial.log
+    python3 log_decode.py --elf firmware.elf < serial.log
+
+Lines that are not part of a dump are ignored, so a raw serial capture works.
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+
+# LogRecord in museum_log_ring.h: seq, timeMs, module, format, args[3], level, argc, reserved
+RECORD = struct.Struct("<7I2BH")
+MAX_ARGS = 3
+LEVELS = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+SPEC = re.compile(r"%([-+ #0-9.]*)(?:[lhzjt])*([a-zA-Z%])")
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+class Elf:
+    """Minimal ELF32/ELF64 (little endian) reader: loaded sections only."""
+
+    def __init__(self, path):
+        with open(path, "rb") as handle:
+            self.data = handle.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: not an ELF file")
+
+        self.sha256 = hashlib.sha256(self.data).hexdigest()
+        is64 = self.data[4] == 2
+        if is64:
+            shoff = struct.unpack_from("<Q", self.data, 0x28)[0]
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            header = "<IIQQQQ"
+        else:
+            shoff = struct.unpack_from("<I", self.data, 0x20)[0]
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            header = "<IIIIII"
+
+        self.sections = []
+        for index in range(shnum):
+            _, kind, flags, addr, offset, size = struct.unpack_from(header, self.data, shoff + index * shentsize)
+            if kind == SHT_PROGBITS and flags & SHF_ALLOC and addr:
+                self.sections.append((addr, size, offset))
+
+    def string(self, address):
+        for addr, size, offset in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    break
+                return self.data[start:end].decode("utf-8", "replace")
+        return "?"
+
+
+def format_message(elf, fmt, args):
+    pending = list(args)
+
+    def expand(match):
+        flags, conversion = match.group(1), match.group(2)
+        if conversion == "%":
+            return "%"
+        arg = pending.pop(0) if pending else 0
+        if conversion in "di":
+            value = arg - (1 << 32) if arg & 0x80000000 else arg
+            return ("%" + flags + "d") % value
+        if conversion == "u":
+            return ("%" + flags + "d") % arg
+        if conversion in "xXo":
+            return ("%" + flags + conversion) % arg
+        if conversion == "c":
+            return ("%" + flags + "c") % chr(arg & 0xFF)
+        if conversion == "s":
+            return ("%" + flags + "s") % elf.string(arg)
+        if conversion in "fFeEgG":
+            value = struct.unpack("<f", struct.pack("<I", arg))[0]
+            return ("%" + flags + conversion) % value
+        return "0x%08x" % arg
+
+    return SPEC.sub(expand, fmt)
+
+
+def decode(elf, lines, out):
+    boot = 0
+    printed_previous = printed_current = False
+
+    for line in lines:
+        if "#LOGRING" in line:
+            fields = dict(part.split("=", 1) for part in line.split("#LOGRING", 1)[1].split() if "=" in part)
+            build = fields.get("build", "")
+            boot = int(fields.get("boot", "0"))
+            printed_previous = printed_current = False
+            if build not in ("", "00000000") and not elf.sha256.startswith(build):
+                print(f"warning: dump is from build {build}, ELF is {elf.sha256[:8]} - strings may be wrong",
+                      file=sys.stderr)
+            continue
+
+        if "#LR " not in line:
+            continue
+        raw = bytes.fromhex(line.split("#LR ", 1)[1].strip())
+        if len(raw) != RECORD.size:
+            continue
+
+        seq, time_ms, module, fmt, *rest = RECORD.unpack(raw)
+        args, level, argc = rest[:MAX_ARGS], rest[MAX_ARGS], rest[MAX_ARGS + 1]
+
+        previous = seq - 1 < boot
+        if previous and not printed_previous:
+            print("--- previous boot ---", file=out)
+            printed_previous = True
+        elif not previous and printed_previous and not printed_current:
+            print("--- current boot ---", file=out)
+            printed_current = True
+
+        message = format_message(elf, elf.string(fmt), args[:min(argc, MAX_ARGS)])
+        print(f"[{LEVELS.get(level, '?')}] {time_ms}ms {elf.string(module)} - {message}", file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--elf", required=True, help="ELF of the firmware that wrote the dump")
+    parser.add_argument("capture", nargs="?", help="serial capture (default: stdin)")
+    options = parser.parse_args()
+
+    elf = Elf(options.elf)
+    if options.capture:
+        with open(options.capture, encoding="utf-8", errors="replace") as handle:
+            decode(elf, handle, sys.stdout)
+    else:
+        decode(elf, sys.stdin, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+// Host test of the crash record: reset classification, RTC stage / command
+// capture, NVS-style counters and the record consumed by crash_decode.py.
+//   ./test_crash <record file>
+
+#include "museum_log_crash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+enum TestStage { STAGE_OTA, STAGE_MQTT, STAGE_EFFECTS, STAGE_COUNT };
+static const char* const STAGE_NAMES[STAGE_COUNT] = {"ota", "mqtt", "effects"};
+
+static char record[CRASH_PAYLOAD_MAX];
+
+// Stand-ins for the crashed code - crash_decode.py must find them by address
+extern "C" __attribute__((noinline)) uint32_t crashSiteHandler() {
+  return (uint32_t)(uintptr_t)&crashSiteHandler + 4;
+}
+
+extern "C" __attribute__((noinline)) uint32_t crashSiteCaller() {
+  return (uint32_t)(uintptr_t)&crashSiteCaller + 8;
+}
+
+static void boot(CrashReset reason, const CrashCore* core = nullptr) {
+  crashCapture(STAGE_NAMES, STAGE_COUNT, reason, core);
+}
+
+static void testNormalBoots() {
+  boot(CRASH_RESET_POWER_ON);
+  CHECK(!crashPending());
+  CHECK(crashFormat(record, sizeof(record)) == 0);
+  CHECK(record[0] == '\0');
+
+  crashMarkStage(STAGE_MQTT);
+  boot(CRASH_RESET_SOFTWARE);
+  CHECK(!crashPending());
+  CHECK(crashLastReset() == CRASH_RESET_SOFTWARE);
+  CHECK(crashCounters().boots == 2);
+  CHECK(crashCounters().resets[CRASH_RESET_POWER_ON] == 1);
+  CHECK(crashCounters().resets[CRASH_RESET_SOFTWARE] == 1);
+}
+
+static void testBrownoutOutsideStage() {
+  crashMarkStage(STAGE_EFFECTS);
+  crashMarkStage(CRASH_STAGE_NONE);
+  boot(CRASH_RESET_BROWNOUT);
+
+  CHECK(crashPending());
+  CHECK(crashFormat(record, sizeof(record)) > 0);
+  CHECK(strstr(record, "\"reason\":\"brownout\"") != nullptr);
+  CHECK(strstr(record, "\"stage\":null") != nullptr);
+  CHECK(strstr(record, "\"cmds\":[]") != nullptr);
+  CHECK(strstr(record, "\"core\"") == nullptr);
+  CHECK(strstr(record, "\"brownout\":1") != nullptr);
+
+  crashAcknowledge();
+  CHECK(!crashPending());
+  CHECK(crashFormat(record, sizeof(record)) == 0);
+}
+
+static void testCommandRing() {
+  // More than fits, one with characters that must not reach the JSON raw
+  char payload[16];
+  for (int i = 0; i < CRASH_CMD_COUNT + 3; i++) {
+    snprintf(payload, sizeof(payload), "ON%d", i);
+    crashNoteCommand("light/4", payload, strlen(payload));
+  }
+  const char quoted[] = "{\"a\":\n1}";
+  crashNoteCommand("effect", quoted, sizeof(quoted) - 1);
+  crashNoteCommand("motor1", "ON:80:L:with a very long tail", 29);
+  crashMarkStage(STAGE_MQTT);
+
+  boot(CRASH_RESET_TASK_WDT);
+  CHECK(crashPending());
+  CHECK(crashFormat(record, sizeof(record)) > 0);
+  CHECK(strstr(record, "\"reason\":\"task_wdt\"") != nullptr);
+  CHECK(strstr(record, "\"stage\":\"mqtt\"") != nullptr);
+  CHECK(strstr(record, "\"stage_at_ms\":") != nullptr);
+
+  // Oldest dropped, order kept, newest last
+  CHECK(strstr(record, "\"light/4 ON4\"") == nullptr);
+  CHECK(strstr(record, "\"light/4 ON5\"") != nullptr);
+  CHECK(strstr(record, "\"light/4 ON10\"") != nullptr);
+  CHECK(strstr(record, "ON5\"") < strstr(record, "ON10\""));
+  CHECK(strstr(record, "\"effect {?a?:?1}\"") != nullptr);
+  CHECK(strstr(record, "\"motor1 ON:80:L:with a v\"]]") != nullptr);
+  crashAcknowledge();
+}
+
+static void testTruncated() {
+  crashMarkStage(STAGE_OTA);
+  boot(CRASH_RESET_PANIC);
+  CHECK(crashFormat(record, sizeof(record)) > 0);
+  CHECK(strstr(record, "\"stage\":\"ota\"") != nullptr);
+
+  // Truncated buffer drops the whole record rather than sending broken JSON
+  char small[64];
+  CHECK(crashFormat(small, sizeof(small)) == 0);
+  CHECK(small[0] == '\0');
+  crashAcknowledge();
+}
+
+static void writeCoreRecord(const char* path) {
+  crashNoteCommand("light/4", "ON", 2);
+  crashMarkStage(STAGE_EFFECTS);
+
+  CrashCore core = {};
+  core.present = true;
+  strcpy(core.task, "loopTask");
+  core.pc = crashSiteHandler();
+  core.backtrace[0] = core.pc;
+  core.backtrace[1] = crashSiteCaller();
+  core.depth = 2;
+  boot(CRASH_RESET_PANIC, &core);
+
+  CHECK(crashFormat(record, sizeof(record)) > 0);
+  CHECK(strstr(record, "\"core\":{\"task\":\"loopTask\"") != nullptr);
+  CHECK(strstr(record, "\"corrupted\":false") != nullptr);
+  CHECK(strstr(record, "\"panic\":2") != nullptr);
+  CHECK(strstr(record, "\"task_wdt\":1") != nullptr);
+
+  FILE* out = fopen(path, "w");
+  CHECK(out != nullptr);
+  if (out == nullptr) return;
+  fprintf(out, "devices/test/crash %s\n", record);
+  fclose(out);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <record file>\n", argv[0]);
+    return 2;
+  }
+
+  testNormalBoots();
+  testBrownoutOutsideStage();
+  testCommandRing();
+  testTruncated();
+  writeCoreRecord(argv[1]);
+
+  if (failures > 0) {
+    fprintf(stderr, "test_crash: %d failure(s)\n", failures);
+    return 1;
+  }
+  printf("test_crash: OK\n");
+  return 0;
+}
@@ -0,0 +1,101 @@
+// Host test of the command flight recorder: record layout, pending records
+// across a reset, ring wrap and the dump consumed by flight_decode.py.
+//   ./test_flight <dump file>
+
+#include "museum_log_flight.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+static const char* const TOPICS[] = {"light/1", "light/4", "effects", "STOP"};
+
+static const char* topicName(uint8_t topic) {
+  return topic < 4 ? TOPICS[topic] : nullptr;
+}
+
+static char dump[FLIGHT_PAYLOAD_MAX];
+
+static void command(uint8_t topic, const char* payload, uint8_t result) {
+  flightReceive(topic, payload, strlen(payload));
+  flightComplete(result);
+}
+
+static void testEmpty() {
+  flightBegin(topicName, 4);
+  CHECK(flightCount() == 0);
+  CHECK(flightFormat(dump, sizeof(dump)) > 0);
+  CHECK(strstr(dump, "{\"boot\":1,\"now_ms\":") == dump);
+  CHECK(strstr(dump, "\"topics\":[\"light/1\",\"light/4\",\"effects\",\"STOP\"]") != nullptr);
+  CHECK(strstr(dump, "\"rec\":\"\"}") != nullptr);
+}
+
+static void testPendingAcrossReset() {
+  command(0, "ON", FLIGHT_OK);
+  flightReceive(1, "OFF", 3);   // Reset before flightComplete()
+
+  flightBegin(topicName, 4);
+  flightComplete(FLIGHT_OK);    // Nothing open after a boot
+  CHECK(flightCount() == 2);
+  CHECK(flightFormat(dump, sizeof(dump)) > 0);
+  CHECK(strstr(dump, "{\"boot\":2,") == dump);
+}
+
+static void testWrap() {
+  for (int i = 0; i < FLIGHT_RECORD_COUNT - 6; i++) command(1, i % 2 ? "ON" : "OFF", FLIGHT_OK);
+  command(2, "group1 is not a payload", 1);             // Parse error code (CMD_ERR_EMPTY)
+  command(3, "STOP", FLIGHT_OK);
+  command(FLIGHT_TOPIC_NONE, "ON", FLIGHT_IGNORED);
+  command(0, "ON", FLIGHT_REFUSED);
+  CHECK(flightCount() == FLIGHT_RECORD_COUNT);
+
+  // Oldest dropped: the first ON of boot 1 is gone, its pending OFF is kept
+  command(0, "OFF", FLIGHT_OK);
+  CHECK(flightCount() == FLIGHT_RECORD_COUNT);
+
+  // Dump too large for the buffer is dropped whole
+  char small[128];
+  CHECK(flightFormat(small, sizeof(small)) == 0);
+  CHECK(small[0] == '\0');
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+    return 2;
+  }
+
+  testEmpty();
+  testPendingAcrossReset();
+  testWrap();
+
+  size_t length = flightFormat(dump, sizeof(dump));
+  CHECK(length > 0);
+  // 24 records = 480 B -> 640 base64 characters
+  const char* rec = strstr(dump, "\"rec\":\"");
+  CHECK(rec != nullptr && strlen(rec) == 7 + 640 + 2);
+
+  FILE* out = fopen(argv[1], "w");
+  CHECK(out != nullptr);
+  if (out != nullptr) {
+    // mosquitto_sub -F '%U %t %p': receive time in front of the topic
+    fprintf(out, "1760616000.500000000 devices/test/flight %s\n", dump);
+    fclose(out);
+  }
+
+  if (failures > 0) {
+    fprintf(stderr, "test_flight: %d failure(s)\n", failures);
+    return 1;
+  }
+  printf("test_flight: OK\n");
+  return 0;
+}
@@ -0,0 +1,241 @@
+// Host test of the deferred log ring: formatting, overflow accounting,
+// concurrent writers and the dump consumed by log_decode.py.
+//   ./test_ring <dump file> <expected file>
+
+#include "museum_log.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#define LOG_MODULE_TEST LOG_LEVEL_INFO
+#define LOG_MODULE_HW   LOG_LEVEL_DEBUG
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+enum TestState { STATE_IDLE, STATE_RUN };
+
+static void drainAll() {
+  LogRecord record;
+  uint32_t lost;
+  while (logRingNext(&record, &lost)) {
+  }
+}
+
+// Message part of a formatted line ("[INFO] 12ms HW - <message>")
+static const char* messageOf(const char* line) {
+  const char* dash = strstr(line, " - ");
+  return dash != nullptr ? dash + 3 : line;
+}
+
+static bool nextMessage(char* line, size_t size) {
+  LogRecord record;
+  uint32_t lost;
+  if (!logRingNext(&record, &lost)) return false;
+  logRingFormat(record, line, size);
+  return true;
+}
+
+static void testFormatting() {
+  char line[LOG_LINE_MAX];
+
+  LOGR_INFO(HW, "%s -> %s", "Relay1", "ON");
+  LOGR_INFO(HW, "Motor%d CMD: ON Spd:%d Dir:%c", 2, 80, 'L');
+  LOGR_WARN(HW, "temp %.1f C, raw %04x, delta %+d", 21.5f, 0xbeefu, -3);
+  LOGR_ERROR(HW, "%lu ms, 100%%", 1234UL);
+  LOGR_DEBUG(HW, "no args");
+  LOGR_INFO(HW, "state %d", STATE_RUN);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "Relay1 -> ON") == 0);
+  CHECK(strncmp(line, "[INFO] ", 7) == 0);
+  CHECK(strstr(line, "ms HW - ") != nullptr);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "Motor2 CMD: ON Spd:80 Dir:L") == 0);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "temp 21.5 C, raw beef, delta -3") == 0);
+  CHECK(strncmp(line, "[WARN] ", 7) == 0);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "1234 ms, 100%") == 0);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "no args") == 0);
+  CHECK(strncmp(line, "[DEBUG] ", 8) == 0);
+
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "state 1") == 0);
+
+  CHECK(!nextMessage(line, sizeof(line)));
+
+  // Truncation keeps the buffer terminated
+  char small[24];
+  LOGR_INFO(HW, "%s and a long tail that does not fit", "Relay1");
+  CHECK(nextMessage(small, sizeof(small)));
+  CHECK(strlen(small) == sizeof(small) - 1);
+}
+
+static void testCompiledOut() {
+  // LOG_MODULE_TEST is INFO - the DEBUG record must not exist
+  LOGR_DEBUG(TEST, "compiled out %d", 1);
+  LOGR_INFO(TEST, "kept %d", 2);
+
+  char line[LOG_LINE_MAX];
+  CHECK(nextMessage(line, sizeof(line)));
+  CHECK(strcmp(messageOf(line), "kept 2") == 0);
+  CHECK(!nextMessage(line, sizeof(line)));
+}
+
+static void testOverflow() {
+  const int written = LOG_RING_SIZE + 36;
+  for (int i = 0; i < written; i++) {
+    LOGR_INFO(HW, "record %d", i);
+  }
+
+  LogRecord record;
+  uint32_t lost;
+  uint32_t totalLost = 0;
+  int read = 0;
+  int first = -1;
+  while (logRingNext(&record, &lost)) {
+    totalLost += lost;
+    if (first < 0) first = (int)record.args[0];
+    read++;
+  }
+  totalLost += lost;
+
+  CHECK(read == LOG_RING_SIZE);
+  CHECK(totalLost == 36);
+  CHECK(first == 36);
+}
+
+static void testConcurrentWriters() {
+  const int threads = 4;
+  const int perThread = 20000;
+  std::atomic<bool> done(false);
+  std::vector<std::thread> writers;
+
+  uint32_t read = 0;
+  uint32_t lostTotal = 0;
+  uint32_t torn = 0;
+
+  std::thread reader([&]() {
+    LogRecord record;
+    uint32_t lost;
+    for (;;) {
+      bool finished = done.load();
+      bool found = logRingNext(&record, &lost);
+      lostTotal += lost;
+      if (found) {
+        read++;
+        // args[1] / args[2] are derived from args[0] - a torn record breaks this
+        if (record.args[1] != record.args[0] * 3 || record.args[2] != (record.args[0] ^ 0x5a5a5a5a)) torn++;
+      } else if (finished) {
+        break;
+      }
+    }
+  });
+
+  for (int t = 0; t < threads; t++) {
+    writers.emplace_back([t, perThread]() {
+      for (int i = 0; i < perThread; i++) {
+        uint32_t value = (uint32_t)(t * perThread + i);
+        LOGR_INFO(HW, "%u %u %u", value, value * 3, value ^ 0x5a5a5a5au);
+        if (i % 16 == 0) std::this_thread::yield();   // Give the reader a chance to keep up
+      }
+    });
+  }
+  for (std::thread& writer : writers) writer.join();
+  done.store(true);
+  reader.join();
+
+  CHECK(torn == 0);
+  CHECK(read + lostTotal == (uint32_t)(threads * perThread));
+  printf("concurrent: %u read, %u lost (overwritten before read), %u torn\n", read, lostTotal, torn);
+}
+
+// logRingBegin() after a (simulated) watchdog reset keeps the records
+static void testReboot() {
+  LOGR_WARN(HW, "before reset %d", 1);
+  LOGR_WARN(HW, "before reset %d", 2);
+  logRingBegin();
+
+  LogRecord record;
+  uint32_t lost;
+  int previous = 0;
+  int last = 0;
+  while (logRingNext(&record, &lost)) {
+    CHECK(logRingFromPreviousBoot(record));
+    last = (int)record.args[0];
+    previous++;
+  }
+  CHECK(previous == LOG_RING_SIZE);   // The whole ring is history now
+  CHECK(last == 2);
+
+  LOGR_INFO(HW, "after reset %d", 3);
+  CHECK(logRingNext(&record, &lost));
+  CHECK(!logRingFromPreviousBoot(record));
+  CHECK(record.args[0] == 3);
+}
+
+// Same line format as logRingDump() on the device
+static void writeDump(const char* dumpPath, const char* expectedPath) {
+  LOGR_INFO(HW, "%s -> %s", "Relay1", "ON");
+  LOGR_WARN(HW, "Motor%d stop: %s", 1, "BRAKE");
+  LOGR_ERROR(HW, "temp %.2f raw %x", -4.25f, 0x1fu);
+  LOGR_DEBUG(HW, "%c%c %d%%", 'o', 'k', 100);
+
+  FILE* dump = fopen(dumpPath, "w");
+  FILE* expected = fopen(expectedPath, "w");
+  CHECK(dump != nullptr && expected != nullptr);
+  if (dump == nullptr || expected == nullptr) return;
+
+  fprintf(dump, "serial noise before the dump\n#LOGRING build=00000000 head=0 boot=0\n");
+  LogRecord record;
+  uint32_t lost;
+  char line[LOG_LINE_MAX];
+  while (logRingNext(&record, &lost)) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    fprintf(dump, "#LR ");
+    for (size_t i = 0; i < sizeof(record); i++) fprintf(dump, "%02x", bytes[i]);
+    fprintf(dump, "\n");
+
+    logRingFormat(record, line, sizeof(line));
+    fprintf(expected, "%s\n", line);
+  }
+  fprintf(dump, "#END\n");
+  fclose(dump);
+  fclose(expected);
+}
+
+int main(int argc, char** argv) {
+  logRingBegin();
+  drainAll();
+
+  testFormatting();
+  testCompiledOut();
+  testOverflow();
+  testConcurrentWriters();
+  drainAll();
+  testReboot();
+  if (argc >= 3) writeDump(argv[1], argv[2]);
+
+  if (failures > 0) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("test_ring: OK\n");
+  return 0;
+}
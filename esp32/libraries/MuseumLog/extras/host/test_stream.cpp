@@ -0,0 +1,228 @@
+// Host test of the remote log stream: runtime level, per-level rate limits,
+// drop-oldest buffer and batch / commit accounting.
+//   ./test_stream
+
+#include "museum_log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+static char payload[LOG_STREAM_BATCH_MAX];
+
+static int countLines(const char* text) {
+  if (*text == '\0') return 0;
+  int lines = 1;
+  for (const char* p = text; *p != '\0'; p++) {
+    if (*p == '\n') lines++;
+  }
+  return lines;
+}
+
+static void reset(uint8_t level) {
+  logStreamSetLevel(LOG_LEVEL_NONE);
+  for (uint8_t l = LOG_LEVEL_ERROR; l <= LOG_LEVEL_DEBUG; l++) logStreamSetRate(l, 1000, 1000);
+  logStreamSetLevel(level);
+}
+
+static void testOffByDefault() {
+  CHECK(logStreamLevel() == LOG_LEVEL_NONE);
+  logStreamWrite(LOG_LEVEL_ERROR, "HW", "not captured");
+  CHECK(logStreamStats().pending == 0);
+}
+
+static void testLevelFilter() {
+  reset(LOG_LEVEL_WARN);
+  logStreamWrite(LOG_LEVEL_ERROR, "HW", "error");
+  logStreamWrite(LOG_LEVEL_WARN, "MQTT", "warn");
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "info");
+  logStreamWriteLine(LOG_LEVEL_DEBUG, "[DEBUG] 1ms HW - debug");
+
+  uint32_t batchEnd;
+  size_t length = logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(length == strlen(payload));
+  CHECK(countLines(payload) == 2);
+  CHECK(strncmp(payload, "[ERROR] ", 8) == 0);
+  CHECK(strstr(payload, "ms HW - error\n[WARN] ") != nullptr);
+  CHECK(strstr(payload, "MQTT - warn") != nullptr);
+  logStreamCommit(batchEnd);
+  CHECK(logStreamStats().pending == 0);
+  CHECK(logStreamBatch(payload, sizeof(payload), &batchEnd) == 0);
+}
+
+static void testRateLimit() {
+  reset(LOG_LEVEL_DEBUG);
+  logStreamSetRate(LOG_LEVEL_INFO, 0, 3);   // Burst only, no refill
+
+  for (int i = 0; i < 10; i++) logStreamWrite(LOG_LEVEL_INFO, "HW", "info");
+  logStreamWrite(LOG_LEVEL_ERROR, "HW", "error still passes");
+
+  LogStreamStats stats = logStreamStats();
+  CHECK(stats.pending == 4);
+  CHECK(stats.rateLimited == 7);
+
+  uint32_t batchEnd;
+  logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(strncmp(payload, "--- 7 lines dropped (7 rate limit, 0 buffer full) ---\n", 54) == 0);
+  CHECK(countLines(payload) == 5);
+  logStreamCommit(batchEnd);
+  CHECK(logStreamStats().rateLimited == 0);
+}
+
+static void testDropOldest() {
+  reset(LOG_LEVEL_DEBUG);
+  char message[32];
+  for (int i = 0; i < LOG_STREAM_SLOTS + 5; i++) {
+    snprintf(message, sizeof(message), "line %d", i);
+    logStreamWrite(LOG_LEVEL_WARN, "HW", message);
+  }
+
+  LogStreamStats stats = logStreamStats();
+  CHECK(stats.pending == LOG_STREAM_SLOTS);
+  CHECK(stats.overwritten == 5);
+
+  uint32_t batchEnd;
+  logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(strstr(payload, "(0 rate limit, 5 buffer full)") != nullptr);
+  CHECK(strstr(payload, "- line 4\n") == nullptr);
+  CHECK(strstr(payload, "- line 5\n") != nullptr);
+}
+
+// A failed publish keeps the lines; overwrites during the publish are not sent twice
+static void testCommit() {
+  reset(LOG_LEVEL_DEBUG);
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "first");
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "second");
+
+  uint32_t batchEnd;
+  logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(countLines(payload) == 2);
+  // Publish failed - no commit, the next batch has the same lines plus the new one
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "third");
+  logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(countLines(payload) == 3);
+
+  // Buffer wraps while the batch is in flight
+  for (int i = 0; i < LOG_STREAM_SLOTS; i++) logStreamWrite(LOG_LEVEL_INFO, "HW", "newer");
+  logStreamCommit(batchEnd);
+  LogStreamStats stats = logStreamStats();
+  CHECK(stats.pending == LOG_STREAM_SLOTS);
+
+  logStreamBatch(payload, sizeof(payload), &batchEnd);
+  CHECK(strstr(payload, "third") == nullptr);
+  CHECK(strstr(payload, "second") == nullptr);
+}
+
+// The batch never exceeds the buffer and stops at a whole line
+static void testBatchLimit() {
+  reset(LOG_LEVEL_DEBUG);
+  char message[LOG_STREAM_LINE];
+  memset(message, 'x', sizeof(message) - 1);
+  message[sizeof(message) - 1] = '\0';
+  for (int i = 0; i < LOG_STREAM_SLOTS; i++) logStreamWrite(LOG_LEVEL_INFO, "HW", message);
+
+  char small[300];
+  uint32_t batchEnd;
+  size_t length = logStreamBatch(small, sizeof(small), &batchEnd);
+  CHECK(length < sizeof(small));
+  CHECK(countLines(small) == 2);   // Lines are truncated to LOG_STREAM_LINE - 1
+  logStreamCommit(batchEnd);
+  CHECK(logStreamStats().pending == LOG_STREAM_SLOTS - 2);
+
+  logStreamSetLevel(LOG_LEVEL_NONE);
+  CHECK(logStreamStats().pending == 0);
+}
+
+static std::vector<std::string> published;
+
+static bool capturePublish(const char* text, size_t length) {
+  published.emplace_back(text, length);
+  return true;
+}
+
+static void testLoop() {
+  reset(LOG_LEVEL_DEBUG);
+  published.clear();
+
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "early");
+  logStreamLoop(capturePublish);   // First call after a long idle time - sends
+  CHECK(published.size() == 1);
+
+  logStreamWrite(LOG_LEVEL_INFO, "HW", "not yet");
+  logStreamLoop(capturePublish);   // Interval not over, buffer not half full
+  CHECK(published.size() == 1);
+
+  for (int i = 0; i < LOG_STREAM_SLOTS / 2; i++) logStreamWrite(LOG_LEVEL_INFO, "HW", "burst");
+  logStreamLoop(capturePublish);   // Half full - sends early
+  CHECK(published.size() == 2);
+  CHECK(logStreamStats().pending == 0);
+}
+
+static void testConcurrentWriters() {
+  reset(LOG_LEVEL_DEBUG);
+  const int threads = 4;
+  const int perThread = 5000;
+  std::vector<std::thread> writers;
+  for (int t = 0; t < threads; t++) {
+    writers.emplace_back([perThread]() {
+      for (int i = 0; i < perThread; i++) {
+        logStreamWrite(LOG_LEVEL_WARN, "HW", "concurrent");
+        if (i % 16 == 0) std::this_thread::yield();
+      }
+    });
+  }
+
+  uint32_t received = 0;
+  uint32_t reportedLost = 0;
+  auto consume = [&]() {
+    uint32_t batchEnd;
+    if (logStreamBatch(payload, sizeof(payload), &batchEnd) == 0) return;
+    unsigned long dropped, rate, full;
+    const char* text = payload;
+    if (sscanf(payload, "--- %lu lines dropped (%lu rate limit, %lu buffer full)", &dropped, &rate, &full) == 3) {
+      reportedLost += dropped;
+      text = strchr(payload, '\n') != nullptr ? strchr(payload, '\n') + 1 : "";
+    }
+    received += countLines(text);
+    logStreamCommit(batchEnd);
+  };
+
+  for (int i = 0; i < 2000; i++) consume();
+  for (std::thread& writer : writers) writer.join();
+  for (int i = 0; i < 20; i++) consume();
+
+  // Every line is either received or reported; overwrites during a batch may be counted twice
+  CHECK(received + reportedLost >= (uint32_t)(threads * perThread));
+  CHECK(logStreamStats().pending == 0);
+  printf("concurrent: %u received, %u reported dropped\n", received, reportedLost);
+}
+
+int main() {
+  testOffByDefault();
+  testLevelFilter();
+  testRateLimit();
+  testDropOldest();
+  testCommit();
+  testBatchLimit();
+  testLoop();
+  testConcurrentWriters();
+
+  if (failures > 0) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("test_stream: OK\n");
+  return 0;
+}
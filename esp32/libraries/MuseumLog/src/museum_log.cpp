@@ -0,0 +1,28 @@
+#include "museum_log.h"
+#include "museum_log_stream.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+
+// "[INFO] 1234ms MQTT - message"
+void logWrite(uint8_t level, const char* module, const char* message) {
+  Serial.print('[');
+  Serial.print(logLevelName(level));
+  Serial.print("] ");
+  Serial.print(millis());
+  Serial.print("ms ");
+  Serial.print(module);
+  Serial.print(" - ");
+  Serial.println(message);
+
+  logStreamWrite(level, module, message);
+}
+
+void logWritef(uint8_t level, const char* module, const char* format, ...) {
+  char line[LOG_LINE_MAX];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  logWrite(level, module, line);
+}
@@ -0,0 +1,99 @@
+#ifndef MUSEUM_LOG_H
+#define MUSEUM_LOG_H
+
+// Compile-time leveled logging shared by the relay, motor and button firmwares.
+//
+// Every call names its module: LOG_INFO(MQTT, "Connected"). The firmware's
+// config.h sets LOG_MODULE_<name> to the highest level compiled in for that
+// module (usually just LOG_LEVEL). A disabled call is an `if constexpr (false)`
+// branch - the message, String concatenation included, is never built and no
+// code is emitted for it.
+//
+// LOGF_* take a printf format and render into a stack buffer, so hot paths can
+// log without touching the heap even when the level is enabled.
+//
+// LOGR_* take the same format but only store a binary record in the no-init
+// ring (museum_log_ring.h); formatting happens later in logRingDrain() or on
+// the host. For hot paths and for lines that must survive a watchdog reset.
+//
+// Both paths also feed the remote stream (museum_log_stream.h) when it has
+// been switched on at runtime.
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "museum_log_ring.h"
+#include "museum_log_stream.h"
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#define LOG_LINE_MAX 160   // LOGF_* line incl. NUL, longer lines are truncated
+
+// Constant expression - usable for guarding multi-statement debug blocks
+#define LOG_ENABLED(module, level) ((LOG_MODULE_##module) >= (level))
+
+#define LOG_AT(module, level, message)                  \
+  do {                                                  \
+    if constexpr (LOG_ENABLED(module, level)) {         \
+      logWrite((level), #module, (message));            \
+    }                                                   \
+  } while (0)
+
+#define LOGF_AT(module, level, ...)                     \
+  do {                                                  \
+    if constexpr (LOG_ENABLED(module, level)) {         \
+      logWritef((level), #module, __VA_ARGS__);         \
+    }                                                   \
+  } while (0)
+
+#define LOGR_AT(module, level, ...)                     \
+  do {                                                  \
+    if constexpr (LOG_ENABLED(module, level)) {         \
+      if (false) logRingFormatCheck(__VA_ARGS__);       \
+      logRingRecord((level), #module, __VA_ARGS__);     \
+    }                                                   \
+  } while (0)
+
+#define LOG_ERROR(module, message) LOG_AT(module, LOG_LEVEL_ERROR, message)
+#define LOG_WARN(module, message)  LOG_AT(module, LOG_LEVEL_WARN, message)
+#define LOG_INFO(module, message)  LOG_AT(module, LOG_LEVEL_INFO, message)
+#define LOG_DEBUG(module, message) LOG_AT(module, LOG_LEVEL_DEBUG, message)
+
+#define LOGF_ERROR(module, ...) LOGF_AT(module, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOGF_WARN(module, ...)  LOGF_AT(module, LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOGF_INFO(module, ...)  LOGF_AT(module, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOGF_DEBUG(module, ...) LOGF_AT(module, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define LOGR_ERROR(module, ...) LOGR_AT(module, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOGR_WARN(module, ...)  LOGR_AT(module, LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOGR_INFO(module, ...)  LOGR_AT(module, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOGR_DEBUG(module, ...) LOGR_AT(module, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+// Sink - only reached by enabled calls
+void logWrite(uint8_t level, const char* module, const char* message);
+void logWritef(uint8_t level, const char* module, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// "ERROR" / "WARN" / "INFO" / "DEBUG"
+inline const char* logLevelName(uint8_t level) {
+  switch (level) {
+    case LOG_LEVEL_ERROR: return "ERROR";
+    case LOG_LEVEL_WARN:  return "WARN";
+    case LOG_LEVEL_INFO:  return "INFO";
+    case LOG_LEVEL_DEBUG: return "DEBUG";
+  }
+  return "?";
+}
+
+#ifdef ARDUINO
+#include <WString.h>
+inline void logWrite(uint8_t level, const char* module, const String& message) {
+  logWrite(level, module, message.c_str());
+}
+#endif
+
+#endif
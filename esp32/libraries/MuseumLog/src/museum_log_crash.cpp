@@ -0,0 +1,328 @@
+#include "museum_log_crash.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_app_desc.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <sdkconfig.h>
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH && CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF
+#include <esp_core_dump.h>
+#define CRASH_HAVE_COREDUMP 1
+#endif
+#define CRASH_RTC RTC_NOINIT_ATTR
+#else
+#include <chrono>
+#define CRASH_RTC
+#endif
+
+#define CRASH_MAGIC ((uint32_t)0x48535243)   // "CRSH"
+
+struct CrashCommand {
+  uint32_t timeMs;
+  char text[CRASH_CMD_TEXT];   // NUL-terminated
+};
+
+// RTC slow memory: survives panic, watchdog and software resets, not power-on.
+// Written on every stage change, so it carries no checksum - indices are
+// range-checked instead.
+struct CrashRtcState {
+  uint32_t magic;
+  uint32_t buildId;
+  uint8_t stage;
+  uint8_t cmdHead;              // Next slot
+  uint8_t cmdCount;
+  uint32_t stageMs;
+  CrashCommand commands[CRASH_CMD_COUNT];
+  uint32_t check;               // ~magic
+};
+
+static CRASH_RTC CrashRtcState rtc;
+
+// Previous boot as taken by crashCapture()
+static CrashRtcState previous;
+static bool previousValid = false;
+static CrashCore previousCore = {};
+static CrashReset lastReset = CRASH_RESET_UNKNOWN;
+static CrashCounters counters = {};
+static bool pending = false;
+static bool ready = false;
+
+static const char* const* names = nullptr;
+static uint8_t nameCount = 0;
+
+static const char* const RESET_NAMES[CRASH_RESET_COUNT] = {
+  "unknown", "power_on", "external", "software", "panic",
+  "int_wdt", "task_wdt", "wdt", "deep_sleep", "brownout",
+};
+
+// Reasons worth a record; the rest are expected (power cycle, ESP.restart(), OTA)
+static bool abnormal(CrashReset reason) {
+  switch (reason) {
+    case CRASH_RESET_PANIC:
+    case CRASH_RESET_INT_WDT:
+    case CRASH_RESET_TASK_WDT:
+    case CRASH_RESET_WDT:
+    case CRASH_RESET_BROWNOUT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t currentBuildId() {
+#ifdef ARDUINO
+  uint32_t id;
+  memcpy(&id, esp_app_get_description()->app_elf_sha256, sizeof(id));
+  return id;
+#else
+  return 0;
+#endif
+}
+
+static bool rtcValid(const CrashRtcState& state) {
+  return state.magic == CRASH_MAGIC && state.check == ~CRASH_MAGIC &&
+         state.cmdHead < CRASH_CMD_COUNT && state.cmdCount <= CRASH_CMD_COUNT;
+}
+
+const char* crashResetName(CrashReset reason) {
+  return reason < CRASH_RESET_COUNT ? RESET_NAMES[reason] : RESET_NAMES[CRASH_RESET_UNKNOWN];
+}
+
+void crashCapture(const char* const* stageNames, uint8_t stageCount, CrashReset reason,
+                  const CrashCore* core) {
+  names = stageNames;
+  nameCount = stageCount;
+  lastReset = reason < CRASH_RESET_COUNT ? reason : CRASH_RESET_UNKNOWN;
+
+  previousValid = rtcValid(rtc);
+  if (previousValid) memcpy(&previous, &rtc, sizeof(previous));
+  if (core != nullptr && core->present) {
+    previousCore = *core;
+    if (previousCore.depth > CRASH_BT_MAX) previousCore.depth = CRASH_BT_MAX;
+    previousCore.task[sizeof(previousCore.task) - 1] = '\0';
+  } else {
+    previousCore = {};
+  }
+
+  counters.boots++;
+  counters.resets[lastReset]++;
+  pending = abnormal(lastReset);
+
+  memset(&rtc, 0, sizeof(rtc));
+  rtc.magic = CRASH_MAGIC;
+  rtc.buildId = currentBuildId();
+  rtc.stage = CRASH_STAGE_NONE;
+  rtc.check = ~CRASH_MAGIC;
+  ready = true;
+}
+
+void crashMarkStage(uint8_t stage) {
+  if (!ready) return;
+  rtc.stageMs = nowMs();
+  rtc.stage = stage;
+}
+
+void crashNoteCommand(const char* device, const char* payload, size_t length) {
+  if (!ready) return;
+
+  CrashCommand& command = rtc.commands[rtc.cmdHead];
+  command.timeMs = nowMs();
+
+  // "<device> <payload>", cut to the slot - escaped when formatted
+  size_t used = 0;
+  for (const char* p = device; p != nullptr && *p != '\0' && used < CRASH_CMD_TEXT - 1; p++) {
+    command.text[used++] = *p;
+  }
+  if (used < CRASH_CMD_TEXT - 1) command.text[used++] = ' ';
+  for (size_t i = 0; i < length && used < CRASH_CMD_TEXT - 1; i++) {
+    command.text[used++] = payload[i];
+  }
+  command.text[used] = '\0';
+
+  rtc.cmdHead = (rtc.cmdHead + 1) % CRASH_CMD_COUNT;
+  if (rtc.cmdCount < CRASH_CMD_COUNT) rtc.cmdCount++;
+}
+
+bool crashPending() {
+  return pending;
+}
+
+void crashAcknowledge() {
+  pending = false;
+}
+
+CrashReset crashLastReset() {
+  return lastReset;
+}
+
+const CrashCounters& crashCounters() {
+  return counters;
+}
+
+// Appends to out at *used; false once the buffer is full (the record is then dropped)
+static bool append(char* out, size_t size, size_t* used, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static bool append(char* out, size_t size, size_t* used, const char* format, ...) {
+  if (*used >= size) return false;
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(out + *used, size - *used, format, args);
+  va_end(args);
+  if (written < 0 || *used + written >= size) {
+    *used = size;
+    return false;
+  }
+  *used += written;
+  return true;
+}
+
+size_t crashFormat(char* out, size_t size) {
+  if (size > 0) out[0] = '\0';
+  if (!pending || size == 0) return 0;
+
+  size_t used = 0;
+  uint32_t build = previousValid ? previous.buildId : 0;
+  const uint8_t* b = (const uint8_t*)&build;
+  append(out, size, &used, "{\"boot\":%lu,\"reason\":\"%s\",\"build\":\"%02x%02x%02x%02x\",",
+         (unsigned long)counters.boots, crashResetName(lastReset), b[0], b[1], b[2], b[3]);
+
+  // Stage names belong to this firmware - after an OTA only the index is certain
+  if (!previousValid || previous.stage == CRASH_STAGE_NONE) {
+    append(out, size, &used, "\"stage\":null,");
+  } else if (previous.buildId == currentBuildId() && previous.stage < nameCount) {
+    append(out, size, &used, "\"stage\":\"%s\",", names[previous.stage]);
+  } else {
+    append(out, size, &used, "\"stage\":%u,", (unsigned)previous.stage);
+  }
+  if (previousValid) {
+    append(out, size, &used, "\"stage_at_ms\":%lu,", (unsigned long)previous.stageMs);
+  }
+
+  append(out, size, &used, "\"resets\":{");
+  bool first = true;
+  for (uint8_t reason = 0; reason < CRASH_RESET_COUNT; reason++) {
+    if (!abnormal((CrashReset)reason)) continue;
+    append(out, size, &used, "%s\"%s\":%lu", first ? "" : ",", RESET_NAMES[reason],
+           (unsigned long)counters.resets[reason]);
+    first = false;
+  }
+  append(out, size, &used, "},\"cmds\":[");
+
+  // Oldest first
+  uint8_t count = previousValid ? previous.cmdCount : 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const CrashCommand& command =
+        previous.commands[(previous.cmdHead + CRASH_CMD_COUNT - count + i) % CRASH_CMD_COUNT];
+    // Raw command bytes, possibly cut short by the reset - quotes and control bytes would break the JSON
+    char text[CRASH_CMD_TEXT];
+    memcpy(text, command.text, sizeof(text));
+    text[sizeof(text) - 1] = '\0';
+    for (char* c = text; *c != '\0'; c++) {
+      if (*c < 0x20 || *c > 0x7E || *c == '"' || *c == '\\') *c = '?';
+    }
+    append(out, size, &used, "%s[%lu,\"%s\"]", i > 0 ? "," : "", (unsigned long)command.timeMs, text);
+  }
+  append(out, size, &used, "]");
+
+  if (previousCore.present) {
+    append(out, size, &used, ",\"core\":{\"task\":\"%s\",\"pc\":\"0x%08lx\",\"bt\":[",
+           previousCore.task, (unsigned long)previousCore.pc);
+    for (uint8_t i = 0; i < previousCore.depth; i++) {
+      append(out, size, &used, "%s\"0x%08lx\"", i > 0 ? "," : "",
+             (unsigned long)previousCore.backtrace[i]);
+    }
+    append(out, size, &used, "],\"corrupted\":%s}", previousCore.corrupted ? "true" : "false");
+  }
+
+  if (!append(out, size, &used, "}")) {
+    out[0] = '\0';
+    return 0;
+  }
+  return used;
+}
+
+#ifdef ARDUINO
+
+static CrashReset mapResetReason(esp_reset_reason_t reason) {
+  switch (reason) {
+    case ESP_RST_POWERON:   return CRASH_RESET_POWER_ON;
+    case ESP_RST_EXT:       return CRASH_RESET_EXTERNAL;
+    case ESP_RST_SW:        return CRASH_RESET_SOFTWARE;
+    case ESP_RST_PANIC:     return CRASH_RESET_PANIC;
+    case ESP_RST_INT_WDT:   return CRASH_RESET_INT_WDT;
+    case ESP_RST_TASK_WDT:  return CRASH_RESET_TASK_WDT;
+    case ESP_RST_WDT:       return CRASH_RESET_WDT;
+    case ESP_RST_DEEPSLEEP: return CRASH_RESET_DEEP_SLEEP;
+    case ESP_RST_BROWNOUT:  return CRASH_RESET_BROWNOUT;
+    default:                return CRASH_RESET_UNKNOWN;
+  }
+}
+
+// Summary of the coredump in flash. Only read after a panic / watchdog reset,
+// which always writes a new image - an older one is left for espcoredump.py.
+static bool readCoredump(CrashCore* core) {
+#ifdef CRASH_HAVE_COREDUMP
+  if (esp_core_dump_image_check() != ESP_OK) return false;
+
+  static esp_core_dump_summary_t summary;   // ~200 B, kept off the setup() stack
+  if (esp_core_dump_get_summary(&summary) != ESP_OK) return false;
+
+  core->present = true;
+  strncpy(core->task, summary.exc_task, sizeof(core->task) - 1);
+  core->task[sizeof(core->task) - 1] = '\0';
+  core->pc = summary.exc_pc;
+#if CONFIG_IDF_TARGET_ARCH_XTENSA
+  core->depth = summary.exc_bt_info.depth < CRASH_BT_MAX ? summary.exc_bt_info.depth : CRASH_BT_MAX;
+  core->corrupted = summary.exc_bt_info.corrupted;
+  for (uint8_t i = 0; i < core->depth; i++) core->backtrace[i] = summary.exc_bt_info.bt[i];
+#else
+  // RISC-V keeps a raw stack dump instead of a walked backtrace
+  core->depth = 0;
+  core->corrupted = false;
+#endif
+  return true;
+#else
+  (void)core;
+  return false;
+#endif
+}
+
+void crashBegin(const char* const* stageNames, uint8_t stageCount) {
+  CrashReset reason = mapResetReason(esp_reset_reason());
+
+  CrashCore core = {};
+  bool withCore = reason == CRASH_RESET_PANIC || reason == CRASH_RESET_INT_WDT ||
+                  reason == CRASH_RESET_TASK_WDT || reason == CRASH_RESET_WDT;
+  if (withCore) readCoredump(&core);
+
+  // Counters survive power-on too - NVS, one small write per boot
+  Preferences prefs;
+  if (prefs.begin("crash", false)) {
+    if (prefs.getBytesLength("counters") == sizeof(counters)) {
+      prefs.getBytes("counters", &counters, sizeof(counters));
+    }
+    crashCapture(stageNames, stageCount, reason, &core);
+    prefs.putBytes("counters", &counters, sizeof(counters));
+    prefs.end();
+  } else {
+    crashCapture(stageNames, stageCount, reason, &core);
+  }
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef MUSEUM_LOG_CRASH_H
+#define MUSEUM_LOG_CRASH_H
+
+// Crash and reset forensics. While the firmware runs, the last loop stage
+// (with its start time) and the last few commands are kept in RTC memory,
+// which survives panic, watchdog and software resets. On the next boot
+// crashBegin() reads the reset reason, takes that RTC state and - with an
+// ESP-IDF coredump in flash - the crashed task, PC and backtrace, and counts
+// the boot in NVS. After an abnormal reset (panic, watchdog, brownout) the
+// firmware publishes crashFormat() once over MQTT; extras/host/crash_decode.py
+// turns the addresses back into function names with the firmware ELF.
+//
+// The full coredump stays in the flash partition for espcoredump.py.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRASH_CMD_COUNT    8    // Recent commands kept in RTC memory
+#define CRASH_CMD_TEXT     24   // "<device> <payload>" summary, truncated
+#define CRASH_BT_MAX       8    // Backtrace frames in the record
+#define CRASH_STAGE_NONE   0xFF // Outside any named loop stage
+#define CRASH_PAYLOAD_MAX  768
+
+enum CrashReset : uint8_t {
+  CRASH_RESET_UNKNOWN,
+  CRASH_RESET_POWER_ON,
+  CRASH_RESET_EXTERNAL,
+  CRASH_RESET_SOFTWARE,
+  CRASH_RESET_PANIC,
+  CRASH_RESET_INT_WDT,
+  CRASH_RESET_TASK_WDT,
+  CRASH_RESET_WDT,        // Other watchdogs (RTC / MWDT)
+  CRASH_RESET_DEEP_SLEEP,
+  CRASH_RESET_BROWNOUT,
+  CRASH_RESET_COUNT
+};
+
+// Persistent counters (NVS on the device)
+struct CrashCounters {
+  uint32_t boots;
+  uint32_t resets[CRASH_RESET_COUNT];
+};
+
+// Coredump summary of the crashed task
+struct CrashCore {
+  bool present;
+  char task[16];
+  uint32_t pc;
+  uint8_t depth;
+  bool corrupted;           // Backtrace could not be walked to the end
+  uint32_t backtrace[CRASH_BT_MAX];
+};
+
+// Call once at the very start of setup() (after logRingBegin()). stageNames
+// name the indices given to crashMarkStage(); they must outlive the program.
+void crashBegin(const char* const* stageNames, uint8_t stageCount);
+
+// Loop stage about to run (CRASH_STAGE_NONE between stages) - two RTC writes
+void crashMarkStage(uint8_t stage);
+
+// Command received: device part of the topic and the raw payload (no NUL needed)
+void crashNoteCommand(const char* device, const char* payload, size_t length);
+
+// A record of the previous boot waits to be published
+bool crashPending();
+
+// {"boot":N,"reason":"task_wdt","build":"1a2b3c4d","stage":"mqtt","stage_at_ms":N,
+//  "resets":{"panic":N,...},"cmds":[[ms,"light/4 ON"],...],
+//  "core":{"task":"loopTask","pc":"0x400d2f1c","bt":["0x...",...],"corrupted":false}}
+// "core" only with a coredump, "stage" null outside a stage. Returns the length, 0 if nothing pending.
+size_t crashFormat(char* out, size_t size);
+
+// Published - not reported again
+void crashAcknowledge();
+
+CrashReset crashLastReset();
+const CrashCounters& crashCounters();
+const char* crashResetName(CrashReset reason);
+
+// Engine behind crashBegin(): takes the RTC state of the previous boot, counts
+// this boot and starts a fresh RTC state. Called directly by the host tests.
+void crashCapture(const char* const* stageNames, uint8_t stageCount, CrashReset reason,
+                  const CrashCore* core);
+
+#endif
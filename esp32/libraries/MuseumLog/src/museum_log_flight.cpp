@@ -0,0 +1,223 @@
+#include "museum_log_flight.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_app_desc.h>
+#include <esp_attr.h>
+#define FLIGHT_RTC RTC_NOINIT_ATTR
+#else
+#include <chrono>
+#define FLIGHT_RTC
+#endif
+
+#define FLIGHT_MAGIC ((uint32_t)0x54484c46)   // "FLHT"
+
+struct FlightRecord {
+  uint32_t timeMs;
+  uint16_t applyUs;
+  uint8_t topic;
+  uint8_t result;
+  uint8_t boot;
+  uint8_t length;
+  char text[FLIGHT_TEXT];      // Not NUL-terminated
+};
+
+// RTC slow memory, like the crash state: the ring itself is the mirror that
+// survives the reset. Indices are range-checked on every boot.
+struct FlightRtcState {
+  uint32_t magic;
+  uint32_t buildId;
+  uint32_t boot;               // Boots since the ring was cleared
+  uint8_t head;                // Next slot
+  uint8_t count;
+  FlightRecord records[FLIGHT_RECORD_COUNT];
+  uint32_t check;              // ~magic
+};
+
+static FLIGHT_RTC FlightRtcState rtc;
+
+static FlightTopicName topicNames = nullptr;
+static uint8_t topicTotal = 0;
+static bool ready = false;
+
+// Record opened by flightReceive(), RAM only - after a reset it stays FLIGHT_PENDING
+static FlightRecord* openRecord = nullptr;
+static uint32_t openUs = 0;
+
+static uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t nowUs() {
+#ifdef ARDUINO
+  return micros();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t currentBuildId() {
+#ifdef ARDUINO
+  uint32_t id;
+  memcpy(&id, esp_app_get_description()->app_elf_sha256, sizeof(id));
+  return id;
+#else
+  return 0;
+#endif
+}
+
+static bool rtcValid() {
+  return rtc.magic == FLIGHT_MAGIC && rtc.check == ~FLIGHT_MAGIC &&
+         rtc.head < FLIGHT_RECORD_COUNT && rtc.count <= FLIGHT_RECORD_COUNT;
+}
+
+void flightBegin(FlightTopicName topicName, uint8_t topicCount) {
+  topicNames = topicName;
+  topicTotal = topicCount;
+  openRecord = nullptr;
+
+  // Topic indices belong to the build - after an OTA the old records would lie
+  if (rtcValid() && rtc.buildId == currentBuildId()) {
+    rtc.boot++;
+  } else {
+    memset(&rtc, 0, sizeof(rtc));
+    rtc.magic = FLIGHT_MAGIC;
+    rtc.buildId = currentBuildId();
+    rtc.boot = 1;
+    rtc.check = ~FLIGHT_MAGIC;
+  }
+  ready = true;
+}
+
+void flightReceive(uint8_t topic, const char* payload, size_t length) {
+  if (!ready) return;
+
+  FlightRecord& record = rtc.records[rtc.head];
+  record.timeMs = nowMs();
+  record.applyUs = 0;
+  record.topic = topic;
+  record.result = FLIGHT_PENDING;
+  record.boot = (uint8_t)rtc.boot;
+  record.length = length < 0xFF ? (uint8_t)length : 0xFF;
+  memset(record.text, 0, sizeof(record.text));
+  memcpy(record.text, payload, length < FLIGHT_TEXT ? length : FLIGHT_TEXT);
+
+  rtc.head = (rtc.head + 1) % FLIGHT_RECORD_COUNT;
+  if (rtc.count < FLIGHT_RECORD_COUNT) rtc.count++;
+
+  openRecord = &record;
+  openUs = nowUs();
+}
+
+void flightComplete(uint8_t result) {
+  if (openRecord == nullptr) return;
+  uint32_t elapsed = nowUs() - openUs;
+  openRecord->applyUs = elapsed < 0xFFFF ? (uint16_t)elapsed : 0xFFFF;
+  openRecord->result = result;
+  openRecord = nullptr;
+}
+
+uint8_t flightCount() {
+  return ready ? rtc.count : 0;
+}
+
+// Appends to out at *used; false once the buffer is full (the dump is then dropped)
+static bool append(char* out, size_t size, size_t* used, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static bool append(char* out, size_t size, size_t* used, const char* format, ...) {
+  if (*used >= size) return false;
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(out + *used, size - *used, format, args);
+  va_end(args);
+  if (written < 0 || *used + written >= size) {
+    *used = size;
+    return false;
+  }
+  *used += written;
+  return true;
+}
+
+static void pack(const FlightRecord& record, uint8_t* out) {
+  out[0] = record.timeMs;
+  out[1] = record.timeMs >> 8;
+  out[2] = record.timeMs >> 16;
+  out[3] = record.timeMs >> 24;
+  out[4] = record.applyUs;
+  out[5] = record.applyUs >> 8;
+  out[6] = record.topic;
+  out[7] = record.result;
+  out[8] = record.boot;
+  out[9] = record.length;
+  memcpy(out + 10, record.text, FLIGHT_TEXT);
+}
+
+static const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Padding only after the last chunk - every earlier one is a multiple of 3 bytes
+static bool appendBase64(char* out, size_t size, size_t* used, const uint8_t* data, size_t length) {
+  if (*used + (length + 2) / 3 * 4 >= size) {
+    *used = size;
+    return false;
+  }
+  char* p = out + *used;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t group = (uint32_t)data[i] << 16;
+    if (i + 1 < length) group |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < length) group |= data[i + 2];
+    *p++ = BASE64[(group >> 18) & 0x3F];
+    *p++ = BASE64[(group >> 12) & 0x3F];
+    *p++ = i + 1 < length ? BASE64[(group >> 6) & 0x3F] : '=';
+    *p++ = i + 2 < length ? BASE64[group & 0x3F] : '=';
+  }
+  *p = '\0';
+  *used = p - out;
+  return true;
+}
+
+size_t flightFormat(char* out, size_t size) {
+  if (size > 0) out[0] = '\0';
+  if (!ready || size == 0) return 0;
+
+  size_t used = 0;
+  const uint8_t* b = (const uint8_t*)&rtc.buildId;
+  append(out, size, &used, "{\"boot\":%lu,\"now_ms\":%lu,\"build\":\"%02x%02x%02x%02x\",\"topics\":[",
+         (unsigned long)rtc.boot, (unsigned long)nowMs(), b[0], b[1], b[2], b[3]);
+  for (uint8_t i = 0; i < topicTotal && topicNames != nullptr; i++) {
+    const char* name = topicNames(i);
+    if (name == nullptr) break;
+    append(out, size, &used, "%s\"%s\"", i > 0 ? "," : "", name);
+  }
+  append(out, size, &used, "],\"rec\":\"");
+
+  // Oldest first, encoded in chunks of three records (60 B -> 80 characters)
+  uint8_t chunk[FLIGHT_RECORD_SIZE * 3];
+  size_t filled = 0;
+  for (uint8_t i = 0; i < rtc.count; i++) {
+    pack(rtc.records[(rtc.head + FLIGHT_RECORD_COUNT - rtc.count + i) % FLIGHT_RECORD_COUNT],
+         chunk + filled);
+    filled += FLIGHT_RECORD_SIZE;
+    if (filled == sizeof(chunk)) {
+      appendBase64(out, size, &used, chunk, filled);
+      filled = 0;
+    }
+  }
+  if (filled > 0) appendBase64(out, size, &used, chunk, filled);
+
+  if (!append(out, size, &used, "\"}")) {
+    out[0] = '\0';
+    return 0;
+  }
+  return used;
+}
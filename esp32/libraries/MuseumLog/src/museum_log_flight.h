@@ -0,0 +1,54 @@
+#ifndef MUSEUM_LOG_FLIGHT_H
+#define MUSEUM_LOG_FLIGHT_H
+
+// Command flight recorder. Every command the firmware dispatches gets one
+// fixed-size record: receive time, topic index, start of the payload, result
+// and how long the apply took. The ring of the last FLIGHT_RECORD_COUNT
+// records lives in RTC no-init memory, so it survives panic, watchdog and
+// software resets (not power-on) and keeps records of the previous boots.
+// flightFormat() packs the ring for MQTT (devices/<id>/flight on flight/get);
+// extras/host/flight_decode.py expands it and puts wall-clock times on the
+// records of the current boot, for lining them up with the backend logs.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLIGHT_RECORD_COUNT 24
+#define FLIGHT_TEXT         10     // Payload bytes kept per record
+#define FLIGHT_RECORD_SIZE  20     // Packed record in the dump
+#define FLIGHT_TOPIC_NONE   0xFF   // Topic not in the firmware's table
+#define FLIGHT_PAYLOAD_MAX  1024   // Dump incl. the topic table (MQTT buffer must be larger)
+
+// Result of a command. 1..0x7F are the firmware's parse error codes
+// (CmdError of MuseumCommand, "ERROR:<code>" feedback).
+enum FlightResult : uint8_t {
+  FLIGHT_OK       = 0,
+  FLIGHT_IGNORED  = 0xFC,   // Not for this device, no feedback
+  FLIGHT_REFUSED  = 0xFD,   // Valid payload, refused ("ERROR" feedback)
+  FLIGHT_PENDING  = 0xFE    // Received, never completed - reset during the apply
+};
+
+// Name of a topic index, nullptr past the end of the table
+typedef const char* (*FlightTopicName)(uint8_t topic);
+
+// Call once in setup() (after crashBegin()). Keeps the ring of the previous
+// boots unless the reset lost the RTC memory.
+void flightBegin(FlightTopicName topicName, uint8_t topicCount);
+
+// Command received (before parsing) - opens the record, stamps the time
+void flightReceive(uint8_t topic, const char* payload, size_t length);
+
+// Command applied - result and latency since flightReceive() into its record
+void flightComplete(uint8_t result);
+
+// Records in the ring, all boots
+uint8_t flightCount();
+
+// {"boot":N,"now_ms":N,"build":"1a2b3c4d","topics":["light/1",...],"rec":"<base64>"}
+// rec = packed records, oldest first, FLIGHT_RECORD_SIZE bytes each (little endian):
+//   u32 receive ms, u16 apply us (0xFFFF = longer), u8 topic, u8 result,
+//   u8 boot (low byte of "boot"), u8 payload length (255 = longer), char text[FLIGHT_TEXT]
+// Returns the length, 0 if it does not fit.
+size_t flightFormat(char* out, size_t size);
+
+#endif
@@ -0,0 +1,283 @@
+#include "museum_log_ring.h"
+#include "museum_log.h"
+#include "museum_log_stream.h"
+
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_app_desc.h>
+#include <esp_attr.h>
+#include <esp_memory_utils.h>
+#define LOG_RING_NOINIT __NOINIT_ATTR
+#else
+#include <chrono>
+#define LOG_RING_NOINIT
+#endif
+
+#define LOG_RING_MAGIC ((uint32_t)0x474E524C)   // "LRNG"
+#define LOG_RING_MASK  (LOG_RING_SIZE - 1)
+#define LOG_RING_DRAIN_ROOM 96        // Free TX bytes needed before logRingDrain() prints a line
+
+static_assert((LOG_RING_SIZE & LOG_RING_MASK) == 0, "LOG_RING_SIZE must be a power of two");
+
+struct LogRingState {
+  uint32_t magic;
+  uint32_t buildId;     // Pointers in the records are only valid for this firmware
+  uint32_t head;        // Next record number (records reserved so far)
+  uint32_t bootHead;    // head at logRingBegin() - older records are from previous boots
+  LogRecord records[LOG_RING_SIZE];
+  uint32_t check;       // ~magic, set last when the ring is cleared
+};
+
+// .noinit: not zeroed by the startup code, survives everything but power-on / deep sleep
+static LOG_RING_NOINIT LogRingState ring;
+
+static bool ringReady = false;   // .bss - writes before logRingBegin() are dropped
+static uint32_t readSeq = 0;     // Drain position (record number)
+
+static uint32_t currentBuildId() {
+#ifdef ARDUINO
+  uint32_t id;
+  memcpy(&id, esp_app_get_description()->app_elf_sha256, sizeof(id));
+  return id;
+#else
+  return 0;
+#endif
+}
+
+static uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Module / format / %s addresses - on the ESP32 only flash string literals are followed
+static const char* ringString(uint32_t address) {
+  const char* text = (const char*)(uintptr_t)address;
+#ifdef ARDUINO
+  if (!esp_ptr_in_drom(text)) return "?";
+#endif
+  return text != nullptr ? text : "?";
+}
+
+#ifdef ARDUINO
+static void dumpRecords(Print& out);
+#endif
+
+void logRingBegin() {
+  uint32_t buildId = currentBuildId();
+  bool valid = ring.magic == LOG_RING_MAGIC && ring.check == ~LOG_RING_MAGIC;
+
+  if (!valid || ring.buildId != buildId) {
+#ifdef ARDUINO
+    // Different firmware (OTA) - only its ELF can decode the old records
+    if (valid) dumpRecords(Serial);
+#endif
+    memset(&ring, 0, sizeof(ring));
+    ring.magic = LOG_RING_MAGIC;
+    ring.buildId = buildId;
+    ring.check = ~LOG_RING_MAGIC;
+  }
+
+  ring.bootHead = ring.head;
+  readSeq = ring.head > LOG_RING_SIZE ? ring.head - LOG_RING_SIZE : 0;
+  ringReady = true;
+}
+
+void logRingWrite(uint8_t level, const char* module, const char* format,
+                  uint8_t argc, const uint32_t* args) {
+  if (!ringReady) return;
+
+  uint32_t number = __atomic_fetch_add(&ring.head, 1, __ATOMIC_RELAXED);
+  LogRecord& record = ring.records[number & LOG_RING_MASK];
+
+  // Seqlock: 0 = being written, the reader waits or skips the slot
+  __atomic_store_n(&record.seq, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  record.timeMs = nowMs();
+  record.module = (uint32_t)(uintptr_t)module;
+  record.format = (uint32_t)(uintptr_t)format;
+  record.level = level;
+  record.argc = argc;
+  record.reserved = 0;
+  memcpy(record.args, args, sizeof(record.args));
+
+  __atomic_store_n(&record.seq, number + 1, __ATOMIC_RELEASE);
+}
+
+bool logRingNext(LogRecord* out, uint32_t* lost) {
+  *lost = 0;
+  if (!ringReady) return false;
+
+  uint32_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+  if (head - readSeq > LOG_RING_SIZE) {
+    *lost += head - LOG_RING_SIZE - readSeq;
+    readSeq = head - LOG_RING_SIZE;
+  }
+
+  while (readSeq != head) {
+    const LogRecord& slot = ring.records[readSeq & LOG_RING_MASK];
+    uint32_t expected = readSeq + 1;
+
+    uint32_t before = __atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE);
+    memcpy(out, &slot, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint32_t after = __atomic_load_n(&slot.seq, __ATOMIC_RELAXED);
+
+    if (before == expected && after == expected) {
+      readSeq++;
+      return true;
+    }
+
+    bool overwritten = (int32_t)(before - expected) > 0;
+    bool previousBoot = (int32_t)(readSeq - ring.bootHead) < 0;
+    if (!overwritten && !previousBoot) return false;   // Writer still busy
+
+    // Overwritten by a newer record, or the write was cut short by a reset
+    readSeq++;
+    (*lost)++;
+  }
+  return false;
+}
+
+bool logRingFromPreviousBoot(const LogRecord& record) {
+  return (int32_t)(record.seq - 1 - ring.bootHead) < 0;
+}
+
+// printf over the stored 32-bit args: the conversion picks the type, length modifiers are ignored
+static size_t formatArgs(char* out, size_t size, const char* format,
+                         const uint32_t* args, uint8_t argc) {
+  size_t used = 0;
+  uint8_t next = 0;
+  const char* p = format;
+
+  while (*p != '\0' && used + 1 < size) {
+    if (*p != '%') {
+      out[used++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      out[used++] = '%';
+      p += 2;
+      continue;
+    }
+
+    char spec[16];
+    size_t length = 0;
+    spec[length++] = *p++;
+    while (*p != '\0' && strchr("-+ #0123456789.", *p) != nullptr && length < sizeof(spec) - 2) {
+      spec[length++] = *p++;
+    }
+    while (*p == 'l' || *p == 'h' || *p == 'z' || *p == 'j' || *p == 't') p++;
+    if (*p == '\0') break;
+    char conversion = *p++;
+    spec[length++] = conversion;
+    spec[length] = '\0';
+
+    uint32_t arg = next < argc ? args[next++] : 0;
+    char* dest = out + used;
+    size_t room = size - used;
+    int written;
+    switch (conversion) {
+      case 'd': case 'i':
+        written = snprintf(dest, room, spec, (int)(int32_t)arg);
+        break;
+      case 'u': case 'x': case 'X': case 'o': case 'c':
+        written = snprintf(dest, room, spec, (unsigned)arg);
+        break;
+      case 's':
+        written = snprintf(dest, room, spec, ringString(arg));
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+        float value;
+        memcpy(&value, &arg, sizeof(value));
+        written = snprintf(dest, room, spec, (double)value);
+        break;
+      }
+      default:
+        written = snprintf(dest, room, "0x%08x", (unsigned)arg);
+        break;
+    }
+    if (written < 0) break;
+    used += (size_t)written < room ? (size_t)written : room - 1;
+  }
+
+  if (size > 0) out[used] = '\0';
+  return used;
+}
+
+size_t logRingFormat(const LogRecord& record, char* buffer, size_t size) {
+  int prefix = snprintf(buffer, size, "[%s] %lums %s - ", logLevelName(record.level),
+                        (unsigned long)record.timeMs, ringString(record.module));
+  if (prefix < 0 || (size_t)prefix >= size) return size > 0 ? size - 1 : 0;
+
+  uint8_t argc = record.argc <= LOG_RING_MAX_ARGS ? record.argc : LOG_RING_MAX_ARGS;
+  return prefix + formatArgs(buffer + prefix, size - prefix, ringString(record.format),
+                             record.args, argc);
+}
+
+#ifdef ARDUINO
+
+void logRingDrain(Print& out, uint8_t maxLines) {
+  static bool printedPrevious = false;
+  static bool printedCurrent = false;
+
+  LogRecord record;
+  uint32_t lost;
+  char line[LOG_LINE_MAX];
+
+  while (maxLines-- > 0 && out.availableForWrite() >= LOG_RING_DRAIN_ROOM) {
+    bool found = logRingNext(&record, &lost);
+    if (lost > 0) {
+      out.printf("--- %lu log records lost ---\n", (unsigned long)lost);
+    }
+    if (!found) return;
+
+    bool previous = logRingFromPreviousBoot(record);
+    if (previous && !printedPrevious) {
+      out.println("--- previous boot ---");
+      printedPrevious = true;
+    } else if (!previous && printedPrevious && !printedCurrent) {
+      out.println("--- current boot ---");
+      printedCurrent = true;
+    }
+
+    logRingFormat(record, line, sizeof(line));
+    out.println(line);
+    logStreamWriteLine(record.level, line);
+  }
+}
+
+// "#LOGRING build=<elf sha256[0:4]> head=<n> boot=<n>", "#LR <32 B hex>" per record, "#END"
+static void dumpRecords(Print& out) {
+  const uint8_t* build = (const uint8_t*)&ring.buildId;
+  out.printf("#LOGRING build=%02x%02x%02x%02x head=%lu boot=%lu\n", build[0], build[1], build[2],
+             build[3], (unsigned long)ring.head, (unsigned long)ring.bootHead);
+
+  char hex[2 * sizeof(LogRecord) + 1];
+  uint32_t first = ring.head > LOG_RING_SIZE ? ring.head - LOG_RING_SIZE : 0;
+  for (uint32_t number = first; number != ring.head; number++) {
+    LogRecord record;
+    memcpy(&record, &ring.records[number & LOG_RING_MASK], sizeof(record));
+    if (record.seq != number + 1) continue;
+
+    const uint8_t* bytes = (const uint8_t*)&record;
+    for (size_t i = 0; i < sizeof(record); i++) {
+      snprintf(hex + 2 * i, 3, "%02x", bytes[i]);
+    }
+    out.print("#LR ");
+    out.println(hex);
+  }
+  out.println("#END");
+}
+
+void logRingDump(Print& out) {
+  if (ringReady) dumpRecords(out);
+}
+
+#endif
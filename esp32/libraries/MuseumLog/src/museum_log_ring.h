@@ -0,0 +1,97 @@
+#ifndef MUSEUM_LOG_RING_H
+#define MUSEUM_LOG_RING_H
+
+// Deferred binary log: LOGR_* store a 32-byte record (time, level, module and
+// format *addresses*, up to 3 raw 32-bit args) into a ring in no-init RAM and
+// return - nothing is formatted or printed on the calling path. The text is
+// produced later by logRingDrain() (loop, only when the UART has room) or
+// off-device by extras/host/log_decode.py, which looks the strings up in the
+// firmware ELF.
+//
+// The ring survives software, watchdog and panic resets (not power-on / deep
+// sleep), so the lines before a WDT reset are printed after the next boot.
+//
+// Only string literals may be passed for %s: the record keeps the pointer, not
+// the text. Integer, char, bool, enum and float args are stored by value.
+//
+// Writers are lock-free (atomic slot reservation + per-slot commit sequence)
+// and may run on both cores; the drain is single-consumer.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#define LOG_RING_SIZE     64   // Records, power of two (64 * 32 B = 2 kB)
+#define LOG_RING_MAX_ARGS 3
+
+struct LogRecord {
+  uint32_t seq;        // Record number + 1 once committed, 0 while being written
+  uint32_t timeMs;
+  uint32_t module;     // const char* (string literal)
+  uint32_t format;     // const char* (string literal)
+  uint32_t args[LOG_RING_MAX_ARGS];
+  uint8_t level;
+  uint8_t argc;
+  uint16_t reserved;
+};
+
+static_assert(sizeof(LogRecord) == 32, "LogRecord layout is shared with log_decode.py");
+
+// Call once in setup() - keeps the previous boot's records if the firmware is
+// the same build, otherwise clears the ring
+void logRingBegin();
+
+void logRingWrite(uint8_t level, const char* module, const char* format,
+                  uint8_t argc, const uint32_t* args);
+
+// Single consumer: next committed record not yet read. *lost counts records
+// overwritten before they were read. false = nothing new.
+bool logRingNext(LogRecord* out, uint32_t* lost);
+
+// true if the record was written before the current boot
+bool logRingFromPreviousBoot(const LogRecord& record);
+
+// "[INFO] 1234ms HW - Relay1 -> ON" (same shape as logWrite), returns length
+size_t logRingFormat(const LogRecord& record, char* buffer, size_t size);
+
+#ifdef ARDUINO
+#include <Print.h>
+
+// Formats at most maxLines pending records; stops early when the stream has
+// less than a line of free TX buffer, so a call never waits on the UART
+void logRingDrain(Print& out, uint8_t maxLines = 2);
+
+// Raw records as hex lines for log_decode.py (does not advance the drain)
+void logRingDump(Print& out);
+#endif
+
+// --- LOGR_* argument packing ---------------------------------------------
+
+inline uint32_t logRingArg(const char* value) { return (uint32_t)(uintptr_t)value; }
+inline uint32_t logRingArg(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+inline uint32_t logRingArg(double value) { return logRingArg((float)value); }
+
+template <typename T>
+inline uint32_t logRingArg(T value) {
+  static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                "LOGR_*: only integers, enums, floats and string literals");
+  return (uint32_t)value;
+}
+
+// Never called - lets the compiler check the format against the arguments
+inline void logRingFormatCheck(const char*, ...) __attribute__((format(printf, 1, 2)));
+inline void logRingFormatCheck(const char*, ...) {}
+
+template <typename... Args>
+inline void logRingRecord(uint8_t level, const char* module, const char* format, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_RING_MAX_ARGS, "LOGR_*: at most 3 arguments");
+  const uint32_t packed[LOG_RING_MAX_ARGS + 1] = {logRingArg(args)..., 0};
+  logRingWrite(level, module, format, (uint8_t)sizeof...(Args), packed);
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include "museum_log_stream.h"
+#include "museum_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+static portMUX_TYPE streamLock = portMUX_INITIALIZER_UNLOCKED;
+#define STREAM_LOCK()   portENTER_CRITICAL(&streamLock)
+#define STREAM_UNLOCK() portEXIT_CRITICAL(&streamLock)
+#else
+#include <chrono>
+#include <mutex>
+static std::mutex streamLock;
+#define STREAM_LOCK()   streamLock.lock()
+#define STREAM_UNLOCK() streamLock.unlock()
+#endif
+
+#define LOG_STREAM_MASK (LOG_STREAM_SLOTS - 1)
+
+static_assert((LOG_STREAM_SLOTS & LOG_STREAM_MASK) == 0, "LOG_STREAM_SLOTS must be a power of two");
+
+struct TokenBucket {
+  uint16_t perSecond;
+  uint16_t burst;
+  uint32_t milliTokens;   // 1000 = one line
+  uint32_t lastMs;
+};
+
+static char slots[LOG_STREAM_SLOTS][LOG_STREAM_LINE];
+static uint32_t head = 0;              // Next line number
+static uint32_t tail = 0;              // Oldest buffered line number
+static uint32_t rateLimited = 0;
+static uint32_t overwritten = 0;
+static uint32_t sent = 0;
+static uint8_t streamLevel = LOG_LEVEL_NONE;
+
+// Index = level; ERROR gets the most room, DEBUG is meant for short sessions
+static TokenBucket buckets[LOG_LEVEL_DEBUG + 1] = {
+  {0, 0, 0, 0},
+  {5, 10, 10000, 0},   // ERROR
+  {2, 5, 5000, 0},     // WARN
+  {1, 5, 5000, 0},     // INFO
+  {1, 5, 5000, 0},     // DEBUG
+};
+
+// Counters reported by the batch in flight - subtracted on commit
+static uint32_t reportedRate = 0;
+static uint32_t reportedOverwritten = 0;
+
+static uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void logStreamSetLevel(uint8_t level) {
+  if (level > LOG_LEVEL_DEBUG) level = LOG_LEVEL_DEBUG;
+
+  STREAM_LOCK();
+  if (level == LOG_LEVEL_NONE) {
+    // Off - nothing buffered is worth sending later
+    tail = head;
+    rateLimited = overwritten = 0;
+    reportedRate = reportedOverwritten = 0;
+  }
+  __atomic_store_n(&streamLevel, level, __ATOMIC_RELAXED);
+  STREAM_UNLOCK();
+}
+
+uint8_t logStreamLevel() {
+  return __atomic_load_n(&streamLevel, __ATOMIC_RELAXED);
+}
+
+void logStreamSetRate(uint8_t level, uint16_t perSecond, uint16_t burst) {
+  if (level < LOG_LEVEL_ERROR || level > LOG_LEVEL_DEBUG) return;
+
+  STREAM_LOCK();
+  TokenBucket& bucket = buckets[level];
+  bucket.perSecond = perSecond;
+  bucket.burst = burst;
+  bucket.milliTokens = (uint32_t)burst * 1000;
+  STREAM_UNLOCK();
+}
+
+// Called with the lock held
+static bool takeToken(TokenBucket& bucket, uint32_t now) {
+  uint32_t capacity = (uint32_t)bucket.burst * 1000;
+  uint64_t refill = (uint64_t)(now - bucket.lastMs) * bucket.perSecond;
+  bucket.lastMs = now;
+
+  uint64_t tokens = bucket.milliTokens + refill;
+  bucket.milliTokens = tokens > capacity ? capacity : (uint32_t)tokens;
+
+  if (bucket.milliTokens < 1000) return false;
+  bucket.milliTokens -= 1000;
+  return true;
+}
+
+static void store(uint8_t level, const char* line) {
+  uint32_t now = nowMs();
+
+  STREAM_LOCK();
+  if (!takeToken(buckets[level], now)) {
+    rateLimited++;
+    STREAM_UNLOCK();
+    return;
+  }
+
+  if (head - tail >= LOG_STREAM_SLOTS) {
+    // Full - the oldest line makes room
+    tail++;
+    overwritten++;
+  }
+  char* slot = slots[head & LOG_STREAM_MASK];
+  strncpy(slot, line, LOG_STREAM_LINE - 1);
+  slot[LOG_STREAM_LINE - 1] = '\0';
+  head++;
+  STREAM_UNLOCK();
+}
+
+static bool wanted(uint8_t level) {
+  return level >= LOG_LEVEL_ERROR && level <= logStreamLevel();
+}
+
+void logStreamWrite(uint8_t level, const char* module, const char* message) {
+  if (!wanted(level)) return;
+
+  char line[LOG_STREAM_LINE];
+  snprintf(line, sizeof(line), "[%s] %lums %s - %s", logLevelName(level),
+           (unsigned long)nowMs(), module, message);
+  store(level, line);
+}
+
+void logStreamWriteLine(uint8_t level, const char* line) {
+  if (!wanted(level)) return;
+  store(level, line);
+}
+
+size_t logStreamBatch(char* out, size_t size, uint32_t* batchEnd) {
+  size_t used = 0;
+  if (size == 0) return 0;
+  out[0] = '\0';
+
+  STREAM_LOCK();
+  uint32_t number = tail;
+  reportedRate = rateLimited;
+  reportedOverwritten = overwritten;
+
+  if (reportedRate > 0 || reportedOverwritten > 0) {
+    int written = snprintf(out, size, "--- %lu lines dropped (%lu rate limit, %lu buffer full) ---",
+                           (unsigned long)(reportedRate + reportedOverwritten),
+                           (unsigned long)reportedRate, (unsigned long)reportedOverwritten);
+    if (written > 0) used = (size_t)written < size ? (size_t)written : size - 1;
+  }
+
+  while (number != head) {
+    const char* text = slots[number & LOG_STREAM_MASK];
+    size_t length = strlen(text);
+    size_t separator = used > 0 ? 1 : 0;
+    if (used + separator + length + 1 > size) break;
+
+    if (separator) out[used++] = '\n';
+    memcpy(out + used, text, length);
+    used += length;
+    number++;
+  }
+  out[used] = '\0';
+  STREAM_UNLOCK();
+
+  *batchEnd = number;
+  return used;
+}
+
+void logStreamCommit(uint32_t batchEnd) {
+  STREAM_LOCK();
+  // Lines overwritten meanwhile already moved the tail past the batch
+  if ((int32_t)(batchEnd - tail) > 0) {
+    sent += batchEnd - tail;
+    tail = batchEnd;
+  }
+  rateLimited -= reportedRate <= rateLimited ? reportedRate : rateLimited;
+  overwritten -= reportedOverwritten <= overwritten ? reportedOverwritten : overwritten;
+  reportedRate = reportedOverwritten = 0;
+  STREAM_UNLOCK();
+}
+
+LogStreamStats logStreamStats() {
+  LogStreamStats stats;
+  STREAM_LOCK();
+  stats.pending = head - tail;
+  stats.rateLimited = rateLimited;
+  stats.overwritten = overwritten;
+  stats.sent = sent;
+  STREAM_UNLOCK();
+  return stats;
+}
+
+void logStreamLoop(LogStreamPublish publish) {
+  static uint32_t lastBatch = 0;
+  static char payload[LOG_STREAM_BATCH_MAX];
+
+  if (logStreamLevel() == LOG_LEVEL_NONE) return;
+
+  uint32_t now = nowMs();
+  LogStreamStats stats = logStreamStats();
+  if (stats.pending == 0 && stats.rateLimited == 0 && stats.overwritten == 0) return;
+  if (stats.pending < LOG_STREAM_SLOTS / 2 && now - lastBatch < LOG_STREAM_INTERVAL) return;
+  lastBatch = now;
+
+  uint32_t batchEnd;
+  size_t length = logStreamBatch(payload, sizeof(payload), &batchEnd);
+  if (length > 0 && publish(payload, length)) {
+    logStreamCommit(batchEnd);
+  }
+}
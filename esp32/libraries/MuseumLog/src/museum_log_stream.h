@@ -0,0 +1,58 @@
+#ifndef MUSEUM_LOG_STREAM_H
+#define MUSEUM_LOG_STREAM_H
+
+// Remote log sink: copies log lines into a small bounded buffer that the
+// firmware publishes in batches (devices/<id>/log) from its MQTT loop.
+//
+// Off by default and switched at runtime (logStreamSetLevel) - only the
+// compiled-in calls (LOG_MODULE_<name>) can be streamed, the runtime level
+// can narrow them further but never widen them.
+//
+// The capture path never blocks on the network: a line either passes the
+// per-level token bucket and is copied into a slot, or it is counted as
+// rate limited. When all slots are taken the oldest line is overwritten and
+// counted as dropped. Both counters are reported in the next batch.
+//
+// Capture may run on any task / core; logStreamLoop() is single-consumer.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOG_STREAM_SLOTS     16     // Buffered lines
+#define LOG_STREAM_LINE      120    // Bytes per line incl. NUL, longer lines are truncated
+#define LOG_STREAM_BATCH_MAX 1024   // Batch payload limit (MQTT packet buffer must be larger)
+#define LOG_STREAM_INTERVAL  1000   // ms between batches, sooner when half of the slots are full
+
+// Lines at or below level are streamed, LOG_LEVEL_NONE = off
+void logStreamSetLevel(uint8_t level);
+uint8_t logStreamLevel();
+
+// Token bucket per level: perSecond sustained, burst lines at once
+void logStreamSetRate(uint8_t level, uint16_t perSecond, uint16_t burst);
+
+// Capture - called by logWrite() and logRingDrain(), cheap when the stream is off
+void logStreamWrite(uint8_t level, const char* module, const char* message);
+void logStreamWriteLine(uint8_t level, const char* line);
+
+// Oldest buffered lines joined by '\n', preceded by a "--- N dropped ... ---"
+// line when anything was lost. The lines stay buffered until
+// logStreamCommit(batchEnd) - a failed publish is retried with the next batch.
+// Returns the payload length, 0 = nothing to send.
+size_t logStreamBatch(char* out, size_t size, uint32_t* batchEnd);
+void logStreamCommit(uint32_t batchEnd);
+
+struct LogStreamStats {
+  uint32_t pending;        // Lines waiting in the buffer
+  uint32_t rateLimited;    // Rejected by the token bucket (not yet reported)
+  uint32_t overwritten;    // Oldest line overwritten by a full buffer (not yet reported)
+  uint32_t sent;           // Lines committed since boot
+};
+
+LogStreamStats logStreamStats();
+
+// Publishes one batch when due; publish returns false if the packet was not
+// sent (not connected, buffer too small). Call from the MQTT loop.
+typedef bool (*LogStreamPublish)(const char* payload, size_t length);
+void logStreamLoop(LogStreamPublish publish);
+
+#endif
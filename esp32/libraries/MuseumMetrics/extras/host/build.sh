@@ -0,0 +1,23 @@
+#!/bin/bash
+# Builds the host test of the histograms, the loop profiler, schedule
+# lateness, the task / heap statistics engine and the load benchmark (Linux).
+#   ./build.sh        build into ./build
+#   ./build.sh run    build and run it (includes the overhead measurement)
+set -e
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+SRC="$HERE/../../src"
+OUT="$HERE/build"
+mkdir -p "$OUT"
+
+CXXFLAGS="-std=c++17 -g -O2 -Wall -Wextra -pthread -I$SRC"
+CXX="$(command -v clang++ || command -v g++)"
+
+"$CXX" $CXXFLAGS "$SRC/metrics_histogram.cpp" "$SRC/loop_profiler.cpp" "$SRC/schedule_lateness.cpp" \
+  "$SRC/system_stats.cpp" "$SRC/load_bench.cpp" \
+  "$HERE/test_metrics.cpp" -o "$OUT/test_metrics"
+echo "Built: $OUT/test_metrics"
+
+if [ "$1" = "run" ]; then
+  "$OUT/test_metrics"
+fi
@@ -0,0 +1,405 @@
+// Host test of the log2 histogram, the loop profiler, schedule lateness, the
+// task / heap statistics engine and the load benchmark: bucketing,
+// percentiles, the JSON windows, the profiler's own cost per stage, deadline
+// misses, CPU % from run-time deltas, edge-triggered warnings and the rate
+// ramp on a simulated 10 ms loop.
+//   ./test_metrics
+
+#include "museum_metrics.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+static void testBuckets() {
+  CHECK(histBucket(0) == 0);
+  CHECK(histBucket(1) == 1);
+  CHECK(histBucket(2) == 2);
+  CHECK(histBucket(3) == 2);
+  CHECK(histBucket(4) == 3);
+  CHECK(histBucket(1023) == 10);
+  CHECK(histBucket(1024) == 11);
+  CHECK(histBucket(0xFFFFFFFFu) == HIST_BUCKETS - 1);
+}
+
+static void testPercentile() {
+  Log2Histogram hist;
+  histReset(hist);
+  CHECK(histPercentile(hist, 990) == 0);
+
+  for (int i = 0; i < 990; i++) histAdd(hist, 5);     // bucket [4, 7]
+  for (int i = 0; i < 10; i++) histAdd(hist, 3000);   // bucket [2048, 4095]
+  CHECK(hist.count == 1000);
+  CHECK(hist.max == 3000);
+  CHECK(histPercentile(hist, 500) == 7);
+  CHECK(histPercentile(hist, 990) == 7);
+  CHECK(histPercentile(hist, 991) == 3000);   // Capped at the exact max
+  CHECK(histPercentile(hist, 1000) == 3000);
+
+  histReset(hist);
+  histAdd(hist, 1000000);   // Overflow bucket reports the max
+  CHECK(histPercentile(hist, 990) == 1000000);
+}
+
+static void testFormat() {
+  Log2Histogram hist;
+  histReset(hist);
+  char out[128];
+
+  CHECK(histFormat(hist, out, sizeof(out)) > 0);
+  CHECK(strcmp(out, "[0,0,0,0,[]]") == 0);
+
+  histAdd(hist, 5);
+  histAdd(hist, 6);
+  histAdd(hist, 40);
+  CHECK(histFormat(hist, out, sizeof(out)) > 0);
+  CHECK(strcmp(out, "[3,40,40,3,[2,0,0,1]]") == 0);   // p99 bound 63 capped at the max
+
+  char small[8];
+  CHECK(histFormat(hist, small, sizeof(small)) == 0);
+}
+
+enum TestStage : uint8_t { STAGE_FAST, STAGE_SLOW, STAGE_COUNT };
+static const char* const STAGE_NAMES[STAGE_COUNT] = {"fast", "slow"};
+
+static void testProfilerWindow() {
+  profilerBegin(STAGE_NAMES, STAGE_COUNT);
+
+  for (int pass = 0; pass < 20; pass++) {
+    profilerLoopStart();
+    PROFILE_STAGE(STAGE_FAST, (void)0);
+    {
+      ProfileScope scope(STAGE_SLOW);
+      std::this_thread::sleep_for(std::chrono::microseconds(pass == 7 ? 3000 : 200));
+    }
+    profilerLoopEnd();
+  }
+
+  CHECK(profilerLoop()->count == 20);
+  CHECK(profilerStage(STAGE_FAST)->count == 20);
+  CHECK(profilerStage(STAGE_SLOW)->max >= 3000);
+  CHECK(profilerStage(STAGE_SLOW)->max < 100000);
+  CHECK(profilerLoop()->max >= profilerStage(STAGE_SLOW)->max);
+  CHECK(profilerStage(STAGE_COUNT) == nullptr);
+
+  char payload[PROFILER_PAYLOAD_MAX];
+  size_t length = profilerFormat(payload, sizeof(payload));
+  CHECK(length == strlen(payload));
+  CHECK(strncmp(payload, "{\"win_s\":0,\"loops\":20,\"ovh_ppm\":", 32) == 0);
+  CHECK(strstr(payload, "\"stages\":{\"loop\":[20,") != nullptr);
+  CHECK(strstr(payload, ",\"fast\":[20,") != nullptr);
+  CHECK(strstr(payload, ",\"slow\":[20,") != nullptr);
+  CHECK(strcmp(payload + length - 4, "]]}}") == 0);
+  printf("window: %s\n", payload);
+
+  // New window after formatting
+  CHECK(profilerLoop()->count == 0);
+  CHECK(profilerStage(STAGE_SLOW)->max == 0);
+
+  // Too small for the stages: header and closing braces stay valid
+  char small[80];
+  CHECK(profilerFormat(small, sizeof(small)) > 0);
+  CHECK(strcmp(small + strlen(small) - 2, "}}") == 0);
+}
+
+// Cost of one PROFILE_STAGE around an empty stage, against the 1 % budget
+static void benchOverhead() {
+  profilerBegin(STAGE_NAMES, STAGE_COUNT);
+  const int iterations = 2000000;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    PROFILE_STAGE(STAGE_FAST, (void)0);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double nsPerStage = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+  // Relay loop: 6 stages + loop, one pass every ~1.1 ms (delay(1) + stages)
+  double loopPercent = nsPerStage * 7 / 1100000.0 * 100.0;
+  printf("overhead: %.1f ns per stage on this host, ~%.3f %% of a 1.1 ms relay loop\n", nsPerStage,
+         loopPercent);
+  CHECK(loopPercent < 1.0);
+}
+
+static const char* const LATENESS_NAMES[] = {"auto_off", "group1", "alone"};
+
+static void testLateness() {
+  latenessBegin(LATENESS_NAMES, 3, 5000);
+
+  latenessRecord(1, 300);
+  latenessRecord(1, 1200);
+  latenessRecord(1, 9000);     // Miss
+  latenessRecord(1, -50);      // Early counts as on time
+  latenessRecord(0, 5000);     // At the threshold is not a miss
+  latenessRecord(3, 100000);   // Unknown entry ignored
+
+  CHECK(latenessEntry(1)->count == 4);
+  CHECK(latenessEntry(1)->max == 9000);
+  CHECK(latenessEntry(1)->buckets[0] == 1);
+  CHECK(latenessMisses(1) == 1);
+  CHECK(latenessMisses(0) == 0);
+  CHECK(latenessEntry(3) == nullptr);
+
+  // Due 2 ms ago on the host millis timeline (whole ms + sub-ms part)
+  using namespace std::chrono;
+  uint32_t nowMs = (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  latenessRecordMs(2, nowMs - 2);
+  CHECK(latenessEntry(2)->max >= 2000);
+  CHECK(latenessEntry(2)->max < 50000);
+  latenessRecordMs(2, nowMs + 1000);   // Not due yet - recorded as 0
+  CHECK(latenessEntry(2)->buckets[0] == 1);
+
+  char payload[LATENESS_PAYLOAD_MAX];
+  size_t length = latenessFormat(payload, sizeof(payload));
+  CHECK(length == strlen(payload));
+  CHECK(strncmp(payload, "{\"win_s\":0,\"miss_us\":5000,\"entries\":{\"auto_off\":[0,[1,5000,5000,13,[1]]],", 72) == 0);
+  CHECK(strstr(payload, "\"group1\":[1,[4,9000,9000,0,[1,0,0,0,0,0,0,0,0,1,0,1,0,0,1]]]") != nullptr);
+  CHECK(strcmp(payload + length - 4, "]]}}") == 0);
+  printf("timing: %s\n", payload);
+
+  // New window: empty entries are left out
+  CHECK(latenessEntry(1)->count == 0);
+  CHECK(latenessMisses(1) == 0);
+  CHECK(latenessFormat(payload, sizeof(payload)) > 0);
+  CHECK(strcmp(payload, "{\"win_s\":0,\"miss_us\":5000,\"entries\":{}}") == 0);
+
+  // Too small for the entries: header and closing braces stay valid
+  latenessRecord(1, 300);
+  char small[56];
+  CHECK(latenessFormat(small, sizeof(small)) > 0);
+  CHECK(strcmp(small, "{\"win_s\":0,\"miss_us\":5000,\"entries\":{}}") == 0);
+}
+
+static TaskSample task(uint32_t id, const char* name, uint32_t runTime, uint32_t stackFree) {
+  TaskSample sample = {};
+  sample.id = id;
+  strncpy(sample.name, name, SYSSTATS_NAME_LEN - 1);
+  sample.runTime = runTime;
+  sample.stackFree = stackFree;
+  return sample;
+}
+
+static const char* lastWarning = nullptr;
+static char warningBuffer[128];
+static int warningCount = 0;
+
+static bool captureWarning(const char* payload) {
+  strncpy(warningBuffer, payload, sizeof(warningBuffer) - 1);
+  lastWarning = warningBuffer;
+  warningCount++;
+  return true;
+}
+
+static void testSystemStats() {
+  SystemStats stats;
+  HeapSample heap = {100000, 80000, 60000};
+
+  // First sample: no baseline, CPU unknown
+  TaskSample first[] = {task(1, "IDLE0", 1000, 900), task(2, "IDLE1", 1000, 900),
+                        task(3, "loopTask", 500, 4000), task(4, "wifi", 200, 2000)};
+  systemStatsUpdate(first, 4, true, heap, &stats);
+  CHECK(stats.taskCount == 4);
+  CHECK(stats.fragmentation == 40);
+  CHECK(stats.tasks[2].cpuTenths == SYSSTATS_CPU_UNKNOWN);
+
+  char out[512];
+  CHECK(systemStatsFormat(stats, out, sizeof(out)) > 0);
+  CHECK(strstr(out, "{\"heap\":[100000,80000,60000,40],\"tasks\":{\"IDLE0\":[null,900],") == out);
+
+  // 2 cores x 1000 ticks: IDLE0 90 %, IDLE1 50 %, loopTask 50 %, wifi 10 %
+  TaskSample second[] = {task(1, "IDLE0", 1900, 900), task(2, "IDLE1", 1500, 900),
+                         task(3, "loopTask", 1000, 3900), task(4, "wifi", 300, 2000)};
+  systemStatsUpdate(second, 4, true, heap, &stats);
+  CHECK(stats.tasks[0].cpuTenths == 900);
+  CHECK(stats.tasks[1].cpuTenths == 500);
+  CHECK(stats.tasks[2].cpuTenths == 500);
+  CHECK(stats.tasks[3].cpuTenths == 100);
+  CHECK(systemStatsFormat(stats, out, sizeof(out)) > 0);
+  CHECK(strstr(out, "\"loopTask\":[50.0,3900]") != nullptr);
+  CHECK(strcmp(out + strlen(out) - 2, "}}") == 0);
+  printf("diag: %s\n", out);
+
+  // Tasks that do not fit are left out, the JSON stays closed
+  char small[80];
+  CHECK(systemStatsFormat(stats, small, sizeof(small)) > 0);
+  CHECK(strcmp(small + strlen(small) - 2, "}}") == 0);
+  CHECK(strstr(small, "wifi") == nullptr);
+
+  // Counter wrap between samples
+  TaskSample wrapped[] = {task(1, "IDLE0", 0xFFFFFF00u, 900)};
+  systemStatsUpdate(wrapped, 1, true, heap, &stats);
+  TaskSample afterWrap[] = {task(1, "IDLE0", 0x100, 900)};
+  systemStatsUpdate(afterWrap, 1, true, heap, &stats);
+  CHECK(stats.tasks[0].cpuTenths == 1000);   // Single task capped at one core
+
+  // Without run-time stats CPU stays unknown
+  systemStatsUpdate(second, 4, false, heap, &stats);
+  systemStatsUpdate(second, 4, false, heap, &stats);
+  CHECK(stats.tasks[2].cpuTenths == SYSSTATS_CPU_UNKNOWN);
+}
+
+static void testSystemWarnings() {
+  SystemThresholds limits = {50000, 50, 1000, 40};
+  SystemStats stats;
+  HeapSample healthy = {100000, 90000, 80000};
+
+  TaskSample base[] = {task(1, "IDLE0", 0, 1500), task(3, "loopTask", 0, 4000)};
+  systemStatsUpdate(base, 2, true, healthy, &stats);
+  warningCount = 0;
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 0);
+
+  // IDLE at 100 % is not a CPU warning; loopTask at 60 % is, its stack too
+  TaskSample busy[] = {task(1, "IDLE0", 1400, 1500), task(3, "loopTask", 600, 800)};
+  systemStatsUpdate(busy, 2, true, healthy, &stats);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 2);
+  CHECK(strcmp(lastWarning, "{\"warn\":\"cpu\",\"task\":\"loopTask\",\"value\":60,\"limit\":40}") == 0);
+
+  // Still over the limits: no repeat
+  TaskSample stillBusy[] = {task(1, "IDLE0", 2800, 1500), task(3, "loopTask", 1200, 800)};
+  systemStatsUpdate(stillBusy, 2, true, healthy, &stats);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 0);
+
+  // Heap low and fragmented
+  HeapSample low = {40000, 30000, 10000};
+  systemStatsUpdate(stillBusy, 2, true, low, &stats);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 2);
+  CHECK(strcmp(lastWarning, "{\"warn\":\"heap_frag\",\"value\":75,\"limit\":50}") == 0);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 0);
+
+  // Back in range re-arms
+  systemStatsUpdate(stillBusy, 2, true, healthy, &stats);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 0);
+  systemStatsUpdate(stillBusy, 2, true, low, &stats);
+  CHECK(systemStatsCheck(stats, limits, captureWarning) == 2);
+  CHECK(warningCount == 6);
+
+  // Zero thresholds disable the checks
+  SystemThresholds none = {};
+  systemStatsUpdate(stillBusy, 2, true, low, &stats);
+  CHECK(systemStatsCheck(stats, none, captureWarning) == 0);
+}
+
+static uint32_t injected = 0;
+static bool injectSawFlag = false;
+
+static void benchInject(uint32_t sequence) {
+  CHECK(sequence == injected);
+  injected++;
+  injectSawFlag = benchInjecting();
+  benchRecordApply(120);
+}
+
+// Loop passes every passUs on a virtual clock, until the run ends
+static void runBench(int64_t passUs) {
+  injected = 0;
+  int64_t now = 1000000;
+  for (int pass = 0; pass < 100000 && benchRunning(); pass++, now += passUs) benchTick(now, benchInject);
+}
+
+static void testBenchRamp() {
+  CHECK(!benchStart(5, 1000));   // Below the first step
+  CHECK(benchStart(1000, 1000));
+  CHECK(!benchStart(1000, 1000));   // Already running
+  CHECK(!benchInjecting());
+
+  // One command per 10 ms pass: 100/s keeps up, 200/s queues into stale drops,
+  // 500/s drops more than it sends and ends the ramp
+  runBench(10000);
+  CHECK(!benchRunning());
+  CHECK(benchReportReady());
+  CHECK(injectSawFlag);
+  CHECK(benchStepCount() == 6);
+
+  const uint16_t rates[] = {10, 20, 50, 100, 200, 500};
+  for (uint8_t i = 0; i < 6; i++) CHECK(benchStep(i)->rate == rates[i]);
+  for (uint8_t i = 0; i < 4; i++) {
+    CHECK(benchStep(i)->sent == rates[i]);
+    CHECK(benchStep(i)->dropped == 0);
+    CHECK(benchStep(i)->latencyMax < 11000);   // At most one pass late
+    CHECK(benchStep(i)->applyMax == 120);
+  }
+  const BenchStepResult* queued = benchStep(4);
+  CHECK(queued->sent + queued->dropped == 200);
+  CHECK(queued->dropped > 0);
+  CHECK(queued->latencyMax > BENCH_STALE_US - 20000);
+  const BenchStepResult* saturated = benchStep(5);
+  CHECK(saturated->dropped > saturated->sent);
+
+  char report[BENCH_PAYLOAD_MAX];
+  size_t length = benchFormat(report, sizeof(report));
+  CHECK(length == strlen(report));
+  CHECK(!benchReportReady());
+  CHECK(strstr(report, "{\"build\":\"00000000\",\"max_rate\":1000,\"step_ms\":1000,\"stale_ms\":500,"
+                       "\"end\":\"saturated\",\"sustained\":100,\"cols\":[") == report);
+  CHECK(strstr(report, "\"steps\":[[10,10,0,") != nullptr);
+  CHECK(strcmp(report + length - 3, "]]}") == 0);
+  printf("bench: %s\n", report);
+
+  char small[64];
+  CHECK(benchFormat(small, sizeof(small)) == 0);
+  CHECK(small[0] == '\0');
+
+  // Outside the dispatch nothing is attributed to the benchmark
+  benchRecordApply(5000);
+  CHECK(!benchInjecting());
+}
+
+static void testBenchStop() {
+  // Every step up to maxRate, the last one at maxRate itself
+  CHECK(benchStart(30, 500));
+  runBench(1000);
+  CHECK(benchStepCount() == 3);
+  CHECK(benchStep(2)->rate == 30);
+  CHECK(benchStep(2)->sent == 15);
+  char report[BENCH_PAYLOAD_MAX];
+  CHECK(benchFormat(report, sizeof(report)) > 0);
+  CHECK(strstr(report, "\"end\":\"done\",\"sustained\":30,") != nullptr);
+
+  // Stopped in the second step: only the finished first one is reported
+  CHECK(benchStart(100, 500));
+  injected = 0;
+  int64_t now = 0;
+  for (; now < 700000; now += 1000) benchTick(now, benchInject);
+  benchStop("command");
+  CHECK(!benchRunning());
+  CHECK(benchReportReady());
+  benchTick(now, benchInject);
+  CHECK(benchStepCount() == 1);
+  CHECK(benchFormat(report, sizeof(report)) > 0);
+  CHECK(strstr(report, "\"end\":\"command\",\"sustained\":10,") != nullptr);
+  CHECK(strstr(report, "\"steps\":[[10,5,0,") != nullptr);
+
+  benchStop("mqtt");   // Not running - no new report
+  CHECK(!benchReportReady());
+}
+
+int main() {
+  testBuckets();
+  testPercentile();
+  testFormat();
+  testProfilerWindow();
+  benchOverhead();
+  testLateness();
+  testSystemStats();
+  testSystemWarnings();
+  testBenchRamp();
+  testBenchStop();
+
+  if (failures > 0) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("test_metrics: OK\n");
+  return 0;
+}
@@ -0,0 +1,284 @@
+#include "load_bench.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_app_desc.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#endif
+
+struct BenchState {
+  bool running;
+  bool reportReady;
+  const char* end;
+  uint16_t maxRate;
+  uint16_t stepMs;
+  uint16_t rates[BENCH_MAX_STEPS];
+  uint8_t rateCount;
+  uint8_t step;
+  int64_t stepStartUs;     // -1 until the first benchTick() of the step
+  uint32_t next;           // Index of the next command in the step
+  uint32_t sent;
+  uint32_t dropped;
+  uint32_t sequence;
+  Log2Histogram latency;
+  Log2Histogram process;
+  Log2Histogram apply;
+  BenchStepResult results[BENCH_MAX_STEPS];
+  uint8_t resultCount;
+};
+
+static BenchState bench = {};
+
+// Set only around the BenchInject call
+static volatile bool injecting = false;
+static uint32_t injectApplyUs = 0;
+static bool injectApplied = false;
+#ifdef ARDUINO
+static TaskHandle_t injectingTask = nullptr;
+#endif
+
+static int64_t clockUs() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t currentBuildId() {
+#ifdef ARDUINO
+  uint32_t id;
+  memcpy(&id, esp_app_get_description()->app_elf_sha256, sizeof(id));
+  return id;
+#else
+  return 0;
+#endif
+}
+
+// 10, 20, 50, 100, 200, 500 ... below maxRate, then maxRate itself
+static uint8_t buildRates(uint16_t maxRate, uint16_t* rates) {
+  static const uint8_t SERIES[] = {1, 2, 5};
+  uint8_t count = 0;
+  for (uint32_t decade = BENCH_START_RATE; count < BENCH_MAX_STEPS - 1; decade *= 10) {
+    for (uint8_t i = 0; i < 3 && count < BENCH_MAX_STEPS - 1; i++) {
+      uint32_t rate = decade * SERIES[i];
+      if (rate >= maxRate) {
+        rates[count++] = maxRate;
+        return count;
+      }
+      rates[count++] = (uint16_t)rate;
+    }
+  }
+  rates[count++] = maxRate;
+  return count;
+}
+
+static void resetStep() {
+  bench.stepStartUs = -1;
+  bench.next = 0;
+  bench.sent = 0;
+  bench.dropped = 0;
+  histReset(bench.latency);
+  histReset(bench.process);
+  histReset(bench.apply);
+}
+
+static void finish(const char* reason) {
+  bench.running = false;
+  bench.reportReady = true;
+  bench.end = reason;
+}
+
+bool benchStart(uint16_t maxRate, uint16_t stepMs) {
+  if (bench.running || maxRate < BENCH_START_RATE || stepMs == 0) return false;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.maxRate = maxRate;
+  bench.stepMs = stepMs;
+  bench.rateCount = buildRates(maxRate, bench.rates);
+  resetStep();
+  bench.running = true;
+  return true;
+}
+
+void benchStop(const char* reason) {
+  // The unfinished step is left out of the report
+  if (bench.running) finish(reason);
+}
+
+bool benchRunning() {
+  return bench.running;
+}
+
+bool benchInjecting() {
+  if (!injecting) return false;
+#ifdef ARDUINO
+  // The motor speed task writes outputs too - only the injecting task counts
+  return xTaskGetCurrentTaskHandle() == injectingTask;
+#else
+  return true;
+#endif
+}
+
+void benchRecordApply(uint32_t us) {
+  if (!benchInjecting()) return;
+  injectApplyUs += us;
+  injectApplied = true;
+}
+
+static int64_t dueUs(uint32_t index, uint16_t rate) {
+  return bench.stepStartUs + (int64_t)index * 1000000 / rate;
+}
+
+static void injectOne(int64_t nowUs, uint16_t rate, BenchInject inject) {
+  int64_t due = dueUs(bench.next, rate);
+  bench.next++;
+
+  injectApplyUs = 0;
+  injectApplied = false;
+#ifdef ARDUINO
+  injectingTask = xTaskGetCurrentTaskHandle();
+#endif
+  injecting = true;
+  int64_t start = clockUs();
+  inject(bench.sequence++);
+  int64_t elapsed = clockUs() - start;
+  injecting = false;
+
+  uint32_t process = elapsed > 0 ? (uint32_t)elapsed : 0;
+  int64_t waited = nowUs - due;
+  histAdd(bench.process, process);
+  histAdd(bench.latency, (waited > 0 ? (uint32_t)waited : 0) + process);
+  if (injectApplied) histAdd(bench.apply, injectApplyUs);
+  bench.sent++;
+}
+
+static void finishStep(int64_t nowUs) {
+  BenchStepResult& result = bench.results[bench.resultCount++];
+  result.rate = bench.rates[bench.step];
+  result.sent = bench.sent;
+  result.dropped = bench.dropped;
+  result.latencyP99 = histPercentile(bench.latency, 990);
+  result.latencyMax = bench.latency.max;
+  result.processP99 = histPercentile(bench.process, 990);
+  result.processMax = bench.process.max;
+  result.applyP99 = histPercentile(bench.apply, 990);
+  result.applyMax = bench.apply.max;
+
+  bench.step++;
+  if (result.dropped > result.sent) {
+    finish("saturated");   // Higher rates would only drop more
+  } else if (bench.step >= bench.rateCount) {
+    finish("done");
+  } else {
+    resetStep();
+    bench.stepStartUs = nowUs;
+  }
+}
+
+void benchTick(int64_t nowUs, BenchInject inject) {
+  if (!bench.running) return;
+  if (bench.stepStartUs < 0) bench.stepStartUs = nowUs;
+
+  uint16_t rate = bench.rates[bench.step];
+  uint32_t total = (uint32_t)((uint64_t)bench.stepMs * rate / 1000);
+  int64_t elapsed = nowUs - bench.stepStartUs;
+
+  // Commands due by now; the stale ones are dropped, as a late cue would be
+  uint64_t due = (uint64_t)elapsed * rate / 1000000 + 1;
+  if (due > total) due = total;
+  while (bench.next < due && dueUs(bench.next, rate) + BENCH_STALE_US < nowUs) {
+    bench.next++;
+    bench.dropped++;
+  }
+
+  // One per pass, like one MQTT packet per client.loop()
+  if (bench.next < due) {
+    injectOne(nowUs, rate, inject);
+    if (!bench.running) return;   // Stopped from inside the dispatch
+  }
+
+  if (elapsed >= (int64_t)bench.stepMs * 1000) {
+    bench.dropped += total - bench.next;   // Backlog at the end of the step
+    finishStep(nowUs);
+  }
+}
+
+void benchLoop(BenchInject inject) {
+  if (bench.running) benchTick(clockUs(), inject);
+}
+
+bool benchReportReady() {
+  return bench.reportReady;
+}
+
+uint8_t benchStepCount() {
+  return bench.resultCount;
+}
+
+const BenchStepResult* benchStep(uint8_t step) {
+  return step < bench.resultCount ? &bench.results[step] : nullptr;
+}
+
+// Appends to out at *used; false once the buffer is full (the report is then dropped)
+static bool append(char* out, size_t size, size_t* used, const char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static bool append(char* out, size_t size, size_t* used, const char* format, ...) {
+  if (*used >= size) return false;
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(out + *used, size - *used, format, args);
+  va_end(args);
+  if (written < 0 || *used + written >= size) {
+    *used = size;
+    return false;
+  }
+  *used += written;
+  return true;
+}
+
+size_t benchFormat(char* out, size_t size) {
+  if (size > 0) out[0] = '\0';
+  if (size == 0) return 0;
+  bench.reportReady = false;
+
+  uint16_t sustained = 0;
+  for (uint8_t i = 0; i < bench.resultCount; i++) {
+    const BenchStepResult& result = bench.results[i];
+    if (result.dropped == 0 && result.latencyP99 <= BENCH_LATENCY_OK_US && result.rate > sustained) {
+      sustained = result.rate;
+    }
+  }
+
+  size_t used = 0;
+  uint32_t buildId = currentBuildId();
+  const uint8_t* b = (const uint8_t*)&buildId;
+  append(out, size, &used,
+         "{\"build\":\"%02x%02x%02x%02x\",\"max_rate\":%u,\"step_ms\":%u,\"stale_ms\":%u,"
+         "\"end\":\"%s\",\"sustained\":%u,\"cols\":[\"rate\",\"sent\",\"drop\",\"lat_p99\",\"lat_max\","
+         "\"proc_p99\",\"proc_max\",\"apply_p99\",\"apply_max\"],\"steps\":[",
+         b[0], b[1], b[2], b[3], bench.maxRate, bench.stepMs, BENCH_STALE_US / 1000,
+         bench.end != nullptr ? bench.end : "running", sustained);
+  for (uint8_t i = 0; i < bench.resultCount; i++) {
+    const BenchStepResult& r = bench.results[i];
+    append(out, size, &used, "%s[%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu]", i > 0 ? "," : "", r.rate,
+           (unsigned long)r.sent, (unsigned long)r.dropped, (unsigned long)r.latencyP99,
+           (unsigned long)r.latencyMax, (unsigned long)r.processP99, (unsigned long)r.processMax,
+           (unsigned long)r.applyP99, (unsigned long)r.applyMax);
+  }
+
+  if (!append(out, size, &used, "]}")) {
+    out[0] = '\0';
+    return 0;
+  }
+  return used;
+}
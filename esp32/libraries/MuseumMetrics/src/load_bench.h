@@ -0,0 +1,78 @@
+#ifndef LOAD_BENCH_H
+#define LOAD_BENCH_H
+
+// Synthetic load benchmark: injects generated commands into the firmware's
+// normal dispatch path (its MQTT callback) at a rising rate - 10, 20, 50,
+// 100 ... commands per second up to maxRate, stepMs per step - and measures
+// per step:
+//   latency  due time -> dispatch returned (queueing behind the loop included)
+//   process  time inside the dispatch (parse, apply, feedback publish)
+//   apply    output write reported by the hardware layer (I2C / PWM)
+//   drops    commands still waiting BENCH_STALE_US after they were due,
+//            plus those left over at the end of the step
+// At most one command is injected per benchLoop() call, as PubSubClient
+// handles one packet per client.loop(), so the loop rate caps throughput
+// the same way it does for real traffic. benchFormat() renders the report
+// for devices/<id>/bench.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "metrics_histogram.h"
+
+#define BENCH_START_RATE    10
+#define BENCH_MAX_STEPS     10
+#define BENCH_STALE_US      500000   // A cue half a second late is as good as lost
+#define BENCH_LATENCY_OK_US 50000    // p99 latency still counted as sustained
+#define BENCH_PAYLOAD_MAX   1024     // Fits the firmware's MQTT packet buffer
+
+// Dispatches synthetic command number `sequence` through the normal path
+typedef void (*BenchInject)(uint32_t sequence);
+
+// Per finished step, microseconds
+struct BenchStepResult {
+  uint16_t rate;
+  uint32_t sent;
+  uint32_t dropped;
+  uint32_t latencyP99, latencyMax;
+  uint32_t processP99, processMax;
+  uint32_t applyP99, applyMax;
+};
+
+// Starts a run; false if one is running. maxRate >= BENCH_START_RATE.
+bool benchStart(uint16_t maxRate, uint16_t stepMs);
+
+// Ends a run early - reason (string literal) goes into the report as "end"
+void benchStop(const char* reason);
+
+bool benchRunning();
+
+// True inside the BenchInject callback (on the injecting task) - the firmware
+// routes feedback of synthetic commands away from the real feedback topics
+bool benchInjecting();
+
+// Output write time of a synthetic command; ignored outside benchInjecting()
+void benchRecordApply(uint32_t us);
+
+// Once per loop pass (mqttLoop(), next to client.loop())
+void benchLoop(BenchInject inject);
+
+// Engine behind benchLoop() with the time passed in - used by the host tests
+void benchTick(int64_t nowUs, BenchInject inject);
+
+// A finished or stopped run waits to be reported
+bool benchReportReady();
+
+// {"build":"1a2b3c4d","max_rate":N,"step_ms":N,"stale_ms":N,"end":"done","sustained":N,
+//  "cols":["rate","sent","drop","lat_p99","lat_max","proc_p99","proc_max","apply_p99","apply_max"],
+//  "steps":[[10,20,0,...],...]}
+// end = done | saturated (a step dropped more than it sent) | <benchStop() reason>.
+// sustained = highest rate without drops and with p99 latency <= BENCH_LATENCY_OK_US, 0 if none.
+// Clears benchReportReady(); returns the length, 0 if it does not fit.
+size_t benchFormat(char* out, size_t size);
+
+// Read-only view for tests
+uint8_t benchStepCount();
+const BenchStepResult* benchStep(uint8_t step);
+
+#endif
@@ -0,0 +1,127 @@
+#include "loop_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+struct ProfilerState {
+  const char* const* names;
+  uint8_t count;
+  uint32_t cyclesPerUs;
+  Log2Histogram stages[PROFILER_MAX_STAGES];
+  Log2Histogram loop;
+  uint32_t loopStart;
+  uint64_t overheadCycles;
+  int64_t windowStartUs;
+};
+
+static ProfilerState profiler = {};
+
+static int64_t nowUs() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint32_t profilerNow() {
+#ifdef ARDUINO
+  return esp_cpu_get_cycle_count();
+#else
+  // Host: nanoseconds stand in for cycles (1000 per microsecond)
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void profilerBegin(const char* const* stageNames, uint8_t count) {
+  memset(&profiler, 0, sizeof(profiler));
+  profiler.names = stageNames;
+  profiler.count = count <= PROFILER_MAX_STAGES ? count : PROFILER_MAX_STAGES;
+#ifdef ARDUINO
+  profiler.cyclesPerUs = getCpuFrequencyMhz();
+#else
+  profiler.cyclesPerUs = 1000;
+#endif
+  profiler.windowStartUs = nowUs();
+}
+
+static void record(Log2Histogram& hist, uint32_t startCycles) {
+  uint32_t end = profilerNow();
+  if (profiler.cyclesPerUs == 0) return;   // profilerBegin() not called
+  histAdd(hist, (end - startCycles) / profiler.cyclesPerUs);
+  profiler.overheadCycles += profilerNow() - end;
+}
+
+void profilerRecord(uint8_t stage, uint32_t startCycles) {
+  if (stage < profiler.count) record(profiler.stages[stage], startCycles);
+}
+
+void profilerLoopStart() {
+  profiler.loopStart = profilerNow();
+}
+
+void profilerLoopEnd() {
+  record(profiler.loop, profiler.loopStart);
+}
+
+const Log2Histogram* profilerStage(uint8_t stage) {
+  return stage < profiler.count ? &profiler.stages[stage] : nullptr;
+}
+
+const Log2Histogram* profilerLoop() {
+  return &profiler.loop;
+}
+
+// ,"name":[...] - appended only if it fits with room for the closing "}}"
+static size_t appendStage(char* out, size_t used, size_t size, const char* name,
+                          const Log2Histogram& hist) {
+  int prefix = snprintf(out + used, size - used, "%s\"%s\":", out[used - 1] == '{' ? "" : ",", name);
+  if (prefix < 0 || used + prefix + 3 > size) return used;
+
+  size_t length = histFormat(hist, out + used + prefix, size - used - prefix - 2);
+  if (length == 0) {
+    out[used] = '\0';
+    return used;
+  }
+  return used + prefix + length;
+}
+
+size_t profilerFormat(char* out, size_t size) {
+  int64_t now = nowUs();
+  int64_t windowUs = now - profiler.windowStartUs;
+  uint64_t overheadUs = profiler.cyclesPerUs > 0 ? profiler.overheadCycles / profiler.cyclesPerUs : 0;
+  uint32_t ppm = windowUs > 0 ? (uint32_t)(overheadUs * 1000000ULL / (uint64_t)windowUs) : 0;
+
+  int header = snprintf(out, size, "{\"win_s\":%lu,\"loops\":%lu,\"ovh_ppm\":%lu,\"stages\":{",
+                        (unsigned long)(windowUs / 1000000), (unsigned long)profiler.loop.count,
+                        (unsigned long)ppm);
+  if (header < 0 || (size_t)header + 3 > size) {
+    if (size > 0) out[0] = '\0';
+    return 0;
+  }
+
+  size_t used = appendStage(out, header, size, "loop", profiler.loop);
+  for (uint8_t stage = 0; stage < profiler.count; stage++) {
+    used = appendStage(out, used, size, profiler.names[stage], profiler.stages[stage]);
+  }
+  out[used++] = '}';
+  out[used++] = '}';
+  out[used] = '\0';
+
+  // New window
+  for (uint8_t stage = 0; stage < profiler.count; stage++) histReset(profiler.stages[stage]);
+  histReset(profiler.loop);
+  profiler.overheadCycles = 0;
+  profiler.windowStartUs = now;
+  return used;
+}
@@ -0,0 +1,62 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+// Main-loop stage profiler: each stage is timed with the CPU cycle counter
+// and recorded (in microseconds) into a log2 histogram, together with the
+// whole loop pass. profilerFormat() renders the window as compact JSON for
+// devices/<id>/metrics and starts a new window.
+//
+// The cycle counter is per core - all stages must run on the loop task,
+// which the Arduino core pins to one core. It wraps after ~17 s at 240 MHz,
+// far beyond any single stage.
+//
+// The profiler measures its own bookkeeping and reports it as ovh_ppm
+// (parts per million of the window); the budget is < 10000 (1 %).
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "metrics_histogram.h"
+
+#define PROFILER_MAX_STAGES  8
+#define PROFILER_PAYLOAD_MAX 1024   // Fits the firmware's MQTT packet buffer
+
+// stageNames must outlive the profiler (string literals); count <= PROFILER_MAX_STAGES
+void profilerBegin(const char* const* stageNames, uint8_t count);
+
+uint32_t profilerNow();   // Raw cycle counter
+void profilerRecord(uint8_t stage, uint32_t startCycles);
+
+// Around the whole loop() body - the "loop" entry and the window's pass count
+void profilerLoopStart();
+void profilerLoopEnd();
+
+// {"win_s":60,"loops":N,"ovh_ppm":N,"stages":{"loop":[...],"<name>":[...]}}
+// each stage as histFormat(); stages that do not fit are left out.
+// Resets the window, returns the length.
+size_t profilerFormat(char* out, size_t size);
+
+// Read-only view for tests / serial diagnostics
+const Log2Histogram* profilerStage(uint8_t stage);
+const Log2Histogram* profilerLoop();
+
+// One call: PROFILE_STAGE(STAGE_MQTT, mqttLoop());
+#define PROFILE_STAGE(stage, ...)                     \
+  do {                                                \
+    uint32_t profileStart_ = profilerNow();           \
+    __VA_ARGS__;                                      \
+    profilerRecord((stage), profileStart_);           \
+  } while (0)
+
+// Block scope: ProfileScope scope(STAGE_NET);
+class ProfileScope {
+ public:
+  explicit ProfileScope(uint8_t stage) : stage_(stage), start_(profilerNow()) {}
+  ~ProfileScope() { profilerRecord(stage_, start_); }
+
+ private:
+  uint8_t stage_;
+  uint32_t start_;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "metrics_histogram.h"
+
+#include <stdio.h>
+#include <string.h>
+
+void histReset(Log2Histogram& hist) {
+  memset(&hist, 0, sizeof(hist));
+}
+
+static uint32_t bucketUpperBound(uint8_t bucket) {
+  return bucket == 0 ? 0 : (1UL << bucket) - 1;
+}
+
+uint32_t histPercentile(const Log2Histogram& hist, uint16_t permille) {
+  if (hist.count == 0) return 0;
+
+  // Rank of the wanted value, rounded up (p99 of 10 values = the 10th)
+  uint64_t rank = ((uint64_t)hist.count * permille + 999) / 1000;
+  if (rank == 0) rank = 1;
+
+  uint64_t seen = 0;
+  for (uint8_t bucket = 0; bucket < HIST_BUCKETS; bucket++) {
+    seen += hist.buckets[bucket];
+    if (seen >= rank) {
+      uint32_t bound = bucketUpperBound(bucket);
+      return bucket == HIST_BUCKETS - 1 || bound > hist.max ? hist.max : bound;
+    }
+  }
+  return hist.max;
+}
+
+size_t histFormat(const Log2Histogram& hist, char* out, size_t size) {
+  int first = -1;
+  int last = -1;
+  for (int bucket = 0; bucket < HIST_BUCKETS; bucket++) {
+    if (hist.buckets[bucket] == 0) continue;
+    if (first < 0) first = bucket;
+    last = bucket;
+  }
+
+  int used = snprintf(out, size, "[%lu,%lu,%lu,%d,[", (unsigned long)hist.count,
+                      (unsigned long)histPercentile(hist, 990), (unsigned long)hist.max,
+                      first < 0 ? 0 : first);
+  if (used < 0 || (size_t)used >= size) return 0;
+
+  for (int bucket = first; first >= 0 && bucket <= last; bucket++) {
+    int written = snprintf(out + used, size - used, bucket == first ? "%lu" : ",%lu",
+                           (unsigned long)hist.buckets[bucket]);
+    if (written < 0 || (size_t)(used + written) >= size) return 0;
+    used += written;
+  }
+
+  if ((size_t)used + 2 >= size) return 0;
+  out[used++] = ']';
+  out[used++] = ']';
+  out[used] = '\0';
+  return used;
+}
@@ -0,0 +1,42 @@
+#ifndef METRICS_HISTOGRAM_H
+#define METRICS_HISTOGRAM_H
+
+// Fixed-bucket log2 histogram: bucket 0 counts zeros, bucket i counts values
+// in [2^(i-1), 2^i), the last bucket everything above. Adding a value is a
+// count-leading-zeros and two increments - cheap enough for every loop pass.
+// Percentiles are bucket upper bounds (capped at the exact max), so p99 is an
+// upper estimate within a factor of two.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HIST_BUCKETS 20   // Last bucket >= 2^18 (262 ms when recording microseconds)
+
+struct Log2Histogram {
+  uint32_t buckets[HIST_BUCKETS];
+  uint32_t count;
+  uint32_t max;
+};
+
+inline uint8_t histBucket(uint32_t value) {
+  if (value == 0) return 0;
+  uint8_t bucket = (uint8_t)(32 - __builtin_clz(value));
+  return bucket < HIST_BUCKETS ? bucket : HIST_BUCKETS - 1;
+}
+
+inline void histAdd(Log2Histogram& hist, uint32_t value) {
+  hist.buckets[histBucket(value)]++;
+  hist.count++;
+  if (value > hist.max) hist.max = value;
+}
+
+void histReset(Log2Histogram& hist);
+
+// Upper bound of the bucket holding the permille-th value (990 = p99), 0 when empty
+uint32_t histPercentile(const Log2Histogram& hist, uint16_t permille);
+
+// "[n,p99,max,first,[c,c,...]]" - counts from the first to the last non-empty
+// bucket, first = index of the first one. Returns the length, 0 if it does not fit.
+size_t histFormat(const Log2Histogram& hist, char* out, size_t size);
+
+#endif
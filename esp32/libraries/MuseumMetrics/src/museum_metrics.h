@@ -0,0 +1,16 @@
+#ifndef MUSEUM_METRICS_H
+#define MUSEUM_METRICS_H
+
+// Runtime metrics shared by the museum firmwares: log2 histograms, the
+// main-loop stage profiler (devices/<id>/metrics), schedule lateness of timed
+// outputs (devices/<id>/timing), FreeRTOS task / heap statistics
+// (devices/<id>/diag) and the synthetic load benchmark (devices/<id>/bench).
+// Published by each firmware's mqtt_manager.
+
+#include "metrics_histogram.h"
+#include "loop_profiler.h"
+#include "schedule_lateness.h"
+#include "system_stats.h"
+#include "load_bench.h"
+
+#endif
@@ -0,0 +1,114 @@
+#include "schedule_lateness.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+struct LatenessState {
+  const char* const* names;
+  uint8_t count;
+  uint32_t missUs;
+  Log2Histogram entries[LATENESS_MAX_ENTRIES];
+  uint32_t misses[LATENESS_MAX_ENTRIES];
+  int64_t windowStartUs;
+};
+
+static LatenessState lateness = {};
+
+static int64_t nowUs() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void latenessBegin(const char* const* entryNames, uint8_t count, uint32_t missThresholdUs) {
+  memset(&lateness, 0, sizeof(lateness));
+  lateness.names = entryNames;
+  lateness.count = count <= LATENESS_MAX_ENTRIES ? count : LATENESS_MAX_ENTRIES;
+  lateness.missUs = missThresholdUs;
+  lateness.windowStartUs = nowUs();
+}
+
+void latenessRecord(uint8_t entry, int32_t latenessUs) {
+  if (entry >= lateness.count) return;
+  uint32_t value = latenessUs > 0 ? (uint32_t)latenessUs : 0;
+  histAdd(lateness.entries[entry], value);
+  if (lateness.missUs > 0 && value > lateness.missUs) lateness.misses[entry]++;
+}
+
+void latenessRecordMs(uint8_t entry, uint32_t dueMs) {
+  // millis() on the ESP32 is the same timer divided by 1000
+  int64_t now = nowUs();
+  uint32_t nowMs = (uint32_t)(now / 1000);
+  int32_t lateMs = (int32_t)(nowMs - dueMs);
+  if (lateMs < 0) {
+    latenessRecord(entry, 0);
+    return;
+  }
+  uint64_t lateUs = (uint64_t)lateMs * 1000 + (uint64_t)(now % 1000);
+  latenessRecord(entry, lateUs > INT32_MAX ? INT32_MAX : (int32_t)lateUs);
+}
+
+const Log2Histogram* latenessEntry(uint8_t entry) {
+  return entry < lateness.count ? &lateness.entries[entry] : nullptr;
+}
+
+uint32_t latenessMisses(uint8_t entry) {
+  return entry < lateness.count ? lateness.misses[entry] : 0;
+}
+
+// ,"name":[misses,[...]] - appended only if it fits with room for the closing "}}"
+static size_t appendEntry(char* out, size_t used, size_t size, uint8_t entry) {
+  int prefix = snprintf(out + used, size - used, "%s\"%s\":[%lu,", out[used - 1] == '{' ? "" : ",",
+                        lateness.names[entry], (unsigned long)lateness.misses[entry]);
+  if (prefix < 0 || used + prefix + 4 > size) {
+    out[used] = '\0';
+    return used;
+  }
+
+  size_t length = histFormat(lateness.entries[entry], out + used + prefix, size - used - prefix - 3);
+  if (length == 0) {
+    out[used] = '\0';
+    return used;
+  }
+  used += prefix + length;
+  out[used++] = ']';
+  out[used] = '\0';
+  return used;
+}
+
+size_t latenessFormat(char* out, size_t size) {
+  int64_t now = nowUs();
+  int header = snprintf(out, size, "{\"win_s\":%lu,\"miss_us\":%lu,\"entries\":{",
+                        (unsigned long)((now - lateness.windowStartUs) / 1000000),
+                        (unsigned long)lateness.missUs);
+  if (header < 0 || (size_t)header + 3 > size) {
+    if (size > 0) out[0] = '\0';
+    return 0;
+  }
+
+  size_t used = header;
+  for (uint8_t entry = 0; entry < lateness.count; entry++) {
+    if (lateness.entries[entry].count == 0) continue;
+    used = appendEntry(out, used, size, entry);
+  }
+  out[used++] = '}';
+  out[used++] = '}';
+  out[used] = '\0';
+
+  // New window
+  for (uint8_t entry = 0; entry < lateness.count; entry++) {
+    histReset(lateness.entries[entry]);
+    lateness.misses[entry] = 0;
+  }
+  lateness.windowStartUs = now;
+  return used;
+}
@@ -0,0 +1,39 @@
+#ifndef SCHEDULE_LATENESS_H
+#define SCHEDULE_LATENESS_H
+
+// Schedule accuracy of timed outputs (effect toggles, auto-off, motor ramp
+// steps): each event records how late the output was written against the
+// time it was due, in microseconds, into a log2 histogram per named entry
+// (effect group, motor...). Events later than the miss threshold are also
+// counted as deadline misses. latenessFormat() renders the window as compact
+// JSON for devices/<id>/timing and starts a new window.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "metrics_histogram.h"
+
+#define LATENESS_MAX_ENTRIES 8
+#define LATENESS_PAYLOAD_MAX 1024   // Fits the firmware's MQTT packet buffer
+
+// entryNames must outlive the tracker; count <= LATENESS_MAX_ENTRIES
+void latenessBegin(const char* const* entryNames, uint8_t count, uint32_t missThresholdUs);
+
+// Output written now, it was due at dueMs on the millis() timeline. The whole
+// milliseconds are taken wrap-safe from 32-bit millis, the sub-millisecond
+// part from the microsecond timer.
+void latenessRecordMs(uint8_t entry, uint32_t dueMs);
+
+// Lateness already known (negative = early, recorded as 0)
+void latenessRecord(uint8_t entry, int32_t latenessUs);
+
+// {"win_s":60,"miss_us":N,"entries":{"<name>":[misses,[n,p99,max,first,[...]]],...}}
+// entries without events and entries that do not fit are left out.
+// Resets the window, returns the length.
+size_t latenessFormat(char* out, size_t size);
+
+// Read-only view for tests / serial diagnostics
+const Log2Histogram* latenessEntry(uint8_t entry);
+uint32_t latenessMisses(uint8_t entry);
+
+#endif
@@ -0,0 +1,268 @@
+#include "system_stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#define SYSSTATS_CORES portNUM_PROCESSORS
+#else
+#define SYSSTATS_CORES 2
+#endif
+
+#define WARN_STACK 0x01
+#define WARN_CPU   0x02
+
+#define HEAP_WARN_FREE 0x01
+#define HEAP_WARN_FRAG 0x02
+
+struct TaskTrack {
+  uint32_t id;
+  uint32_t runTime;
+  uint8_t warned;
+};
+
+// Previous sample - run-time baseline and raised warnings per task
+static TaskTrack tracks[SYSSTATS_MAX_TASKS];
+static uint8_t trackCount = 0;
+static bool tracksHaveRunTime = false;
+static uint8_t heapWarned = 0;
+
+static TaskTrack* findTrack(uint32_t id) {
+  for (uint8_t i = 0; i < trackCount; i++) {
+    if (tracks[i].id == id) return &tracks[i];
+  }
+  return nullptr;
+}
+
+void systemStatsUpdate(const TaskSample* tasks, uint8_t count, bool haveRunTime,
+                       const HeapSample& heap, SystemStats* out) {
+  if (count > SYSSTATS_MAX_TASKS) count = SYSSTATS_MAX_TASKS;
+
+  out->heap = heap;
+  out->fragmentation = heap.freeBytes > 0 && heap.largestBlock <= heap.freeBytes
+                           ? (uint8_t)(100 - (uint64_t)heap.largestBlock * 100 / heap.freeBytes)
+                           : 0;
+  out->taskCount = count;
+
+  // Run time of all tasks together = SYSSTATS_CORES cores' worth of time
+  uint64_t deltas[SYSSTATS_MAX_TASKS];
+  bool known[SYSSTATS_MAX_TASKS];
+  uint64_t total = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskTrack* previous = findTrack(tasks[i].id);
+    known[i] = haveRunTime && tracksHaveRunTime && previous != nullptr;
+    deltas[i] = known[i] ? (uint32_t)(tasks[i].runTime - previous->runTime) : 0;
+    total += deltas[i];
+  }
+
+  TaskTrack next[SYSSTATS_MAX_TASKS];
+  for (uint8_t i = 0; i < count; i++) {
+    TaskStats& task = out->tasks[i];
+    task.id = tasks[i].id;
+    memcpy(task.name, tasks[i].name, sizeof(task.name));
+    task.name[sizeof(task.name) - 1] = '\0';
+    task.stackFree = tasks[i].stackFree;
+
+    if (known[i] && total > 0) {
+      uint64_t tenths = deltas[i] * 1000 * SYSSTATS_CORES / total;
+      task.cpuTenths = (int16_t)(tenths > 1000 ? 1000 : tenths);
+    } else {
+      task.cpuTenths = SYSSTATS_CPU_UNKNOWN;
+    }
+
+    const TaskTrack* previous = findTrack(tasks[i].id);
+    next[i].id = tasks[i].id;
+    next[i].runTime = tasks[i].runTime;
+    next[i].warned = previous != nullptr ? previous->warned : 0;
+  }
+
+  memcpy(tracks, next, sizeof(TaskTrack) * count);
+  trackCount = count;
+  tracksHaveRunTime = haveRunTime;
+}
+
+size_t systemStatsFormat(const SystemStats& stats, char* out, size_t size) {
+  int used = snprintf(out, size, "{\"heap\":[%lu,%lu,%lu,%u],\"tasks\":{",
+                      (unsigned long)stats.heap.freeBytes, (unsigned long)stats.heap.minFreeBytes,
+                      (unsigned long)stats.heap.largestBlock, (unsigned)stats.fragmentation);
+  if (used < 0 || (size_t)used + 3 > size) {
+    if (size > 0) out[0] = '\0';
+    return 0;
+  }
+
+  bool first = true;
+  for (uint8_t i = 0; i < stats.taskCount; i++) {
+    const TaskStats& task = stats.tasks[i];
+    char cpu[12];
+    if (task.cpuTenths == SYSSTATS_CPU_UNKNOWN) {
+      strcpy(cpu, "null");
+    } else {
+      snprintf(cpu, sizeof(cpu), "%d.%d", task.cpuTenths / 10, task.cpuTenths % 10);
+    }
+
+    // Keeps room for the closing "}}"
+    int written = snprintf(out + used, size - used - 2, "%s\"%s\":[%s,%lu]", first ? "" : ",",
+                           task.name, cpu, (unsigned long)task.stackFree);
+    if (written < 0 || (size_t)(used + written) >= size - 2) {
+      out[used] = '\0';
+      continue;
+    }
+    used += written;
+    first = false;
+  }
+
+  out[used++] = '}';
+  out[used++] = '}';
+  out[used] = '\0';
+  return used;
+}
+
+static bool publishWarning(DiagPublish warn, const char* kind, const char* task,
+                           uint32_t value, uint32_t limit) {
+  char payload[96];
+  if (task != nullptr) {
+    snprintf(payload, sizeof(payload), "{\"warn\":\"%s\",\"task\":\"%s\",\"value\":%lu,\"limit\":%lu}",
+             kind, task, (unsigned long)value, (unsigned long)limit);
+  } else {
+    snprintf(payload, sizeof(payload), "{\"warn\":\"%s\",\"value\":%lu,\"limit\":%lu}", kind,
+             (unsigned long)value, (unsigned long)limit);
+  }
+  return warn != nullptr && warn(payload);
+}
+
+// Edge trigger: publish when the condition starts, re-arm when it ends
+static uint8_t edge(uint8_t& flags, uint8_t bit, bool active) {
+  if (!active) {
+    flags &= ~bit;
+    return 0;
+  }
+  if (flags & bit) return 0;
+  flags |= bit;
+  return 1;
+}
+
+uint8_t systemStatsCheck(const SystemStats& stats, const SystemThresholds& limits, DiagPublish warn) {
+  uint8_t raised = 0;
+
+  if (edge(heapWarned, HEAP_WARN_FREE,
+           limits.minFreeHeap > 0 && stats.heap.freeBytes < limits.minFreeHeap)) {
+    publishWarning(warn, "heap_free", nullptr, stats.heap.freeBytes, limits.minFreeHeap);
+    raised++;
+  }
+  if (edge(heapWarned, HEAP_WARN_FRAG,
+           limits.maxFragmentation > 0 && stats.fragmentation > limits.maxFragmentation)) {
+    publishWarning(warn, "heap_frag", nullptr, stats.fragmentation, limits.maxFragmentation);
+    raised++;
+  }
+
+  for (uint8_t i = 0; i < stats.taskCount; i++) {
+    const TaskStats& task = stats.tasks[i];
+    TaskTrack* track = findTrack(task.id);
+    if (track == nullptr) continue;
+
+    if (edge(track->warned, WARN_STACK, limits.minStackFree > 0 && task.stackFree < limits.minStackFree)) {
+      publishWarning(warn, "stack", task.name, task.stackFree, limits.minStackFree);
+      raised++;
+    }
+
+    // IDLE near 100 % is the healthy case; a busy core shows up as busy tasks
+    bool idle = strncmp(task.name, "IDLE", 4) == 0;
+    bool busy = !idle && limits.maxTaskCpu > 0 && task.cpuTenths != SYSSTATS_CPU_UNKNOWN &&
+                task.cpuTenths > limits.maxTaskCpu * 10;
+    if (edge(track->warned, WARN_CPU, busy)) {
+      publishWarning(warn, "cpu", task.name, task.cpuTenths / 10, limits.maxTaskCpu);
+      raised++;
+    }
+  }
+  return raised;
+}
+
+#ifdef ARDUINO
+
+#if configUSE_TRACE_FACILITY == 1
+static TaskStatus_t taskStatus[SYSSTATS_MAX_TASKS];
+#endif
+
+bool systemStatsSample(SystemStats* out) {
+  static TaskSample samples[SYSSTATS_MAX_TASKS];
+  uint8_t count = 0;
+  bool haveRunTime = false;
+
+#if configUSE_TRACE_FACILITY == 1
+  // uxTaskGetSystemState() returns nothing if the array is smaller than the task list
+  if (uxTaskGetNumberOfTasks() <= SYSSTATS_MAX_TASKS) {
+    count = (uint8_t)uxTaskGetSystemState(taskStatus, SYSSTATS_MAX_TASKS, nullptr);
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    samples[i].id = taskStatus[i].xTaskNumber;
+    strncpy(samples[i].name, taskStatus[i].pcTaskName, SYSSTATS_NAME_LEN - 1);
+    samples[i].name[SYSSTATS_NAME_LEN - 1] = '\0';
+#if configGENERATE_RUN_TIME_STATS == 1
+    samples[i].runTime = (uint32_t)taskStatus[i].ulRunTimeCounter;
+#else
+    samples[i].runTime = 0;
+#endif
+    // StackType_t is one byte on the ESP32 - the high-water mark is in bytes
+    samples[i].stackFree = taskStatus[i].usStackHighWaterMark;
+  }
+#if configGENERATE_RUN_TIME_STATS == 1
+  haveRunTime = count > 0;
+#endif
+#endif
+
+  HeapSample heap;
+  heap.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  heap.minFreeBytes = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  heap.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+  systemStatsUpdate(samples, count, haveRunTime, heap, out);
+  return count > 0;
+}
+
+static SystemThresholds diagLimits = {};
+static uint32_t diagCheckMs = 0;
+static uint32_t diagReportMs = 0;
+static bool diagRequested = false;
+
+void systemDiagBegin(const SystemThresholds& limits, uint32_t checkMs, uint32_t reportMs) {
+  diagLimits = limits;
+  diagCheckMs = checkMs;
+  diagReportMs = reportMs;
+
+  // Baseline for the first CPU window
+  static SystemStats stats;
+  systemStatsSample(&stats);
+}
+
+void systemDiagRequest() {
+  diagRequested = true;
+}
+
+void systemDiagLoop(DiagPublish report, DiagPublish warn) {
+  static uint32_t lastCheck = 0;
+  static uint32_t lastReport = 0;
+  static SystemStats stats;   // ~1 kB, kept off the loop stack
+  static char payload[1024];
+
+  uint32_t now = millis();
+  bool reportDue = diagReportMs > 0 && now - lastReport >= diagReportMs;
+  bool checkDue = diagCheckMs > 0 && now - lastCheck >= diagCheckMs;
+  if (!diagRequested && !reportDue && !checkDue) return;
+
+  systemStatsSample(&stats);
+  lastCheck = now;
+  systemStatsCheck(stats, diagLimits, warn);
+
+  // A failed publish is not retried - the next report comes a full interval later
+  if (diagRequested || reportDue) {
+    if (systemStatsFormat(stats, payload, sizeof(payload)) > 0) report(payload);
+    lastReport = now;
+    diagRequested = false;
+  }
+}
+
+#endif
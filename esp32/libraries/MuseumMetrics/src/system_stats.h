@@ -0,0 +1,82 @@
+#ifndef SYSTEM_STATS_H
+#define SYSTEM_STATS_H
+
+// System-wide runtime statistics: CPU % per FreeRTOS task (Wi-Fi / LwIP
+// included), stack high-water marks and heap state (free, minimum ever,
+// largest free block, fragmentation).
+//
+// The engine (systemStatsUpdate / Format / Check) works on plain samples
+// and is built on the host; systemStatsSample() and the systemDiag* driver
+// read FreeRTOS and heap_caps on the device.
+//
+// CPU % is the share of one core since the previous sample, so IDLE0 and
+// IDLE1 near 100 mean both cores are mostly free. It needs
+// configGENERATE_RUN_TIME_STATS; without it the field is null.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SYSSTATS_MAX_TASKS 32
+#define SYSSTATS_NAME_LEN  16
+#define SYSSTATS_CPU_UNKNOWN (-1)
+
+struct TaskSample {
+  uint32_t id;                    // FreeRTOS task number, stable for the task's lifetime
+  char name[SYSSTATS_NAME_LEN];
+  uint32_t runTime;               // Run-time counter, wraps
+  uint32_t stackFree;             // High-water mark: least free stack ever, bytes
+};
+
+struct HeapSample {
+  uint32_t freeBytes;
+  uint32_t minFreeBytes;          // Lowest free heap since boot
+  uint32_t largestBlock;          // Largest allocatable block
+};
+
+struct TaskStats {
+  uint32_t id;
+  char name[SYSSTATS_NAME_LEN];
+  int16_t cpuTenths;              // 0.1 % of one core, SYSSTATS_CPU_UNKNOWN on the first sample
+  uint32_t stackFree;
+};
+
+struct SystemStats {
+  HeapSample heap;
+  uint8_t fragmentation;          // 100 - largest block / free, %
+  uint8_t taskCount;
+  TaskStats tasks[SYSSTATS_MAX_TASKS];
+};
+
+struct SystemThresholds {
+  uint32_t minFreeHeap;           // bytes, 0 = no check
+  uint8_t maxFragmentation;       // %, 0 = no check
+  uint32_t minStackFree;          // bytes per task, 0 = no check
+  uint8_t maxTaskCpu;             // % of a core for any non-IDLE task, 0 = no check
+};
+
+// Engine: CPU % from the run-time deltas against the previous call
+void systemStatsUpdate(const TaskSample* tasks, uint8_t count, bool haveRunTime,
+                       const HeapSample& heap, SystemStats* out);
+
+// {"heap":[free,min,largest,frag],"tasks":{"loopTask":[cpu,stack],...}}, cpu in % or null.
+// Tasks that do not fit are left out. Returns the length.
+size_t systemStatsFormat(const SystemStats& stats, char* out, size_t size);
+
+// Publishes {"warn":"<kind>",["task":"<name>",]"value":N,"limit":N} once when a
+// threshold is crossed; it re-arms after the value is back in range.
+// kind = heap_free | heap_frag | stack | cpu. Returns the number of new warnings.
+typedef bool (*DiagPublish)(const char* payload);
+uint8_t systemStatsCheck(const SystemStats& stats, const SystemThresholds& limits, DiagPublish warn);
+
+#ifdef ARDUINO
+// Reads every task and the 8-bit capable heap
+bool systemStatsSample(SystemStats* out);
+
+// Samples every checkMs and checks the thresholds, publishes a full report
+// every reportMs (0 = only on request) and after systemDiagRequest().
+void systemDiagBegin(const SystemThresholds& limits, uint32_t checkMs, uint32_t reportMs);
+void systemDiagRequest();
+void systemDiagLoop(DiagPublish report, DiagPublish warn);
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+import sys
+from pathlib import Path
+from types import SimpleNamespace
+
+# Ensure raspberry_pi/ is importable when tests are executed from repository root.
+RPI_DIR = Path(__file__).resolve().parents[1]
+if str(RPI_DIR) not in sys.path:
+    sys.path.insert(0, str(RPI_DIR))
+
+from utils.mqtt.mqtt_message_handler import MQTTMessageHandler
+
+
+class _LoggerStub:
+    def __init__(self):
+        self.infos = []
+
+    def info(self, message, *args, **kwargs):
+        self.infos.append(message)
+
+    def __getattr__(self, _name):
+        return lambda *args, **kwargs: None
+
+
+def _handler():
+    logger = _LoggerStub()
+    handler = MQTTMessageHandler(logger=logger, room_id="room1")
+    calls = []
+    handler.set_handlers(button_callback=lambda: calls.append(True))
+    return handler, logger, calls
+
+
+def _msg(payload):
+    return SimpleNamespace(topic="room1/scene", payload=payload.encode("utf-8"), retain=False)
+
+
+def test_plain_start_triggers_scene():
+    handler, _, calls = _handler()
+    handler.handle_message(_msg("START"))
+
+    assert calls == [True]
+
+
+def test_timestamped_start_triggers_scene_and_logs_latency():
+    handler, logger, calls = _handler()
+    handler.handle_message(_msg("START@1760612345678"))
+
+    assert calls == [True]
+    assert any("press-to-backend" in line for line in logger.infos)
+
+
+def test_other_payload_is_not_a_button_command():
+    handler, _, calls = _handler()
+    handler.handle_message(_msg("STARTED"))
+
+    assert calls == []
+    assert MQTTMessageHandler._button_press_time_ms("START@abc") is None
+
+
+def test_sequenced_trigger_is_acked_and_retransmission_ignored():
+    handler, _, calls = _handler()
+    acks = []
+    handler.set_ack_publisher(lambda topic, payload: acks.append((topic, payload)))
+
+    handler.handle_message(_msg("START@1760612345678#42"))
+    handler.handle_message(_msg("START@1760612345678#42"))
+    handler.handle_message(_msg("START#43"))
+
+    assert calls == [True, True]
+    assert acks == [
+        ("room1/scene/ack", "ACK:42"),
+        ("room1/scene/ack", "ACK:42"),
+        ("room1/scene/ack", "ACK:43"),
+    ]
+    assert MQTTMessageHandler._button_press_time_ms("START#43") is None
+    assert MQTTMessageHandler._button_press_time_ms("START@1760612345678#42") == 1760612345678
+
+
+def test_own_ack_is_not_routed_to_scene_parser():
+    handler, _, _ = _handler()
+    events = []
+    handler.scene_parser = SimpleNamespace(register_mqtt_event=lambda t, p: events.append(t))
+    handler.handle_message(SimpleNamespace(topic="room1/scene/ack", payload=b"ACK:42", retain=False))
+
+    assert events == []
+
+
+def test_sequenced_trigger_on_other_topic_is_acked_and_routed_without_seq():
+    handler, _, calls = _handler()
+    acks = []
+    events = []
+    handler.set_ack_publisher(lambda topic, payload: acks.append((topic, payload)))
+    handler.scene_parser = SimpleNamespace(register_mqtt_event=lambda t, p: events.append((t, p)))
+
+    station = SimpleNamespace(topic="room1/station1", payload=b"NEXT@1760612345678#7", retain=False)
+    handler.handle_message(station)
+    handler.handle_message(station)
+    handler.handle_message(_msg("START#7"))
+
+    assert events == [("room1/station1", "NEXT@1760612345678")]
+    assert calls == [True]
+    assert acks == [
+        ("room1/station1/ack", "ACK:7"),
+        ("room1/station1/ack", "ACK:7"),
+        ("room1/scene/ack", "ACK:7"),
+    ]
@@ -0,0 +1,86 @@
+import sys
+from pathlib import Path
+from types import SimpleNamespace
+
+# Ensure raspberry_pi/ is importable when tests are executed from repository root.
+RPI_DIR = Path(__file__).resolve().parents[1]
+if str(RPI_DIR) not in sys.path:
+    sys.path.insert(0, str(RPI_DIR))
+
+from utils.mqtt.mqtt_message_handler import MQTTMessageHandler
+from utils.mqtt.topic_rules import MQTTRoomTopics
+
+
+RECORD = (
+    '{"boot":42,"reason":"task_wdt","build":"1a2b3c4d","stage":"effects","stage_at_ms":3280347,'
+    '"resets":{"panic":0,"int_wdt":0,"task_wdt":1,"wdt":0,"brownout":0},'
+    '"cmds":[[3279950,"effects/group1 ON"],[3280012,"light/4 OFF"]],'
+    '"core":{"task":"loopTask","pc":"0x400d2f1c","bt":["0x400d2f1c"],"corrupted":false}}'
+)
+
+
+class _LoggerStub:
+    def __init__(self):
+        self.infos = []
+        self.warnings = []
+
+    def info(self, message, *args, **kwargs):
+        self.infos.append(message)
+
+    def warning(self, message, *args, **kwargs):
+        self.warnings.append(message)
+
+    def __getattr__(self, _name):
+        return lambda *args, **kwargs: None
+
+
+def _handler():
+    logger = _LoggerStub()
+    handler = MQTTMessageHandler(logger=logger, room_id="room1")
+    events = []
+    parser = SimpleNamespace(register_mqtt_event=lambda topic, payload: events.append(topic))
+    handler.set_handlers(scene_parser=parser)
+    return handler, logger, events
+
+
+def _msg(payload, retain=False):
+    return SimpleNamespace(
+        topic="devices/Room1_Relays_Ctrl/crash", payload=payload.encode("utf-8"), retain=retain
+    )
+
+
+def test_crash_topic_is_subscribed():
+    assert "devices/+/crash" in MQTTRoomTopics("room1").subscriptions()
+
+
+def test_live_crash_record_is_logged_as_warning():
+    handler, logger, events = _handler()
+    handler.handle_message(_msg(RECORD))
+
+    assert events == []
+    assert len(logger.warnings) == 1
+    line = logger.warnings[0]
+    assert "Room1_Relays_Ctrl" in line
+    assert "task_wdt" in line
+    assert "stage effects" in line
+    assert "'light/4 OFF'" in line
+    assert "0x400d2f1c" in line
+
+
+def test_retained_crash_record_is_logged_as_info():
+    handler, logger, _ = _handler()
+    handler.handle_message(_msg('{"boot":3,"reason":"brownout","build":"00000000","stage":null,"cmds":[]}', True))
+
+    assert logger.warnings == []
+    assert any("brownout" in line and "stage none" in line and "retained" in line for line in logger.infos)
+
+
+def test_cleared_or_broken_record():
+    handler, logger, events = _handler()
+    handler.handle_message(_msg("", True))
+    assert logger.warnings == [] and logger.infos == []
+
+    handler.handle_message(_msg("{not json"))
+    assert len(logger.warnings) == 1
+    assert "unreadable" in logger.warnings[0]
+    assert events == []
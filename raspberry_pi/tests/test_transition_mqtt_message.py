@@ -0,0 +1,43 @@
+import sys
+from pathlib import Path
+
+# Ensure raspberry_pi/ is importable when tests are executed from repository root.
+RPI_DIR = Path(__file__).resolve().parents[1]
+if str(RPI_DIR) not in sys.path:
+    sys.path.insert(0, str(RPI_DIR))
+
+from utils.transition_manager import TransitionManager
+
+
+class _LoggerStub:
+    def __getattr__(self, _name):
+        return lambda *args, **kwargs: None
+
+
+def _transition(message):
+    return {"type": "mqttMessage", "topic": "room1/motor1/state", "message": message, "goto": "next"}
+
+
+def test_exact_message_matches():
+    manager = TransitionManager(logger=_LoggerStub())
+    manager.register_mqtt_event("room1/motor1/state", "AT_SPEED")
+
+    assert manager._check_mqtt_message(_transition("AT_SPEED"), 0) == "next"
+    assert len(manager.mqtt_events) == 0
+
+
+def test_timestamp_suffix_matches_bare_message():
+    manager = TransitionManager(logger=_LoggerStub())
+    manager.register_mqtt_event("room1/motor1/state", "AT_SPEED@123456")
+
+    assert manager._check_mqtt_message(_transition("AT_SPEED"), 0) == "next"
+    assert len(manager.mqtt_events) == 0
+
+
+def test_prefix_without_separator_does_not_match():
+    manager = TransitionManager(logger=_LoggerStub())
+    manager.register_mqtt_event("room1/motor1/state", "AT_SPEEDX")
+    manager.register_mqtt_event("room1/motor1/state", "STOPPED@10")
+
+    assert manager._check_mqtt_message(_transition("AT_SPEED"), 0) is None
+    assert len(manager.mqtt_events) == 2
@@ -4,13 +4,21 @@ MQTT Message Handler - Routes incoming messages to appropriate handlers.
 
 Receives all incoming MQTT messages and routes them to the correct handlers:
 - Device status messages → device registry
+- Device crash records → log
 - Feedback messages → feedback tracker
 - Button commands → scene execution
 - MQTT transitions → scene parser (for interactive scenes)
 """
 
+import json
+import time
+
 from utils.logging_setup import get_logger
-from utils.mqtt.topic_rules import MQTTTopicRules, MQTTRoomTopics
+from utils.mqtt.topic_rules import ACK_SUFFIX, MQTTTopicRules, MQTTRoomTopics
+
+# A button retransmits an unacknowledged trigger for at most its outbox max age
+# (30 s); sequence numbers seen within this window are duplicates.
+BUTTON_DEDUP_WINDOW_S = 120
 
 
 class MQTTMessageHandler:
@@ -38,6 +46,10 @@ class MQTTMessageHandler:
         self.button_callback = None
         self.scene_parser = None
         self.named_scene_callback = None  # New handler for named scene start commands
+        self.ack_publisher = None
+
+        # (topic, button trigger sequence number) -> monotonic time it was first seen
+        self._seen_button_seqs = {}
 
     # ==========================================================================
     # HANDLER CONFIGURATION
@@ -63,6 +75,15 @@ class MQTTMessageHandler:
         self.named_scene_callback = named_scene_callback  # New assignment
         self.logger.debug("Message handlers configured")
 
+    def set_ack_publisher(self, publisher):
+        """
+        Set the publish function used to acknowledge button triggers.
+
+        Args:
+            publisher: Callable (topic, payload) -> bool, normally MQTTClient.publish.
+        """
+        self.ack_publisher = publisher
+
     # ==========================================================================
     # MESSAGE PROCESSING
     # ==========================================================================
@@ -91,18 +112,38 @@ class MQTTMessageHandler:
                 )
                 return
 
+            # 1b. Crash record of an ESP32 that reset after a panic / watchdog (devices/esp32_xx/crash)
+            if MQTTTopicRules.is_device_crash_parts(topic_parts):
+                self._log_device_crash(topic_parts[1], payload, msg.retain)
+                return
+
             # 2. Handle per-command feedback messages (prefix/motor1/feedback)
             if self.feedback_tracker and self._is_command_feedback_message(topic):
                 self.feedback_tracker.handle_feedback_message(topic, payload)
                 return
 
-            # 3. Handle button commands (prefix/scene = START) -> starts the default scene
+            # Our own trigger acks come back through the room wildcard subscription
+            if MQTTTopicRules.is_ack_topic(topic):
+                return
+
+            # 3. Sequenced button triggers (<payload>[@<unixMs>]#<seq> on any room topic):
+            #    acknowledge, drop retransmissions, route the rest without the '#<seq>'
+            seq = self._button_seq(payload)
+            if seq is not None:
+                if not self._accept_button_trigger(topic, seq):
+                    return
+                payload = payload.rpartition('#')[0]
+                self._log_button_latency(topic, payload)
+
+            # 4. Handle button commands (prefix/scene = START[@<unixMs>]) -> starts the default scene
             if self.button_callback and self._is_button_command(topic, payload):
+                if seq is None:
+                    self._log_button_latency(topic, payload)
                 self.logger.info("Button command received. Starting default scene.")
                 self.button_callback()
                 return
 
-            # 4. Handle named scene start command (prefix/start_scene = scene_name.json)
+            # 5. Handle named scene start command (prefix/start_scene = scene_name.json)
             if self.named_scene_callback and self._is_named_scene_command(topic):
                 scene_name = payload.strip()
                 if scene_name:
@@ -118,7 +159,7 @@ class MQTTMessageHandler:
                     )
                     return
 
-            # 5. Route all other MQTT messages to scene parser for transitions
+            # 6. Route all other MQTT messages to scene parser for transitions
             if self.scene_parser:
                 self.scene_parser.register_mqtt_event(topic, payload)
                 self.logger.debug(
@@ -126,7 +167,7 @@ class MQTTMessageHandler:
                 )
                 return
 
-            # 6. Log any messages that do not match known patterns
+            # 7. Log any messages that do not match known patterns
             self.logger.debug(
                 f"Received unhandled message on topic {msg.topic}: {payload}"
             )
@@ -134,6 +175,89 @@ class MQTTMessageHandler:
         except Exception as e:
             self.logger.error(f"Error processing message on {msg.topic}: {e}")
 
+    def _accept_button_trigger(self, topic, seq):
+        """
+        Acknowledge a sequenced button trigger and filter out retransmissions.
+
+        Every trigger carrying '#<seq>' is acknowledged with 'ACK:<seq>' on
+        '<topic>/ack', including duplicates, since the earlier ack may have been
+        lost. A button can drive several topics, so duplicates are detected per
+        (topic, seq) pair.
+
+        Args:
+            topic: The room topic the trigger arrived on.
+            seq: The outbox sequence number of the trigger.
+
+        Returns:
+            bool: True if the trigger should be processed, False for a duplicate.
+        """
+        if self.ack_publisher:
+            self.ack_publisher(f"{topic}{ACK_SUFFIX}", f"ACK:{seq}")
+
+        now = time.monotonic()
+        self._seen_button_seqs = {
+            seen: stamp for seen, stamp in self._seen_button_seqs.items()
+            if now - stamp < BUTTON_DEDUP_WINDOW_S
+        }
+        key = (topic, seq)
+        if key in self._seen_button_seqs:
+            self.logger.info(f"Duplicate button trigger {topic} #{seq} re-acknowledged, ignored")
+            return False
+
+        self._seen_button_seqs[key] = now
+        return True
+
+    def _log_device_crash(self, device_id, payload, retained):
+        """
+        Log the crash record an ESP32 publishes once after an abnormal reset.
+
+        The record is retained, so a backend restart sees the last one again;
+        that copy is logged at info level. Addresses in the 'core' part are
+        decoded offline with MuseumLog's crash_decode.py and the firmware ELF.
+
+        Args:
+            device_id: Client ID from the topic.
+            payload: JSON crash record, empty when the retained record was cleared.
+            retained: True if the broker delivered a stored record.
+        """
+        if not payload:
+            return
+        try:
+            record = json.loads(payload)
+        except ValueError:
+            self.logger.warning(f"Device {device_id} sent an unreadable crash record: {payload}")
+            return
+
+        stage = record.get('stage')
+        commands = record.get('cmds') or []
+        summary = (
+            f"Device {device_id} reset by {record.get('reason')} "
+            f"(boot {record.get('boot')}, build {record.get('build')}), "
+            f"stage {stage if stage is not None else 'none'}"
+        )
+        if commands:
+            summary += f", last command '{commands[-1][1]}'"
+        if record.get('core'):
+            summary += f", pc {record['core'].get('pc')} in {record['core'].get('task')}"
+
+        if retained:
+            self.logger.info(f"{summary} (earlier crash, retained)")
+        else:
+            self.logger.warning(summary)
+
+    def _log_button_latency(self, topic, payload):
+        """
+        Log the press-to-backend latency of a timestamped button trigger.
+
+        Args:
+            topic: The room topic the trigger arrived on.
+            payload: The trigger payload without the '#<seq>' suffix.
+        """
+        press_ms = self._button_press_time_ms(payload)
+        if press_ms is not None:
+            latency_ms = int(time.time() * 1000) - press_ms
+            self.logger.info(f"Button trigger on {topic} (press-to-backend {latency_ms} ms)")
+
     # ==========================================================================
     # MESSAGE TYPE DETECTION
     # ==========================================================================
@@ -171,14 +295,48 @@ class MQTTMessageHandler:
             payload: The message payload string.
 
         Returns:
-            bool: True if the topic matches the scene topic and payload is 'START'.
+            bool: True if the topic matches the scene topic and payload is 'START',
+            optionally followed by '@<unixMs>'.
         """
         topic_matches = (
             topic == self.room_topics.scene_topic()
             if self.room_topics
             else MQTTTopicRules.is_scene_start_topic(topic)
         )
-        return topic_matches and payload.upper() == 'START'
+        command = payload.split('@', 1)[0]
+        return topic_matches and command.upper() == 'START'
+
+    @staticmethod
+    def _button_press_time_ms(payload):
+        """
+        Extract the press timestamp of a '<payload>@<unixMs>[#<seq>]' button trigger.
+
+        Args:
+            payload: The button command payload.
+
+        Returns:
+            int or None: Unix time of the press in ms, None if the payload has none.
+        """
+        _, sep, stamp = payload.partition('#')[0].partition('@')
+        if not sep or not stamp.isdigit():
+            return None
+        return int(stamp)
+
+    @staticmethod
+    def _button_seq(payload):
+        """
+        Extract the outbox sequence number of a '<payload>[@<unixMs>]#<seq>' button trigger.
+
+        Args:
+            payload: The button command payload.
+
+        Returns:
+            int or None: Sequence number, None if the payload has none.
+        """
+        _, sep, seq = payload.rpartition('#')
+        if not sep or not seq.isdigit():
+            return None
+        return int(seq)
 
     def _is_named_scene_command(self, topic):
         """
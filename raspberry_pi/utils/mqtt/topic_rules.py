@@ -8,6 +8,7 @@ while remaining easy to maintain.
 """
 
 FEEDBACK_SUFFIX = '/feedback'
+ACK_SUFFIX = '/ack'
 
 
 class MQTTRoomTopics:
@@ -31,6 +32,7 @@ class MQTTRoomTopics:
         """
         return [
             'devices/+/status',
+            'devices/+/crash',
             f'{self.room_id}/+/feedback',
             f'{self.room_id}/scene',
             f'{self.room_id}/#',
@@ -90,6 +92,25 @@ class MQTTTopicRules:
             and topic_parts[2] == 'status'
         )
 
+    @staticmethod
+    def is_device_crash_parts(topic_parts):
+        """
+        Check whether topic parts represent a device crash record.
+
+        Expected pattern: devices/<device_id>/crash
+
+        Args:
+            topic_parts: List of topic segments split by '/'.
+
+        Returns:
+            bool: True if the parts match the device crash pattern.
+        """
+        return (
+            len(topic_parts) == 3
+            and topic_parts[0] == 'devices'
+            and topic_parts[2] == 'crash'
+        )
+
     @staticmethod
     def is_scene_start_topic(topic):
         """
@@ -103,6 +124,19 @@ class MQTTTopicRules:
         """
         return topic.endswith('/scene')
 
+    @staticmethod
+    def is_ack_topic(topic):
+        """
+        Check whether a topic is the backend's own button trigger acknowledgement.
+
+        Args:
+            topic: The MQTT topic string to evaluate.
+
+        Returns:
+            bool: True if the topic ends with the ack suffix.
+        """
+        return topic.endswith(ACK_SUFFIX)
+
     @staticmethod
     def is_named_scene_start_topic(topic):
         """
@@ -133,8 +167,8 @@ class MQTTTopicRules:
         """
         parts = original_topic.split('/')
 
-        # Control commands do not expect feedback
-        if parts[-1].upper() in ['STOP', 'RESET', 'GLOBAL']:
+        # Control commands and trigger acks do not expect feedback
+        if parts[-1].upper() in ['STOP', 'RESET', 'GLOBAL', 'ACK']:
             return None
 
         # Room-scoped topics (e.g. roomX/...) expect feedback
@@ -143,6 +143,7 @@ class ServiceContainer:
             self.mqtt_feedback_tracker,
             self.mqtt_device_registry
         )
+        self.mqtt_message_handler.set_ack_publisher(self.mqtt_client.publish)
 
     def _init_system_monitor(self):
         """Initialize the system monitor and log startup information."""
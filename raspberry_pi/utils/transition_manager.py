@@ -160,7 +160,8 @@ class TransitionManager:
         Evaluate an mqttMessage transition.
 
         Fires when a matching topic/message pair is found in the event queue.
-        Removes the consumed event from the queue.
+        A payload with a device timestamp suffix ("AT_SPEED@123456") matches
+        the bare message ("AT_SPEED"). Removes the consumed event from the queue.
 
         Args:
             transition: Transition definition dict with 'topic' and 'message' keys.
@@ -174,13 +175,35 @@ class TransitionManager:
         message = transition.get("message")
 
         for event in list(self.mqtt_events):
-            if event.get("topic") == topic and event.get("message") == message:
+            if event.get("topic") == topic and self._message_matches(event.get("message"), message):
                 self.mqtt_events.remove(event)
                 return self._get_goto(
                     transition, f"MQTT triggered ({topic}={message})"
                 )
         return None
 
+    @staticmethod
+    def _message_matches(received, expected):
+        """
+        Compare an MQTT payload with the message of a transition.
+
+        Args:
+            received: Payload of the queued MQTT event.
+            expected: Message required by the transition.
+
+        Returns:
+            bool: True on exact match, or when the payload is the expected
+                message followed by an "@<timestamp>" suffix.
+        """
+        if received == expected:
+            return True
+        return (
+            isinstance(received, str)
+            and isinstance(expected, str)
+            and "@" not in expected
+            and received.startswith(expected + "@")
+        )
+
     def _check_always(self, transition, _):
         """
         Evaluate an always transition (fires immediately unconditionally).